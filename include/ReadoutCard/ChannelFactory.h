@@ -27,7 +27,8 @@ class ChannelFactory
     virtual ~ChannelFactory();
 
     /// Get an object to access a DMA channel with the given serial number and channel number.
-    /// Passing 'DUMMY_SERIAL_NUMBER' as serial number returns a dummy implementation
+    /// Passing 'DUMMY_SERIAL_NUMBER' as serial number returns a dummy implementation, passing the CRU emulator serial
+    /// number returns a CRU implementation without hardware
     /// \param parameters Parameters for the channel
     DmaChannelSharedPtr getDmaChannel(const Parameters &parameters);
 
@@ -49,6 +50,27 @@ class ChannelFactory
     {
       return -1;
     }
+
+    /// Passing this as serial number gives a CRU implementation running on a software model of the card, see
+    /// src/Cru/CruBarEmulator.h. Requires a build with PDA, but no hardware.
+    static int getCruEmulatorSerialNumber()
+    {
+      return -2;
+    }
+
+    /// Passing this as serial number gives the second endpoint of the emulated CRU, with its own emulated BARs. Use it
+    /// as the companion card ID of the CRU emulator to get a CruDualDmaChannel without hardware.
+    static int getCruEmulatorCompanionSerialNumber()
+    {
+      return -4;
+    }
+
+    /// Passing this as serial number gives a C-RORC implementation running on a software model of the card, see
+    /// src/Crorc/CrorcBarEmulator.h. Requires a build with PDA, but no hardware.
+    static int getCrorcEmulatorSerialNumber()
+    {
+      return -3;
+    }
 };
 
 } // namespace roc
@@ -0,0 +1,46 @@
+/// \file Checksum.h
+/// \brief Definition of functions for CRC32C checksums of superpages and packets.
+
+#ifndef ALICEO2_INCLUDE_READOUTCARD_CHECKSUM_H_
+#define ALICEO2_INCLUDE_READOUTCARD_CHECKSUM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ReadoutCard/CardType.h"
+#include "ReadoutCard/Superpage.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Computes the CRC32C (Castagnoli) checksum of data, as used by iSCSI, ext4 and many storage formats.
+///
+/// On x86 CPUs with SSE4.2, the crc32 instruction is used on three interleaved streams to hide its latency, which
+/// reaches memory bandwidth. Otherwise, a table-driven implementation is used, which gives the same results.
+/// \param data Data to checksum
+/// \param size Size of the data in bytes
+/// \param crc Checksum of the data that comes before, to checksum data in parts. 0 for the first part.
+/// \return The checksum of all the data so far
+uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+/// Computes the CRC32C of the received data of a superpage, and attaches it to the superpage
+/// \param superpage A superpage that was read out
+/// \param bufferAddress Userspace address of the DMA buffer the superpage's offset refers to
+/// \return The checksum
+uint32_t checksumSuperpage(Superpage& superpage, const void* bufferAddress);
+
+/// Computes the CRC32C of each packet of a superpage: its header and payload, without the padding after it
+/// \param superpage A superpage that was read out
+/// \param bufferAddress Userspace address of the DMA buffer the superpage's offset refers to
+/// \param cardType Type of the card the data came from
+/// \param dmaPageSize Size of the DMA pages. Only used for C-RORC data.
+/// \param checksums Receives the checksums in packet order, replacing its contents. Reusing the vector avoids
+///   allocations.
+/// \throw DataFormatException If the superpage holds invalid packets, see PacketRange
+void checksumPackets(const Superpage& superpage, const void* bufferAddress, CardType::type cardType,
+    size_t dmaPageSize, std::vector<uint32_t>& checksums);
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_INCLUDE_READOUTCARD_CHECKSUM_H_
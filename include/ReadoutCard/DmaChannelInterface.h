@@ -57,6 +57,15 @@ class DmaChannelInterface
     /// \param superpage Superpage to push
     virtual void pushSuperpage(Superpage superpage) = 0;
 
+    /// Adds superpage to the "transfer queue" of the given link.
+    /// Like pushSuperpage(), but lets the user decide which link fills the superpage, for example to match the
+    /// superpage size to the link's data rate (see Parameters::setLinkSuperpageSizeMap()).
+    /// Backends without per-link queues ignore the link and behave like pushSuperpage().
+    ///
+    /// \param linkId ID of the link that will fill the superpage
+    /// \param superpage Superpage to push
+    virtual void pushLinkSuperpage(uint32_t linkId, Superpage superpage) = 0;
+
     /// Gets the superpage at the front of the "ready queue". Does not pop it.
     /// Note that it returns a copy of the Superpage's values.
     virtual Superpage getSuperpage() = 0;
@@ -68,8 +77,18 @@ class DmaChannelInterface
     virtual void fillSuperpages() = 0;
 
     /// Gets the amount of superpages that can still be pushed into the "transfer queue" using pushSuperpage()
+    /// With per-link superpage sizes (see Parameters::setLinkSuperpageSizeMap()), not every slot takes every size, so
+    /// use getTransferQueueAvailableForSize() to know if a superpage of a given size can be pushed.
     virtual int getTransferQueueAvailable() = 0;
 
+    /// Gets the amount of superpages of the given size that can still be pushed using pushSuperpage()
+    /// Backends without per-link superpage sizes return the same as getTransferQueueAvailable().
+    virtual int getTransferQueueAvailableForSize(size_t superpageSize) = 0;
+
+    /// Gets the amount of superpages that can still be pushed to the given link using pushLinkSuperpage()
+    /// Backends without per-link queues return the same as getTransferQueueAvailable().
+    virtual int getLinkTransferQueueAvailable(uint32_t linkId) = 0;
+
     /// Gets the amount of superpages currently in the "ready queue". If there is more than one available, the front
     /// superpage can be inspected with getSuperpage() or popped with popSuperpage().
     virtual int getReadyQueueSize() = 0;
@@ -117,6 +136,23 @@ class DmaChannelInterface
     /// Gets card unique ID, such as an FPGA chip ID in the case of the CRU
     /// \return A string containing the unique ID
     virtual boost::optional<std::string> getCardId() = 0;
+
+    /// Starts feeding superpages to the given link while DMA keeps running on the other links.
+    /// Must be called from the thread that calls pushSuperpage() and fillSuperpages().
+    /// Currently, only the CRU backend supports this
+    /// \param linkId ID of the link to enable
+    /// \return True if the link is enabled, false if the backend does not support it
+    virtual bool enableLink(uint32_t linkId) = 0;
+
+    /// Stops feeding superpages to the given link while DMA keeps running on the other links.
+    /// No new superpages are pushed to the link. Superpages already given to the link stay in flight and move to the
+    /// "ready queue" as the card completes them, after which the link is removed. Any that are still in flight at
+    /// stopDma() are returned like those of other links.
+    /// Must be called from the thread that calls pushSuperpage() and fillSuperpages().
+    /// Currently, only the CRU backend supports this
+    /// \param linkId ID of the link to disable
+    /// \return True if the link is being drained or was removed, false if the backend does not support it
+    virtual bool disableLink(uint32_t linkId) = 0;
 };
 
 } // namespace roc
@@ -34,6 +34,7 @@ struct UnsafeAccess : virtual Exception {};
 struct UnsafeReadAccess : virtual UnsafeAccess {};
 struct UnsafeWriteAccess : virtual UnsafeAccess {};
 struct InvalidLinkId : virtual Exception {};
+struct DataFormatException : virtual Exception {};
 
 // C-RORC exception definitions
 struct CrorcException : virtual Exception {};
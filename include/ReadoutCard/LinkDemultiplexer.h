@@ -0,0 +1,88 @@
+/// \file LinkDemultiplexer.h
+/// \brief Definition of the LinkDemultiplexer class.
+
+#ifndef ALICEO2_INCLUDE_READOUTCARD_LINKDEMULTIPLEXER_H_
+#define ALICEO2_INCLUDE_READOUTCARD_LINKDEMULTIPLEXER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ReadoutCard/CardType.h"
+#include "ReadoutCard/PacketRange.h"
+#include "ReadoutCard/Superpage.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Splits the packets of superpages by link ID, so the data of each link can be processed as one stream.
+///
+/// Each superpage is scanned once, building a list of packets per link. In zero-copy mode, these lists are the result:
+/// the packets keep pointing into the DMA buffer. Otherwise, the payloads of each link are also appended to an output
+/// buffer given by the user, using non-temporal stores when the CPU supports AVX2, so the copies do not push the data
+/// that is still to be processed out of the caches.
+///
+/// C-RORC data has no link ID, so all its packets go to link 0.
+class LinkDemultiplexer
+{
+  public:
+    /// Highest link ID plus one. The RDH link ID field is 8 bits wide.
+    static constexpr uint32_t MAX_LINKS = 256;
+
+    /// \param cardType Type of the card the data comes from, which determines the data format
+    /// \param dmaPageSize Size of the DMA pages. Only used for C-RORC data.
+    LinkDemultiplexer(CardType::type cardType, size_t dmaPageSize);
+
+    /// Gives a link an output buffer to append its payloads to. Links without an output buffer are only indexed.
+    /// \param linkId Link ID
+    /// \param buffer Address of the buffer. Aligning it to 32 bytes makes the copies faster.
+    /// \param capacity Size of the buffer in bytes
+    void setOutput(uint32_t linkId, char* buffer, size_t capacity);
+
+    /// Gets the amount of bytes appended to the output buffer of a link
+    size_t getOutputSize(uint32_t linkId) const;
+
+    /// Empties the output buffers, so they are filled from the start again
+    void clearOutputs();
+
+    /// Scans a superpage and lists its packets per link, without copying anything. The lists replace those of the
+    /// previous superpage.
+    /// \param superpage A superpage that was read out
+    /// \param bufferAddress Userspace address of the DMA buffer the superpage's offset refers to
+    /// \throw DataFormatException If the superpage holds invalid packets, see PacketRange
+    void index(const Superpage& superpage, const void* bufferAddress);
+
+    /// Scans a superpage like index(), then appends the payloads of each link to its output buffer.
+    /// If an output buffer does not have room for all the payloads of its link, an OutOfRangeException is thrown and
+    /// nothing is copied.
+    void copy(const Superpage& superpage, const void* bufferAddress);
+
+    /// Gets the packets of a link found in the last superpage, in order of arrival
+    const std::vector<Packet>& getPackets(uint32_t linkId) const;
+
+    /// Gets the IDs of the links that had packets in the last superpage, in increasing order
+    const std::vector<uint32_t>& getActiveLinks() const
+    {
+      return mActiveLinks;
+    }
+
+  private:
+    struct Output
+    {
+        char* buffer = nullptr;
+        size_t capacity = 0;
+        size_t size = 0;
+    };
+
+    void checkLinkId(uint32_t linkId) const;
+
+    const CardType::type mCardType;
+    const size_t mDmaPageSize;
+    std::vector<std::vector<Packet>> mPackets;
+    std::vector<uint32_t> mActiveLinks;
+    std::vector<Output> mOutputs;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_INCLUDE_READOUTCARD_LINKDEMULTIPLEXER_H_
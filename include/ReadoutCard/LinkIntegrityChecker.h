@@ -0,0 +1,154 @@
+/// \file LinkIntegrityChecker.h
+/// \brief Definition of the LinkIntegrityChecker class.
+
+#ifndef ALICEO2_INCLUDE_READOUTCARD_LINKINTEGRITYCHECKER_H_
+#define ALICEO2_INCLUDE_READOUTCARD_LINKINTEGRITYCHECKER_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <boost/optional.hpp>
+#include "ReadoutCard/CardType.h"
+#include "ReadoutCard/PacketRange.h"
+#include "ReadoutCard/Superpage.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Counts of the packets of a link and the integrity errors found in them
+struct LinkIntegrityCounters
+{
+    /// Number of packets checked
+    uint64_t packets = 0;
+    /// Number of times the packet counter skipped ahead
+    uint64_t gaps = 0;
+    /// Number of packets lost in the gaps, as far as the 8-bit packet counter can tell
+    uint64_t missingPackets = 0;
+    /// Number of packets with the same packet counter as the previous packet
+    uint64_t duplicates = 0;
+    /// Number of packets with a payload that is not a whole number of 128-bit data words
+    uint64_t sizeMismatches = 0;
+    /// Number of packets with an unsupported RDH version, an unexpected header size, or a link ID that differs from the
+    /// other packets of their superpage
+    uint64_t rdhAnomalies = 0;
+    /// Number of packets with a payload that does not continue the data generator pattern
+    uint64_t payloadErrors = 0;
+
+    /// Gets the number of packets with an error
+    uint64_t getErrors() const
+    {
+      return gaps + duplicates + sizeMismatches + rdhAnomalies + payloadErrors;
+    }
+
+    LinkIntegrityCounters& operator+=(const LinkIntegrityCounters& other)
+    {
+      packets += other.packets;
+      gaps += other.gaps;
+      missingPackets += other.missingPackets;
+      duplicates += other.duplicates;
+      sizeMismatches += other.sizeMismatches;
+      rdhAnomalies += other.rdhAnomalies;
+      payloadErrors += other.payloadErrors;
+      return *this;
+    }
+};
+
+/// Checks the continuity of the packets of each link of CRU-format data, for monitoring during readout.
+///
+/// Each link's RDH packet counter must increase by one from packet to packet. Optionally, the payloads are checked
+/// against the CRU's DDG pattern (which the dummy data generator emulates): the data counter must continue where the
+/// previous packet of the link left off. After an error, the link is resynchronized to the packet that had it, so one
+/// lost packet is counted once.
+///
+/// The checker keeps no locks and does no allocation while checking. Only one thread may check the packets of a link,
+/// but different links may be checked by different threads, and the counters can be read by any thread at any time.
+class LinkIntegrityChecker
+{
+  public:
+    /// Number of link IDs the checker tracks, the RDH link ID field is 8 bits wide
+    static constexpr size_t LINK_IDS = 256;
+
+    /// \param cardType Type of the card the data comes from: CRU or dummy
+    /// \param checkPayload If true, also check the payloads against the DDG pattern. This reads all of the data, so it
+    ///   costs more than checking the headers alone.
+    LinkIntegrityChecker(CardType::type cardType, bool checkPayload = false);
+
+    /// Checks the packets of a superpage
+    /// \param superpage A superpage that was read out
+    /// \param bufferAddress Userspace address of the DMA buffer the superpage's offset refers to
+    /// \return True if an error was found. A superpage that can't be walked counts as malformed, and the packets after
+    ///   the invalid one are not checked.
+    bool check(const Superpage& superpage, const void* bufferAddress);
+
+    /// Checks a packet, which must be the next packet of its link
+    /// \return True if an error was found
+    bool check(const Packet& packet);
+
+    /// Gets the counters of a link
+    /// \throw OutOfRangeException If the link ID is out of range
+    LinkIntegrityCounters getCounters(uint32_t linkId) const;
+
+    /// Gets the counters of all links added up
+    LinkIntegrityCounters getCounters() const;
+
+    /// Gets the packet counter of the last packet of a link, which the next packet must follow. Empty at the start and
+    /// after resynchronize(). Only for the thread checking the link.
+    /// \throw OutOfRangeException If the link ID is out of range
+    boost::optional<uint32_t> getLastPacketCounter(uint32_t linkId) const;
+
+    /// Gets the data counter the next payload of a link must start with. Empty if payloads are not checked, at the
+    /// start, and after an error, when it's taken from the next payload. Only for the thread checking the link.
+    /// \throw OutOfRangeException If the link ID is out of range
+    boost::optional<uint32_t> getExpectedDataCounter(uint32_t linkId) const;
+
+    /// Gets the number of superpages that could not be walked, see PacketRange
+    uint64_t getMalformedSuperpages() const
+    {
+      return mMalformedSuperpages.load(std::memory_order_relaxed);
+    }
+
+    /// Forgets the last packet of every link, so the next packets are taken as they come. Use this after readout was
+    /// stopped and started again. The counters are kept. Not safe while packets are being checked.
+    void resynchronize();
+
+  private:
+    enum Counter
+    {
+      Packets,
+      Gaps,
+      MissingPackets,
+      Duplicates,
+      SizeMismatches,
+      RdhAnomalies,
+      PayloadErrors,
+      COUNTERS
+    };
+
+    struct Link
+    {
+        /// Packet counter of the last packet, if hasPacketCounter is set
+        uint32_t packetCounter = 0;
+        /// Data counter expected at the start of the next payload, if hasDataCounter is set
+        uint32_t dataCounter = 0;
+        bool hasPacketCounter = false;
+        bool hasDataCounter = false;
+        /// Only written by the thread checking the link, so they don't need atomic read-modify-writes
+        std::array<std::atomic<uint64_t>, COUNTERS> counters;
+    };
+
+    bool checkPacket(const Packet& packet, int superpageLinkId);
+    bool checkPayload(Link& link, const Packet& packet);
+    static void add(Link& link, Counter counter, uint64_t amount = 1);
+    const Link& getLink(uint32_t linkId) const;
+
+    const bool mCheckPayload;
+    std::vector<Link> mLinks;
+    std::atomic<uint64_t> mMalformedSuperpages {0};
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_INCLUDE_READOUTCARD_LINKINTEGRITYCHECKER_H_
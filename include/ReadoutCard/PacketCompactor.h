@@ -0,0 +1,102 @@
+/// \file PacketCompactor.h
+/// \brief Definition of the PacketCompactor class.
+
+#ifndef ALICEO2_INCLUDE_READOUTCARD_PACKETCOMPACTOR_H_
+#define ALICEO2_INCLUDE_READOUTCARD_PACKETCOMPACTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ReadoutCard/CardType.h"
+#include "ReadoutCard/Superpage.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Amount of data before and after compaction
+struct CompactionStatistics
+{
+    /// Number of packets scanned
+    uint64_t packets = 0;
+    /// Number of packets without payload that were removed
+    uint64_t removedPackets = 0;
+    /// Number of bytes scanned: the received size of the superpages
+    uint64_t bytesIn = 0;
+    /// Number of bytes after compaction
+    uint64_t bytesOut = 0;
+
+    /// Gets the size after compaction as a fraction of the size before. Lower is better.
+    double getRatio() const
+    {
+      return bytesIn == 0 ? 1.0 : double(bytesOut) / double(bytesIn);
+    }
+
+    CompactionStatistics& operator+=(const CompactionStatistics& other)
+    {
+      packets += other.packets;
+      removedPackets += other.removedPackets;
+      bytesIn += other.bytesIn;
+      bytesOut += other.bytesOut;
+      return *this;
+    }
+};
+
+/// Removes packets without payload from superpages of CRU-format data, and packs the remaining packets together.
+///
+/// With triggered or low-occupancy readout, most packets are only an RDH, but each still takes up a whole DMA page.
+/// After compaction, the packets follow each other directly: their RDH offset to next packet is their memory size,
+/// rounded up to 32 bytes so the headers stay aligned. The compacted superpage can be walked with PacketRange as before.
+///
+/// Empty packets carry the heartbeat orbits, which are needed to build time frames. So by default, an empty packet is
+/// only removed if an earlier packet of its link in the same heartbeat orbit was kept, which merges the empty packets
+/// of each orbit into one. This is tracked across superpages.
+class PacketCompactor
+{
+  public:
+    /// \param cardType Type of the card the data comes from: CRU or dummy
+    /// \param keepHeartbeats If true, keep one empty packet per link and heartbeat orbit. If false, remove all of them.
+    PacketCompactor(CardType::type cardType, bool keepHeartbeats = true);
+
+    /// Compacts a superpage in place, and sets its received size to the compacted size
+    /// \param superpage A superpage that was read out
+    /// \param bufferAddress Userspace address of the DMA buffer the superpage's offset refers to
+    /// \return Statistics of this superpage
+    /// \throw DataFormatException If the superpage holds invalid packets, see PacketRange. The packets before the
+    ///   invalid one may already have been moved.
+    CompactionStatistics compact(Superpage& superpage, void* bufferAddress);
+
+    /// Writes a compacted copy of a superpage, leaving the original untouched
+    /// \param superpage A superpage that was read out
+    /// \param bufferAddress Userspace address of the DMA buffer the superpage's offset refers to
+    /// \param destination Buffer to write the compacted packets to
+    /// \param capacity Size of the destination buffer. The compacted size is at most the received size of the superpage.
+    /// \return Statistics of this superpage. The compacted size is in bytesOut.
+    /// \throw OutOfRangeException If the compacted packets do not fit in the destination
+    CompactionStatistics compactCopy(const Superpage& superpage, const void* bufferAddress, char* destination,
+        size_t capacity);
+
+    /// Gets the statistics of all superpages compacted so far
+    const CompactionStatistics& getStatistics() const
+    {
+      return mStatistics;
+    }
+
+  private:
+    /// Compacts a superpage into the destination, which may be the superpage itself
+    CompactionStatistics compactTo(const Superpage& superpage, const void* bufferAddress, char* destination,
+        size_t capacity);
+
+    const CardType::type mCardType;
+    const bool mKeepHeartbeats;
+
+    /// Heartbeat orbit of the last packet kept per link. Only valid if the corresponding mHasOrbit is set.
+    std::vector<uint32_t> mLastOrbit;
+    std::vector<bool> mHasOrbit;
+
+    CompactionStatistics mStatistics;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_INCLUDE_READOUTCARD_PACKETCOMPACTOR_H_
@@ -0,0 +1,124 @@
+/// \file PacketIndex.h
+/// \brief Definition of the PacketIndex and PacketIndexPool classes.
+
+#ifndef ALICEO2_INCLUDE_READOUTCARD_PACKETINDEX_H_
+#define ALICEO2_INCLUDE_READOUTCARD_PACKETINDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ReadoutCard/CardType.h"
+#include "ReadoutCard/PacketRange.h"
+#include "ReadoutCard/Superpage.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Table of the packets in a superpage, so consumers can go straight to a packet instead of walking the headers again.
+class PacketIndex
+{
+  public:
+    /// Location of a packet, relative to the start of its superpage
+    struct Entry
+    {
+        uint32_t offset;
+        uint32_t payloadSize;
+        uint16_t headerSize;
+        /// Link ID from the RDH. Always 0 for C-RORC data.
+        uint16_t linkId;
+    };
+
+    /// Walks a superpage and fills the table with its packets, replacing the previous contents
+    /// \param superpage A superpage that was read out
+    /// \param bufferAddress Userspace address of the DMA buffer the superpage's offset refers to
+    /// \param cardType Type of the card the data came from
+    /// \param dmaPageSize Size of the DMA pages. Only used for C-RORC data.
+    /// \throw DataFormatException If the superpage holds invalid packets, see PacketRange
+    void build(const Superpage& superpage, const void* bufferAddress, CardType::type cardType, size_t dmaPageSize);
+
+    size_t size() const
+    {
+      return mEntries.size();
+    }
+
+    bool empty() const
+    {
+      return mEntries.empty();
+    }
+
+    const Entry& operator[](size_t i) const
+    {
+      return mEntries[i];
+    }
+
+    std::vector<Entry>::const_iterator begin() const
+    {
+      return mEntries.begin();
+    }
+
+    std::vector<Entry>::const_iterator end() const
+    {
+      return mEntries.end();
+    }
+
+    /// Gets a packet of the table
+    /// \param i Index of the packet
+    /// \param superpageData Userspace address of the start of the superpage
+    Packet getPacket(size_t i, const void* superpageData) const
+    {
+      const auto& entry = mEntries[i];
+      Packet packet;
+      packet.header = reinterpret_cast<const char*>(superpageData) + entry.offset;
+      packet.payload = packet.header + entry.headerSize;
+      packet.payloadSize = entry.payloadSize;
+      return packet;
+    }
+
+  private:
+    std::vector<Entry> mEntries;
+};
+
+/// Fixed set of reusable packet indexes, which are attached to superpages as they are read out.
+///
+/// The index is built once when the superpage is taken from the DmaChannel, and consumers that are given a copy of the
+/// Superpage can find its index with Superpage::getPacketIndex(). When all of them are done, release() returns the index
+/// to the pool before the superpage is pushed again. Since indexes are reused, their tables are not reallocated once
+/// they have grown to the number of packets per superpage.
+class PacketIndexPool
+{
+  public:
+    /// \param cardType Type of the card the data comes from
+    /// \param dmaPageSize Size of the DMA pages. Only used for C-RORC data.
+    /// \param capacity Number of indexes, which should be the number of superpages that can be in use at the same time
+    PacketIndexPool(CardType::type cardType, size_t dmaPageSize, size_t capacity);
+
+    /// Builds an index for a superpage, and attaches it to the superpage
+    /// \param superpage A superpage that was read out, which has no index attached yet
+    /// \param bufferAddress Userspace address of the DMA buffer the superpage's offset refers to
+    /// \return The index, which stays valid until it is released
+    /// \throw OutOfRangeException If all indexes are in use
+    /// \throw DataFormatException If the superpage holds invalid packets. No index is attached then.
+    const PacketIndex& attach(Superpage& superpage, const void* bufferAddress);
+
+    /// Returns the index of a superpage to the pool, and detaches it from the superpage
+    /// \throw Exception If the superpage has no index attached, or one from another pool
+    void release(Superpage& superpage);
+
+    /// Gets the number of indexes that are not attached to a superpage
+    size_t getAvailable() const
+    {
+      return mAvailable.size();
+    }
+
+  private:
+    const CardType::type mCardType;
+    const size_t mDmaPageSize;
+    std::vector<std::unique_ptr<PacketIndex>> mIndexes;
+    std::vector<PacketIndex*> mAvailable;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_INCLUDE_READOUTCARD_PACKETINDEX_H_
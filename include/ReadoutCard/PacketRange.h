@@ -0,0 +1,134 @@
+/// \file PacketRange.h
+/// \brief Definition of the PacketRange class.
+
+#ifndef ALICEO2_INCLUDE_READOUTCARD_PACKETRANGE_H_
+#define ALICEO2_INCLUDE_READOUTCARD_PACKETRANGE_H_
+
+#include <cstddef>
+#include <iterator>
+#include "ReadoutCard/CardType.h"
+#include "ReadoutCard/Rdh.h"
+#include "ReadoutCard/Superpage.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Size of the header at the start of each C-RORC DMA page in bytes
+constexpr size_t SDH_SIZE = 32;
+
+/// A packet in a superpage. It points into the DMA buffer, nothing is copied.
+struct Packet
+{
+    /// Address of the header: an RDH for CRU-format data, an SDH for C-RORC data
+    const char* header = nullptr;
+
+    /// Address of the payload, which follows the header
+    const char* payload = nullptr;
+
+    /// Size of the payload in bytes
+    size_t payloadSize = 0;
+
+    /// Gets a view of the RDH. Only meaningful for CRU-format data.
+    RdhView getRdh() const
+    {
+      return RdhView(header);
+    }
+};
+
+/// Range over the packets of a received superpage, for use in range-based for loops.
+///
+/// CRU-format data (from the CRU or the dummy card) is walked with the offset-to-next field of the RDHs, so pages
+/// of any size are handled. C-RORC data has one event per DMA page, with its size in the SDH.
+///
+/// The headers are checked while walking: a DataFormatException is thrown when a packet does not fit in the received
+/// part of the superpage, or its header sizes are inconsistent.
+class PacketRange
+{
+  public:
+    class Iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Packet;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Packet*;
+        using reference = const Packet&;
+
+        reference operator*() const
+        {
+          return mPacket;
+        }
+
+        pointer operator->() const
+        {
+          return &mPacket;
+        }
+
+        Iterator& operator++()
+        {
+          mOffset = mNext;
+          load();
+          return *this;
+        }
+
+        Iterator operator++(int)
+        {
+          auto previous = *this;
+          ++(*this);
+          return previous;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+          return mOffset == other.mOffset;
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+          return mOffset != other.mOffset;
+        }
+
+      private:
+        friend class PacketRange;
+
+        Iterator(const PacketRange* range, size_t offset) : mRange(range), mOffset(offset), mNext(offset)
+        {
+          load();
+        }
+
+        /// Checks and decodes the header at the current offset, and finds the offset of the next packet
+        void load();
+
+        const PacketRange* mRange;
+        size_t mOffset;
+        size_t mNext;
+        Packet mPacket;
+    };
+
+    /// \param superpage A superpage that was read out
+    /// \param bufferAddress Userspace address of the DMA buffer the superpage's offset refers to
+    /// \param cardType Type of the card the data came from, which determines the data format
+    /// \param dmaPageSize Size of the DMA pages. Only used for C-RORC data.
+    PacketRange(const Superpage& superpage, const void* bufferAddress, CardType::type cardType, size_t dmaPageSize);
+
+    Iterator begin() const
+    {
+      return Iterator(this, 0);
+    }
+
+    Iterator end() const
+    {
+      return Iterator(this, mReceived);
+    }
+
+  private:
+    const char* mData;
+    size_t mReceived;
+    bool mSdhFormat;
+    size_t mDmaPageSize;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_INCLUDE_READOUTCARD_PACKETRANGE_H_
@@ -0,0 +1,39 @@
+/// \file GeneratorFault.h
+/// \brief Definition of the GeneratorFault enum and supporting functions.
+
+#ifndef ALICEO2_INCLUDE_READOUTCARD_GENERATORFAULT_H_
+#define ALICEO2_INCLUDE_READOUTCARD_GENERATORFAULT_H_
+
+#include <string>
+
+namespace AliceO2 {
+namespace roc {
+
+/// Namespace for the enum describing the faults the dummy data generator can inject
+struct GeneratorFault
+{
+  enum type
+  {
+    /// A DMA page is not written, but the counters advance as if it was
+    DropPage = 0,
+    /// A bit of the memory size or packet counter field of the RDH is flipped
+    CorruptRdh = 1,
+    /// The packet counter skips a value
+    SkipPacketCounter = 2,
+    /// The link stops sending data for a while
+    StallLink = 3,
+    /// A completed superpage is lost from the ready queue, and its buffer is filled again
+    ReadyQueueOverflow = 4,
+  };
+
+  /// Converts a GeneratorFault to a string
+  static auto toString(const GeneratorFault::type& type) -> std::string;
+
+  /// Converts a string to a GeneratorFault
+  static auto fromString(const std::string& string) -> GeneratorFault::type;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_INCLUDE_READOUTCARD_GENERATORFAULT_H_
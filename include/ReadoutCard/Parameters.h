@@ -6,6 +6,7 @@
 #ifndef ALICEO2_INCLUDE_READOUTCARD_PARAMETERS_H_
 #define ALICEO2_INCLUDE_READOUTCARD_PARAMETERS_H_
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <set>
@@ -13,6 +14,7 @@
 #include <boost/optional.hpp>
 #include <boost/variant.hpp>
 #include "ReadoutCard/ParameterTypes/BufferParameters.h"
+#include "ReadoutCard/ParameterTypes/GeneratorFault.h"
 #include "ReadoutCard/ParameterTypes/GeneratorPattern.h"
 #include "ReadoutCard/ParameterTypes/LoopbackMode.h"
 #include "ReadoutCard/ParameterTypes/PciAddress.h"
@@ -92,6 +94,36 @@ class Parameters
     using GbtMuxType = GbtMux::type;
     using GbtModeType = GbtMode::type;
 
+    /// Type for the CompanionCardId parameter. It can hold either a serial number or PciAddress.
+    using CompanionCardIdType = CardIdType;
+
+    /// Type for the link superpage size map parameter. Maps link IDs to superpage sizes in bytes.
+    using LinkSuperpageSizeMapType = std::map<uint32_t, size_t>;
+
+    /// Type for the warm start enabled parameter
+    using WarmStartEnabledType = bool;
+
+    /// Type for the DMA stop timeout parameter
+    using DmaStopTimeoutType = std::chrono::milliseconds;
+
+    /// Type for the generator rate parameter, in bytes per second
+    using GeneratorRateType = size_t;
+
+    /// Type for the generator link rate map parameter. Maps link IDs to rates in bytes per second.
+    using GeneratorLinkRateMapType = std::map<uint32_t, size_t>;
+
+    /// Type for the generator fault map parameter. Maps faults to their probabilities.
+    using GeneratorFaultMapType = std::map<GeneratorFault::type, double>;
+
+    /// Type for the generator stall time parameter
+    using GeneratorStallTimeType = std::chrono::milliseconds;
+
+    /// Type for the replay file parameter, the path of a DMA capture
+    using ReplayFileType = std::string;
+
+    /// Type for the replay pacing enabled parameter
+    using ReplayPacingEnabledType = bool;
+
 
     // Setters
 
@@ -139,6 +171,9 @@ class Parameters
     /// The format and content of this data is controlled by the other generator parameters.
     /// 'None' loopback mode is not allowed in conjunction with the data generator (see setGeneratorLoopback()).
     ///
+    /// The dummy driver only writes data into superpages when this parameter is explicitly set to true and a memory or
+    /// file buffer is given. It then produces CRU-format pages, see setGeneratorRate() for limiting its rate.
+    ///
     /// \param value The value to set
     /// \return Reference to this object for chaining calls
     auto setGeneratorEnabled(GeneratorEnabledType value) -> Parameters&;
@@ -291,6 +326,134 @@ class Parameters
     /// \return Reference to this object for chaining calls 
     auto setGbtMuxMap(GbtMuxMapType value) -> Parameters&;
 
+    /// Sets the CompanionCardId parameter
+    ///
+    /// A CRU presents itself as two PCI endpoints, each with its own DMA channel. When this parameter is set, the
+    /// ChannelFactory opens the endpoint given by the CardId together with the endpoint given here, and returns one
+    /// channel that drives both from the same fillSuperpages() loop, transfer queue and ready queue.
+    /// The same buffer (see setBufferParameters()) is registered with both endpoints, so superpage offsets are shared.
+    ///
+    /// Since both endpoints of a CRU report the same serial number, a PciAddress is the most reliable way to identify
+    /// the companion endpoint.
+    ///
+    /// Only supported by the CRU.
+    ///
+    /// \param value The value to set
+    /// \return Reference to this object for chaining calls
+    auto setCompanionCardId(CompanionCardIdType value) -> Parameters&;
+
+    /// Sets the LinkSuperpageSizeMap parameter
+    ///
+    /// Restricts links to superpages of one size. A link listed in the map only accepts superpages of the mapped
+    /// size, so fast links can be given large superpages and slow links small ones. Links that are not listed accept
+    /// superpages of any size.
+    /// DmaChannelInterface::pushSuperpage() puts a superpage on a link that accepts its size, while
+    /// DmaChannelInterface::pushLinkSuperpage() can be used to target a link directly.
+    ///
+    /// Sizes must be multiples of 32 KiB.
+    ///
+    /// Only supported by the CRU.
+    ///
+    /// \param value The value to set
+    /// \return Reference to this object for chaining calls
+    auto setLinkSuperpageSizeMap(LinkSuperpageSizeMapType value) -> Parameters&;
+
+    /// Sets the WarmStartEnabled parameter
+    ///
+    /// If enabled, DmaChannelInterface::startDma() skips the card reset when the previous run ended cleanly, i.e. the
+    /// card held no unfilled superpages when the DMA was stopped. The driver then resumes from the card's superpage
+    /// counters instead of resetting them, which shortens the transition between runs.
+    /// The first start of a channel, and any start after an unclean stop, still does a full reset.
+    ///
+    /// Only supported by the CRU. If not set, the driver will always reset the card on start.
+    ///
+    /// \param value The value to set
+    /// \return Reference to this object for chaining calls
+    auto setWarmStartEnabled(WarmStartEnabledType value) -> Parameters&;
+
+    /// Sets the DmaStopTimeout parameter
+    ///
+    /// If set, DmaChannelInterface::stopDma() keeps the DMA running for up to the given time, so superpages that are
+    /// in flight can complete. Completed superpages are returned ready and with their received size set. Superpages
+    /// the card did not complete in time are returned with ready == false and a received size of 0, so they can be
+    /// told apart from data.
+    ///
+    /// If not set, the DMA is stopped immediately and the superpage that was being filled on each link is returned as
+    /// if it were complete.
+    ///
+    /// Only supported by the CRU.
+    ///
+    /// \param value The value to set
+    /// \return Reference to this object for chaining calls
+    auto setDmaStopTimeout(DmaStopTimeoutType value) -> Parameters&;
+
+    /// Sets the GeneratorRate parameter
+    ///
+    /// Limits the rate at which the data generator produces data on each link, in bytes per second.
+    /// 0 means unlimited.
+    ///
+    /// Only supported by the dummy driver, see setGeneratorEnabled(), and by the emulated C-RORC, see
+    /// ChannelFactory::getCrorcEmulatorSerialNumber(). If not set, the rate is unlimited.
+    ///
+    /// \param value The value to set
+    /// \return Reference to this object for chaining calls
+    auto setGeneratorRate(GeneratorRateType value) -> Parameters&;
+
+    /// Sets the GeneratorLinkRateMap parameter
+    ///
+    /// Overrides the GeneratorRate for individual links, in bytes per second. 0 means unlimited.
+    ///
+    /// Only supported by the dummy driver.
+    ///
+    /// \param value The value to set
+    /// \return Reference to this object for chaining calls
+    auto setGeneratorLinkRateMap(GeneratorLinkRateMapType value) -> Parameters&;
+
+    /// Sets the GeneratorFaultMap parameter
+    ///
+    /// Makes the data generator inject faults, to test how a readout detects and recovers from them. Maps each fault
+    /// to its probability between 0 and 1: per DMA page for most faults, per superpage for
+    /// GeneratorFault::ReadyQueueOverflow. See GeneratorFault for the faults.
+    ///
+    /// Only supported by the dummy driver. If not set, no faults are injected.
+    ///
+    /// \param value The value to set
+    /// \return Reference to this object for chaining calls
+    auto setGeneratorFaultMap(GeneratorFaultMapType value) -> Parameters&;
+
+    /// Sets the GeneratorStallTime parameter
+    ///
+    /// How long a link stops sending data when a GeneratorFault::StallLink fault is injected.
+    ///
+    /// Only supported by the dummy driver. If not set, the default of 10 ms is used.
+    ///
+    /// \param value The value to set
+    /// \return Reference to this object for chaining calls
+    auto setGeneratorStallTime(GeneratorStallTimeType value) -> Parameters&;
+
+    /// Sets the ReplayFile parameter
+    ///
+    /// Makes the channel replay a DMA capture, as written by `roc-bench-dma --record`, instead of generating data.
+    /// Each superpage is filled with the next superpage of the capture, and the capture starts over when it ends.
+    /// Takes precedence over the GeneratorEnabled parameter.
+    ///
+    /// Only supported by the dummy driver.
+    ///
+    /// \param value The value to set
+    /// \return Reference to this object for chaining calls
+    auto setReplayFile(ReplayFileType value) -> Parameters&;
+
+    /// Sets the ReplayPacingEnabled parameter
+    ///
+    /// If enabled, superpages of a replayed capture arrive with the same spacing in time as when they were recorded.
+    /// Otherwise, they arrive as fast as they are pushed.
+    ///
+    /// Only supported by the dummy driver. If not set, the default of true is used.
+    ///
+    /// \param value The value to set
+    /// \return Reference to this object for chaining calls
+    auto setReplayPacingEnabled(ReplayPacingEnabledType value) -> Parameters&;
+
 
     // on-throwing getters
 
@@ -362,6 +525,46 @@ class Parameters
     /// \return The value
     auto getGbtMuxMap() const -> boost::optional<GbtMuxMapType>;
 
+    /// Gets the CompanionCardId parameter
+    /// \return The value wrapped in an optional if it is present, or an empty optional if it was not
+    auto getCompanionCardId() const -> boost::optional<CompanionCardIdType>;
+
+    /// Gets the LinkSuperpageSizeMap parameter
+    /// \return The value wrapped in an optional if it is present, or an empty optional if it was not
+    auto getLinkSuperpageSizeMap() const -> boost::optional<LinkSuperpageSizeMapType>;
+
+    /// Gets the WarmStartEnabled parameter
+    /// \return The value wrapped in an optional if it is present, or an empty optional if it was not
+    auto getWarmStartEnabled() const -> boost::optional<WarmStartEnabledType>;
+
+    /// Gets the DmaStopTimeout parameter
+    /// \return The value wrapped in an optional if it is present, or an empty optional if it was not
+    auto getDmaStopTimeout() const -> boost::optional<DmaStopTimeoutType>;
+
+    /// Gets the GeneratorRate parameter
+    /// \return The value wrapped in an optional if it is present, or an empty optional if it was not
+    auto getGeneratorRate() const -> boost::optional<GeneratorRateType>;
+
+    /// Gets the GeneratorLinkRateMap parameter
+    /// \return The value wrapped in an optional if it is present, or an empty optional if it was not
+    auto getGeneratorLinkRateMap() const -> boost::optional<GeneratorLinkRateMapType>;
+
+    /// Gets the GeneratorFaultMap parameter
+    /// \return The value wrapped in an optional if it is present, or an empty optional if it was not
+    auto getGeneratorFaultMap() const -> boost::optional<GeneratorFaultMapType>;
+
+    /// Gets the GeneratorStallTime parameter
+    /// \return The value wrapped in an optional if it is present, or an empty optional if it was not
+    auto getGeneratorStallTime() const -> boost::optional<GeneratorStallTimeType>;
+
+    /// Gets the ReplayFile parameter
+    /// \return The value wrapped in an optional if it is present, or an empty optional if it was not
+    auto getReplayFile() const -> boost::optional<ReplayFileType>;
+
+    /// Gets the ReplayPacingEnabled parameter
+    /// \return The value wrapped in an optional if it is present, or an empty optional if it was not
+    auto getReplayPacingEnabled() const -> boost::optional<ReplayPacingEnabledType>;
+
     // Throwing getters
 
     /// Gets the CardId parameter
@@ -449,6 +652,56 @@ class Parameters
     /// \return The value
     auto getGbtMuxMapRequired() const -> GbtMuxMapType;
 
+    /// Gets the CompanionCardId parameter
+    /// \exception ParameterException The parameter was not present
+    /// \return The value
+    auto getCompanionCardIdRequired() const -> CompanionCardIdType;
+
+    /// Gets the LinkSuperpageSizeMap parameter
+    /// \exception ParameterException The parameter was not present
+    /// \return The value
+    auto getLinkSuperpageSizeMapRequired() const -> LinkSuperpageSizeMapType;
+
+    /// Gets the WarmStartEnabled parameter
+    /// \exception ParameterException The parameter was not present
+    /// \return The value
+    auto getWarmStartEnabledRequired() const -> WarmStartEnabledType;
+
+    /// Gets the DmaStopTimeout parameter
+    /// \exception ParameterException The parameter was not present
+    /// \return The value
+    auto getDmaStopTimeoutRequired() const -> DmaStopTimeoutType;
+
+    /// Gets the GeneratorRate parameter
+    /// \exception ParameterException The parameter was not present
+    /// \return The value
+    auto getGeneratorRateRequired() const -> GeneratorRateType;
+
+    /// Gets the GeneratorLinkRateMap parameter
+    /// \exception ParameterException The parameter was not present
+    /// \return The value
+    auto getGeneratorLinkRateMapRequired() const -> GeneratorLinkRateMapType;
+
+    /// Gets the GeneratorFaultMap parameter
+    /// \exception ParameterException The parameter was not present
+    /// \return The value
+    auto getGeneratorFaultMapRequired() const -> GeneratorFaultMapType;
+
+    /// Gets the GeneratorStallTime parameter
+    /// \exception ParameterException The parameter was not present
+    /// \return The value
+    auto getGeneratorStallTimeRequired() const -> GeneratorStallTimeType;
+
+    /// Gets the ReplayFile parameter
+    /// \exception ParameterException The parameter was not present
+    /// \return The value
+    auto getReplayFileRequired() const -> ReplayFileType;
+
+    /// Gets the ReplayPacingEnabled parameter
+    /// \exception ParameterException The parameter was not present
+    /// \return The value
+    auto getReplayPacingEnabledRequired() const -> ReplayPacingEnabledType;
+
     // Helper functions
 
     /// Convenience function to make a Parameters object with card ID and channel number, since these are the most
@@ -473,6 +726,13 @@ class Parameters
     /// \throw ParameterException on PciAddress numbers out of range
     static CardIdType cardIdFromString(const std::string& string);
 
+    /// Convert a string to a GeneratorFaultMapType for the setGeneratorFaultMap() function.
+    /// Contains comma separated fault names and probabilities. For example:
+    /// * "DROP_PAGE:0.001"
+    /// * "CORRUPT_RDH:1e-4,STALL_LINK:1e-5"
+    /// \throw ParseException on failure to parse
+    static GeneratorFaultMapType generatorFaultMapFromString(const std::string& string);
+
   private:
     std::unique_ptr<ParametersPimpl> mPimpl;
 };
@@ -0,0 +1,182 @@
+/// \file Rdh.h
+/// \brief Definition of the RDH layouts and the RdhView class
+
+#ifndef ALICEO2_INCLUDE_READOUTCARD_RDH_H_
+#define ALICEO2_INCLUDE_READOUTCARD_RDH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace AliceO2 {
+namespace roc {
+
+/// Size of the RDH in bytes
+constexpr size_t RDH_SIZE = 64;
+
+/// Position of a field in the RDH, as the index of the 32-bit word holding it and the bits within that word
+struct RdhField
+{
+    uint8_t word;
+    uint8_t lsb;
+    uint8_t width;
+};
+
+/// Positions of the fields of one RDH version. Fields that a version does not have are 0 bits wide.
+struct RdhLayout
+{
+    uint32_t version;
+    RdhField headerSize;
+    RdhField feeId;
+    RdhField priority;
+    RdhField sourceId;
+    RdhField offsetToNext;
+    RdhField memorySize;
+    RdhField linkId;
+    RdhField packetCounter;
+    RdhField cruId;
+    RdhField endpointId;
+    /// Trigger orbit in version 4
+    RdhField orbit;
+    /// Trigger bunch crossing in version 4
+    RdhField bunchCrossing;
+    /// Same as the orbit from version 5 on
+    RdhField heartbeatOrbit;
+    /// Same as the bunch crossing from version 5 on
+    RdhField heartbeatBunchCrossing;
+    RdhField triggerType;
+    RdhField detectorField;
+    RdhField par;
+    RdhField stopBit;
+    RdhField pageCounter;
+};
+
+/// The version is in the same place in all versions
+constexpr RdhField RDH_VERSION_FIELD {0, 0, 8};
+
+constexpr RdhLayout RDH_LAYOUT_V4 {4,
+  {0, 8, 8}, {1, 0, 16}, {1, 16, 8}, {0, 0, 0}, {2, 0, 16}, {2, 16, 16}, {3, 0, 8}, {3, 8, 8}, {3, 16, 12},
+  {3, 28, 4}, {4, 0, 32}, {8, 0, 12}, {5, 0, 32}, {8, 16, 12}, {9, 0, 32}, {12, 0, 16}, {12, 16, 16}, {13, 0, 8},
+  {13, 8, 16}};
+
+constexpr RdhLayout RDH_LAYOUT_V5 {5,
+  {0, 8, 8}, {1, 0, 16}, {1, 16, 8}, {0, 0, 0}, {2, 0, 16}, {2, 16, 16}, {3, 0, 8}, {3, 8, 8}, {3, 16, 12},
+  {3, 28, 4}, {5, 0, 32}, {4, 0, 12}, {5, 0, 32}, {4, 0, 12}, {8, 0, 32}, {12, 0, 32}, {13, 0, 16}, {9, 16, 8},
+  {9, 0, 16}};
+
+/// Version 6 adds the source ID to version 5
+constexpr RdhLayout RDH_LAYOUT_V6 {6,
+  {0, 8, 8}, {1, 0, 16}, {1, 16, 8}, {1, 24, 8}, {2, 0, 16}, {2, 16, 16}, {3, 0, 8}, {3, 8, 8}, {3, 16, 12},
+  {3, 28, 4}, {5, 0, 32}, {4, 0, 12}, {5, 0, 32}, {4, 0, 12}, {8, 0, 32}, {12, 0, 32}, {13, 0, 16}, {9, 16, 8},
+  {9, 0, 16}};
+
+/// Gets a field from the RDH at the given address
+inline uint32_t getRdhField(const char* data, RdhField field)
+{
+  if (field.width == 0) {
+    return 0;
+  }
+  auto mask = (field.width == 32) ? ~uint32_t(0) : ~(~uint32_t(0) << field.width);
+  uint32_t word = 0;
+  std::memcpy(&word, &data[sizeof(word) * field.word], sizeof(word));
+  return (word >> field.lsb) & mask;
+}
+
+/// Sets a field of the RDH at the given address
+inline void setRdhField(char* data, RdhField field, uint32_t value)
+{
+  if (field.width == 0) {
+    return;
+  }
+  auto mask = ((field.width == 32) ? ~uint32_t(0) : ~(~uint32_t(0) << field.width)) << field.lsb;
+  uint32_t word = 0;
+  std::memcpy(&word, &data[sizeof(word) * field.word], sizeof(word));
+  word = (word & ~mask) | ((value << field.lsb) & mask);
+  std::memcpy(&data[sizeof(word) * field.word], &word, sizeof(word));
+}
+
+/// Gets the layout of the given RDH version
+/// \return The layout, or nullptr if the version is not supported
+inline const RdhLayout* getRdhLayout(uint32_t version)
+{
+  switch (version) {
+    case 4: return &RDH_LAYOUT_V4;
+    case 5: return &RDH_LAYOUT_V5;
+    case 6: return &RDH_LAYOUT_V6;
+    default: return nullptr;
+  }
+}
+
+/// Gets the version of the RDH at the given address
+inline uint32_t getRdhVersion(const char* data)
+{
+  return getRdhField(data, RDH_VERSION_FIELD);
+}
+
+/// Read-only view of the RDH at the start of a DMA page.
+/// The layout is chosen by the version in the header. Unsupported versions are read with the version 4 layout, which
+/// has the link ID, packet counter and memory size in the same place as all other versions.
+class RdhView
+{
+  public:
+    explicit RdhView(const char* data)
+      : mData(data), mLayout(getRdhLayout(getRdhVersion(data)))
+    {
+      if (mLayout == nullptr) {
+        mLayout = &RDH_LAYOUT_V4;
+        mKnownVersion = false;
+      }
+    }
+
+    /// Reads the RDH with the given layout, regardless of the version it holds
+    RdhView(const char* data, const RdhLayout& layout) : mData(data), mLayout(&layout)
+    {
+    }
+
+    /// Checks if the version of the RDH is supported
+    bool isKnownVersion() const
+    {
+      return mKnownVersion;
+    }
+
+    const RdhLayout& getLayout() const
+    {
+      return *mLayout;
+    }
+
+    uint32_t getVersion() const { return getRdhVersion(mData); }
+    uint32_t getHeaderSize() const { return get(mLayout->headerSize); }
+    uint32_t getFeeId() const { return get(mLayout->feeId); }
+    uint32_t getPriority() const { return get(mLayout->priority); }
+    uint32_t getSourceId() const { return get(mLayout->sourceId); }
+    uint32_t getOffsetToNext() const { return get(mLayout->offsetToNext); }
+    uint32_t getMemorySize() const { return get(mLayout->memorySize); }
+    uint32_t getLinkId() const { return get(mLayout->linkId); }
+    uint32_t getPacketCounter() const { return get(mLayout->packetCounter); }
+    uint32_t getCruId() const { return get(mLayout->cruId); }
+    uint32_t getEndpointId() const { return get(mLayout->endpointId); }
+    uint32_t getOrbit() const { return get(mLayout->orbit); }
+    uint32_t getBunchCrossing() const { return get(mLayout->bunchCrossing); }
+    uint32_t getHeartbeatOrbit() const { return get(mLayout->heartbeatOrbit); }
+    uint32_t getHeartbeatBunchCrossing() const { return get(mLayout->heartbeatBunchCrossing); }
+    uint32_t getTriggerType() const { return get(mLayout->triggerType); }
+    uint32_t getDetectorField() const { return get(mLayout->detectorField); }
+    uint32_t getPar() const { return get(mLayout->par); }
+    uint32_t getStopBit() const { return get(mLayout->stopBit); }
+    uint32_t getPageCounter() const { return get(mLayout->pageCounter); }
+
+  private:
+    uint32_t get(RdhField field) const
+    {
+      return getRdhField(mData, field);
+    }
+
+    const char* mData;
+    const RdhLayout* mLayout;
+    bool mKnownVersion = true;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_INCLUDE_READOUTCARD_RDH_H_
@@ -6,7 +6,14 @@
 #include "ReadoutCard/BarInterface.h"
 #include "ReadoutCard/CardType.h"
 #include "ReadoutCard/ChannelFactory.h"
+#include "ReadoutCard/Checksum.h"
 #include "ReadoutCard/DmaChannelInterface.h"
 #include "ReadoutCard/Exception.h"
+#include "ReadoutCard/LinkDemultiplexer.h"
+#include "ReadoutCard/LinkIntegrityChecker.h"
+#include "ReadoutCard/PacketCompactor.h"
+#include "ReadoutCard/PacketIndex.h"
+#include "ReadoutCard/PacketRange.h"
 #include "ReadoutCard/Parameters.h"
 #include "ReadoutCard/RegisterReadWriteInterface.h"
+#include "ReadoutCard/TimeFrameBuilder.h"
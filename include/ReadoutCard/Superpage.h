@@ -8,10 +8,13 @@
 #define ALICEO2_INCLUDE_READOUTCARD_SUPERPAGE_H_
 
 #include <cstddef>
+#include <cstdint>
 
 namespace AliceO2 {
 namespace roc {
 
+class PacketIndex;
+
 /// Simple struct for holding basic info about a superpage
 struct Superpage
 {
@@ -60,6 +63,24 @@ struct Superpage
       return mUserData;
     }
 
+    /// Get the packet index, or nullptr if none was attached. See PacketIndexPool.
+    const PacketIndex* getPacketIndex() const
+    {
+      return mPacketIndex;
+    }
+
+    /// Returns true if a checksum was attached. See checksumSuperpage().
+    bool hasChecksum() const
+    {
+      return mHasChecksum;
+    }
+
+    /// Get the CRC32C of the received data. Only valid if hasChecksum() is true.
+    uint32_t getChecksum() const
+    {
+      return mChecksum;
+    }
+
     /// Set the ready flag
     void setReady(bool ready)
     {
@@ -90,12 +111,35 @@ struct Superpage
       mUserData = userData;
     }
 
+    /// Set the packet index
+    void setPacketIndex(const PacketIndex* packetIndex)
+    {
+      mPacketIndex = packetIndex;
+    }
+
+    /// Set the CRC32C of the received data
+    void setChecksum(uint32_t checksum)
+    {
+      mChecksum = checksum;
+      mHasChecksum = true;
+    }
+
+    /// Remove the checksum, e.g. when the data it was computed over is replaced
+    void clearChecksum()
+    {
+      mChecksum = 0;
+      mHasChecksum = false;
+    }
+
   private:
     size_t mOffset = 0; ///< Offset from the start of the DMA buffer to the start of the superpage
     size_t mSize = 0; ///< Size of the superpage in bytes
     void* mUserData = nullptr; ///< Pointer that users can use for whatever, e.g. to associate data with the superpage
     size_t mReceived = 0; ///< Size of the received data in bytes
     bool mReady = false; ///< Indicates this superpage is ready
+    const PacketIndex* mPacketIndex = nullptr; ///< Table of the packets in the superpage, owned by a PacketIndexPool
+    uint32_t mChecksum = 0; ///< CRC32C of the received data
+    bool mHasChecksum = false; ///< Indicates a checksum was attached
 };
 
 } // namespace roc
@@ -0,0 +1,153 @@
+/// \file TimeFrameBuilder.h
+/// \brief Definition of the TimeFrameBuilder class.
+
+#ifndef ALICEO2_INCLUDE_READOUTCARD_TIMEFRAMEBUILDER_H_
+#define ALICEO2_INCLUDE_READOUTCARD_TIMEFRAMEBUILDER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+#include "ReadoutCard/CardType.h"
+#include "ReadoutCard/PacketRange.h"
+#include "ReadoutCard/Superpage.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Packets of all links in a range of heartbeat orbits. The packets point into the superpages they arrived in, nothing
+/// is copied.
+struct TimeFrame
+{
+    /// Sequence number of the time frame: the heartbeat orbit of its packets divided by the orbits per time frame
+    uint32_t id = 0;
+    /// False if the time frame was completed before all links had passed it, because too many were open
+    bool complete = true;
+    /// Packets per link ID, in order of arrival. Links without packets in this time frame are absent.
+    std::map<uint32_t, std::vector<Packet>> links;
+};
+
+/// Groups the packets of superpages from several links into time frames by their RDH heartbeat orbit.
+///
+/// Superpages are given to the builder in the order they were read out. Each one is scanned once, and its packets are
+/// added to the open time frame of their orbit. A time frame is complete when every expected link has sent a packet
+/// of a later time frame. Since links are read out in order, no more packets for it can arrive then.
+/// Time frames are handed out in order of ID. Packets for a time frame that is already complete are dropped.
+///
+/// The superpages stay referenced while any open or handed-out time frame has packets in them. Once the last of those
+/// time frames is popped, the superpage is released and can be given back to the DmaChannel.
+/// To bound the memory held, at most maxOpenTimeFrames time frames are open at a time: when a packet opens one more,
+/// the oldest is handed out as incomplete. A packet older than all open time frames is then dropped instead.
+///
+/// Only CRU-format data has an RDH, so C-RORC data is not supported.
+/// Orbit wrap-around is not handled; the orbit counter would take years to wrap at the LHC orbit rate.
+class TimeFrameBuilder
+{
+  public:
+    /// \param cardType Type of the card the data comes from: CRU or dummy
+    /// \param linkIds IDs of the links that contribute to every time frame
+    /// \param orbitsPerTimeFrame Number of heartbeat orbits in a time frame
+    /// \param maxOpenTimeFrames Number of time frames that can be open before the oldest is completed early
+    TimeFrameBuilder(CardType::type cardType, const std::vector<uint32_t>& linkIds, uint32_t orbitsPerTimeFrame,
+        size_t maxOpenTimeFrames = 4);
+
+    /// Scans a superpage and adds its packets to the time frames. The superpage is referenced until all time frames
+    /// with packets in it are popped. A superpage with no packets for a time frame is released right away.
+    /// \param superpage A superpage that was read out
+    /// \param bufferAddress Userspace address of the DMA buffer the superpage's offset refers to
+    /// \throw DataFormatException If the superpage holds invalid packets, see PacketRange. Packets before the invalid
+    ///   one are kept.
+    void addSuperpage(const Superpage& superpage, const void* bufferAddress);
+
+    /// Hands out all open time frames as incomplete, for example at the end of a run
+    void flush();
+
+    /// Checks if a time frame is ready
+    bool isTimeFrameAvailable() const
+    {
+      return !mReadyTimeFrames.empty();
+    }
+
+    /// Gets the oldest ready time frame. Its packets remain valid until it is popped.
+    const TimeFrame& getTimeFrame() const;
+
+    /// Removes the oldest ready time frame, releasing superpages no longer referenced by any time frame
+    void popTimeFrame();
+
+    /// Checks if a superpage was released
+    bool isSuperpageAvailable() const
+    {
+      return !mReleasedSuperpages.empty();
+    }
+
+    /// Takes a released superpage, which can be pushed to the DmaChannel again
+    Superpage popSuperpage();
+
+    /// Gets the number of time frames that are open
+    size_t getOpenTimeFrameCount() const
+    {
+      return mOpenTimeFrames.size();
+    }
+
+    /// Gets the number of superpages that are referenced by open or ready time frames
+    size_t getReferencedSuperpageCount() const
+    {
+      return mSuperpages.size();
+    }
+
+    /// Gets the number of packets dropped because their time frame was already complete, or older than all open ones
+    /// when the limit was reached
+    uint64_t getDroppedPacketCount() const
+    {
+      return mDroppedPackets;
+    }
+
+  private:
+    /// A time frame with the sequence numbers of the superpages it has packets in
+    struct PendingTimeFrame
+    {
+        TimeFrame timeFrame;
+        std::vector<uint64_t> superpages;
+    };
+
+    struct ReferencedSuperpage
+    {
+        Superpage superpage;
+        int references;
+    };
+
+    /// Hands out the open time frames that all expected links have passed
+    void closeCompleted();
+
+    /// Hands out the oldest open time frame
+    void closeOldest(bool complete);
+
+    /// Removes a reference to a superpage, releasing it when it was the last
+    void dereference(uint64_t sequenceNumber);
+
+    const CardType::type mCardType;
+    const uint32_t mOrbitsPerTimeFrame;
+    const size_t mMaxOpenTimeFrames;
+
+    /// Latest time frame ID seen per expected link. Links that have not sent anything yet are absent.
+    std::map<uint32_t, uint32_t> mLinkProgress;
+    std::vector<uint32_t> mLinkIds;
+
+    /// Time frames that can still receive packets, by ID
+    std::map<uint32_t, PendingTimeFrame> mOpenTimeFrames;
+    std::deque<PendingTimeFrame> mReadyTimeFrames;
+
+    /// Time frames with a lower ID are complete
+    uint32_t mNextTimeFrameId = 0;
+
+    std::map<uint64_t, ReferencedSuperpage> mSuperpages;
+    uint64_t mNextSequenceNumber = 0;
+    std::deque<Superpage> mReleasedSuperpages;
+    uint64_t mDroppedPackets = 0;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_INCLUDE_READOUTCARD_TIMEFRAMEBUILDER_H_
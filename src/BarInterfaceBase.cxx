@@ -11,8 +11,18 @@ namespace AliceO2 {
 namespace roc {
 
 BarInterfaceBase::BarInterfaceBase(const Parameters& parameters)
+ : BarInterfaceBase(parameters, nullptr)
+{
+}
+
+BarInterfaceBase::BarInterfaceBase(const Parameters& parameters, std::shared_ptr<Pda::PdaBar> bar)
  : mBarIndex(parameters.getChannelNumberRequired())
 {
+  if (bar) {
+    mPdaBar = std::move(bar);
+    return;
+  }
+
   auto id = parameters.getCardIdRequired();
   if (auto serial = boost::get<int>(&id)) {
     Utilities::resetSmartPtr(mRocPciDevice, *serial);
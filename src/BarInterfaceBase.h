@@ -23,6 +23,11 @@ class BarInterfaceBase: public BarInterface
 
     BarInterfaceBase(const Parameters& parameters);
     BarInterfaceBase(std::shared_ptr<Pda::PdaBar> bar);
+
+    /// \param parameters Parameters of the BAR
+    /// \param bar BAR to use instead of the one of the PCI device, e.g. an emulated one. If null, the BAR of the PCI
+    ///   device given by the parameters is used.
+    BarInterfaceBase(const Parameters& parameters, std::shared_ptr<Pda::PdaBar> bar);
     virtual ~BarInterfaceBase();
 
     virtual uint32_t readRegister(int index) override;
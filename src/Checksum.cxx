@@ -0,0 +1,175 @@
+/// \file Checksum.cxx
+/// \brief Implementation of functions for CRC32C checksums of superpages and packets.
+
+#include "ReadoutCard/Checksum.h"
+#include <cstring>
+#include "ReadoutCard/PacketRange.h"
+#include "Utilities/CpuFeatures.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ALICEO2_READOUTCARD_CHECKSUM_SSE42
+#include <nmmintrin.h>
+#endif
+
+namespace AliceO2 {
+namespace roc {
+namespace {
+/// CRC32C polynomial, bit-reversed. Bit 31 holds the coefficient of x^0.
+constexpr uint32_t POLYNOMIAL = 0x82f63b78;
+
+/// Bytes per stream in one round of the interleaved computation. Large enough that combining the streams at the end of
+/// a round is cheap, small enough that most superpages and larger packets are done with the interleaved loop.
+constexpr size_t STREAM_BLOCK = 1024;
+
+/// Multiplies two polynomials modulo the CRC32C polynomial
+uint32_t multiplyModulo(uint32_t a, uint32_t b)
+{
+  uint32_t product = 0;
+  for (uint32_t bit = uint32_t(1) << 31; bit != 0; bit >>= 1) {
+    if (a & bit) {
+      product ^= b;
+    }
+    b = (b & 1) ? ((b >> 1) ^ POLYNOMIAL) : (b >> 1);
+  }
+  return product;
+}
+
+/// Gets x^(8 * bytes) modulo the CRC32C polynomial. Multiplying a CRC register by it is the same as running that many
+/// zero bytes through it.
+uint32_t getShift(size_t bytes)
+{
+  uint32_t result = uint32_t(1) << 31; // x^0
+  uint32_t power = uint32_t(1) << 23; // x^8
+  for (; bytes != 0; bytes >>= 1) {
+    if (bytes & 1) {
+      result = multiplyModulo(power, result);
+    }
+    power = multiplyModulo(power, power);
+  }
+  return result;
+}
+
+/// Lookup tables for multiplying a CRC register by a constant, one byte of the register at a time
+using ShiftTable = uint32_t[4][256];
+
+struct Tables
+{
+    Tables()
+    {
+      for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+          crc = (crc & 1) ? ((crc >> 1) ^ POLYNOMIAL) : (crc >> 1);
+        }
+        bytes[i] = crc;
+      }
+
+      auto fill = [](ShiftTable& table, uint32_t factor) {
+        for (int byte = 0; byte < 4; ++byte) {
+          for (uint32_t i = 0; i < 256; ++i) {
+            table[byte][i] = multiplyModulo(factor, i << (8 * byte));
+          }
+        }
+      };
+      fill(shiftOne, getShift(STREAM_BLOCK));
+      fill(shiftTwo, getShift(2 * STREAM_BLOCK));
+    }
+
+    /// For the table-driven computation
+    uint32_t bytes[256];
+    /// Shifts a register over one stream block
+    ShiftTable shiftOne;
+    /// Shifts a register over two stream blocks
+    ShiftTable shiftTwo;
+};
+
+const Tables& getTables()
+{
+  static const Tables tables;
+  return tables;
+}
+
+uint32_t updateTable(uint32_t crc, const unsigned char* data, size_t size)
+{
+  const auto& bytes = getTables().bytes;
+  for (size_t i = 0; i < size; ++i) {
+    crc = bytes[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+#ifdef ALICEO2_READOUTCARD_CHECKSUM_SSE42
+inline uint32_t shift(const ShiftTable& table, uint32_t crc)
+{
+  return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^ table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+}
+
+inline uint64_t load64(const unsigned char* data)
+{
+  uint64_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+/// The crc32 instruction has a latency of three cycles, but can start one every cycle. So the data is split in three
+/// streams that are computed at the same time, and combined at the end of every round: the CRC of a concatenation is
+/// the CRC of the first part shifted over the length of the second, XORed with the CRC of the second.
+__attribute__((target("sse4.2")))
+uint32_t updateSse42(uint32_t crc, const unsigned char* data, size_t size)
+{
+  const auto& tables = getTables();
+  uint64_t a = crc;
+  while (size >= (3 * STREAM_BLOCK)) {
+    uint64_t b = 0;
+    uint64_t c = 0;
+    for (size_t i = 0; i < STREAM_BLOCK; i += sizeof(uint64_t)) {
+      a = _mm_crc32_u64(a, load64(data + i));
+      b = _mm_crc32_u64(b, load64(data + STREAM_BLOCK + i));
+      c = _mm_crc32_u64(c, load64(data + 2 * STREAM_BLOCK + i));
+    }
+    a = shift(tables.shiftTwo, uint32_t(a)) ^ shift(tables.shiftOne, uint32_t(b)) ^ c;
+    data += 3 * STREAM_BLOCK;
+    size -= 3 * STREAM_BLOCK;
+  }
+  for (; size >= sizeof(uint64_t); data += sizeof(uint64_t), size -= sizeof(uint64_t)) {
+    a = _mm_crc32_u64(a, load64(data));
+  }
+  auto result = uint32_t(a);
+  for (; size > 0; ++data, --size) {
+    result = _mm_crc32_u8(result, *data);
+  }
+  return result;
+}
+#endif
+} // Anonymous namespace
+
+uint32_t crc32c(const void* data, size_t size, uint32_t crc)
+{
+  auto bytes = reinterpret_cast<const unsigned char*>(data);
+#ifdef ALICEO2_READOUTCARD_CHECKSUM_SSE42
+  if (Utilities::isSse42Supported()) {
+    return ~updateSse42(~crc, bytes, size);
+  }
+#endif
+  return ~updateTable(~crc, bytes, size);
+}
+
+uint32_t checksumSuperpage(Superpage& superpage, const void* bufferAddress)
+{
+  auto data = reinterpret_cast<const char*>(bufferAddress) + superpage.getOffset();
+  auto checksum = crc32c(data, superpage.getReceived());
+  superpage.setChecksum(checksum);
+  return checksum;
+}
+
+void checksumPackets(const Superpage& superpage, const void* bufferAddress, CardType::type cardType,
+    size_t dmaPageSize, std::vector<uint32_t>& checksums)
+{
+  checksums.clear();
+  for (const auto& packet : PacketRange(superpage, bufferAddress, cardType, dmaPageSize)) {
+    checksums.push_back(crc32c(packet.header, (packet.payload - packet.header) + packet.payloadSize));
+  }
+}
+
+} // namespace roc
+} // namespace AliceO2
@@ -0,0 +1,306 @@
+/// \file ErrorJournal.h
+/// \brief Definition of the ErrorJournal class.
+
+#ifndef ALICEO2_READOUTCARD_ERRORJOURNAL_H
+#define ALICEO2_READOUTCARD_ERRORJOURNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/format.hpp>
+#include "Common/BasicThread.h"
+
+namespace AliceO2 {
+namespace roc {
+namespace CommandLineUtilities {
+
+/// Kinds of records in the error journal
+enum class ErrorCategory : uint8_t
+{
+  /// A word of the data did not match the generator pattern
+  DataMismatch,
+  /// The memory size in the RDH was out of range
+  RdhSize,
+  /// The RDH packet counter did not follow the previous one
+  PacketCounter,
+  /// The data counter of a link was taken from the data, after an error or at the start
+  DataResync,
+  /// The packet counter of a link was taken from the data, after an error or at the start
+  PacketResync,
+};
+
+constexpr size_t ERROR_CATEGORIES = 5;
+
+/// An error found by the readout threads. Which fields are used depends on the category.
+struct ErrorRecord
+{
+    int64_t eventNumber;
+    ErrorCategory category;
+    uint32_t linkId;
+    /// Index of the mismatching 32-bit word
+    uint32_t index;
+    /// Data generator counter
+    uint32_t counter;
+    /// Expected word or packet counter
+    uint32_t expected;
+    /// Actual word or packet counter
+    uint32_t actual;
+    /// Payload or memory size in bytes
+    uint32_t size;
+    /// DMA page size in bytes
+    uint32_t pageSize;
+};
+
+/// Records errors of the readout threads in a fixed-size ring of binary records, which a background thread formats and
+/// writes to a file as they come in.
+///
+/// Adding a record is a few relaxed atomic operations and a copy, so the readout rate holds up when the data is bad.
+/// The ring can be filled by any number of threads. If it's full, records are dropped rather than waiting, and the
+/// number of dropped records is written at the end. Every record is counted per category and link, including the ones
+/// beyond the maximum number of records written.
+class ErrorJournal : public AliceO2::Common::BasicThread
+{
+  public:
+    /// \param capacity Number of records in the ring, rounded up to a power of two
+    /// \param maxRecords Maximum number of records written to the file
+    /// \param links Number of link IDs to count records for
+    ErrorJournal(size_t capacity, uint64_t maxRecords, uint32_t links)
+      : mMaxRecords(maxRecords), mLinks(links), mCounts(ERROR_CATEGORIES * links)
+    {
+      size_t size = 1;
+      while (size < capacity) {
+        size *= 2;
+      }
+      mSlots.reset(new Slot[size]);
+      mMask = size - 1;
+      for (size_t i = 0; i < size; ++i) {
+        mSlots[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    ~ErrorJournal()
+    {
+      stop();
+    }
+
+    /// Starts the thread writing the records
+    /// \param path File to write to. It's only created once there's a record to write.
+    void start(const std::string& path)
+    {
+      mPath = path;
+      BasicThread::start([&](std::atomic<bool>* stopFlag) {
+        while (!stopFlag->load(std::memory_order_relaxed)) {
+          if (!write()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          }
+        }
+      });
+    }
+
+    /// Stops the thread, writes the remaining records, and ends the file with the counts per category and link
+    void stop()
+    {
+      join();
+      write();
+      if (mStream.is_open()) {
+        writeSummary();
+        mStream.close();
+      }
+    }
+
+    /// Adds a record. Safe to call from multiple threads.
+    void add(const ErrorRecord& record)
+    {
+      if (record.linkId < mLinks) {
+        mCounts[size_t(record.category) * mLinks + record.linkId].fetch_add(1, std::memory_order_relaxed);
+      }
+      if (mAccepted.load(std::memory_order_relaxed) >= mMaxRecords
+          || mAccepted.fetch_add(1, std::memory_order_relaxed) >= mMaxRecords) {
+        return;
+      }
+      if (!push(record)) {
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    /// Gets the number of records of a category, over all links
+    uint64_t getCount(ErrorCategory category) const
+    {
+      uint64_t count = 0;
+      for (uint32_t link = 0; link < mLinks; ++link) {
+        count += getCount(category, link);
+      }
+      return count;
+    }
+
+    /// Gets the number of records of a category and link
+    uint64_t getCount(ErrorCategory category, uint32_t linkId) const
+    {
+      return mCounts[size_t(category) * mLinks + linkId].load(std::memory_order_relaxed);
+    }
+
+    /// Gets the number of records written to the file
+    uint64_t getWritten() const
+    {
+      return mWritten.load(std::memory_order_relaxed);
+    }
+
+    /// Gets the number of records dropped because the ring was full
+    uint64_t getDropped() const
+    {
+      return mDropped.load(std::memory_order_relaxed);
+    }
+
+    static const char* getCategoryName(ErrorCategory category)
+    {
+      switch (category) {
+        case ErrorCategory::DataMismatch: return "DATA_MISMATCH";
+        case ErrorCategory::RdhSize: return "RDH_SIZE";
+        case ErrorCategory::PacketCounter: return "PACKET_COUNTER";
+        case ErrorCategory::DataResync: return "DATA_RESYNC";
+        case ErrorCategory::PacketResync: return "PACKET_RESYNC";
+        default: return "UNKNOWN";
+      }
+    }
+
+    /// Formats a record as a line of text
+    static std::string format(const ErrorRecord& r)
+    {
+      switch (r.category) {
+        case ErrorCategory::DataMismatch:
+          return (boost::format("[ERROR]\tevent:%d link:%d cnt:%x payloadBytes:%d i:%d exp:%x val:%x\n")
+              % r.eventNumber % r.linkId % r.counter % r.size % r.index % r.expected % r.actual).str();
+        case ErrorCategory::RdhSize:
+          return (boost::format("[RDHERR]\tevent:%1% l:%2% payloadBytes:%3% size:%4% words out of range\n")
+              % r.eventNumber % r.linkId % r.size % r.pageSize).str();
+        case ErrorCategory::PacketCounter:
+          return (boost::format("[RDHERR]\tevent:%1% l:%2% payloadBytes:%3% size:%4% packet_cnt:%5% mpacket_cnt:%6% "
+              "unexpected packet counter\n")
+              % r.eventNumber % r.linkId % r.size % r.pageSize % r.actual % r.expected).str();
+        case ErrorCategory::DataResync:
+          return (boost::format("resync counter for e:%d l:%d cnt:%x\n") % r.eventNumber % r.linkId % r.counter).str();
+        case ErrorCategory::PacketResync:
+          return (boost::format("resync packet counter for e:%d l:%d packet_cnt:%x mpacket_cnt:%x\n")
+              % r.eventNumber % r.linkId % r.actual % r.expected).str();
+        default:
+          return "";
+      }
+    }
+
+  private:
+    struct Slot
+    {
+        /// Position in the ring the slot can be written at, or that position plus one once it's written
+        std::atomic<uint64_t> sequence;
+        ErrorRecord record;
+    };
+
+    /// Claims a slot and writes the record into it, see Dmitry Vyukov's bounded MPMC queue
+    bool push(const ErrorRecord& record)
+    {
+      auto position = mHead.load(std::memory_order_relaxed);
+      Slot* slot;
+      while (true) {
+        slot = &mSlots[position & mMask];
+        auto difference = int64_t(slot->sequence.load(std::memory_order_acquire)) - int64_t(position);
+        if (difference == 0) {
+          if (mHead.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+            break;
+          }
+        } else if (difference < 0) {
+          return false; // Full
+        } else {
+          position = mHead.load(std::memory_order_relaxed);
+        }
+      }
+      slot->record = record;
+      slot->sequence.store(position + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// Takes a record from the ring. Only called by the writing thread.
+    bool pop(ErrorRecord& record)
+    {
+      auto& slot = mSlots[mTail & mMask];
+      if (slot.sequence.load(std::memory_order_acquire) != (mTail + 1)) {
+        return false;
+      }
+      record = slot.record;
+      slot.sequence.store(mTail + mMask + 1, std::memory_order_release);
+      mTail++;
+      return true;
+    }
+
+    /// Writes the records in the ring
+    /// \return True if there were any
+    bool write()
+    {
+      ErrorRecord record;
+      bool wrote = false;
+      while (pop(record)) {
+        if (!mStream.is_open()) {
+          mStream.open(mPath);
+        }
+        mStream << format(record);
+        mWritten.fetch_add(1, std::memory_order_relaxed);
+        wrote = true;
+      }
+      if (wrote) {
+        mStream.flush();
+      }
+      return wrote;
+    }
+
+    void writeSummary()
+    {
+      uint64_t total = 0;
+      for (const auto& count : mCounts) {
+        total += count.load();
+      }
+      mStream << "# Wrote " << getWritten() << " of " << total << " records, maximum is " << mMaxRecords << '\n';
+      if (getDropped() != 0) {
+        mStream << "# " << getDropped() << " records dropped, the journal was full\n";
+      }
+      mStream << "# Records per category and link\n";
+      for (size_t i = 0; i < ERROR_CATEGORIES; ++i) {
+        auto category = ErrorCategory(i);
+        mStream << "# " << getCategoryName(category) << '\t' << getCount(category);
+        for (uint32_t link = 0; link < mLinks; ++link) {
+          if (auto count = getCount(category, link)) {
+            mStream << '\t' << link << ':' << count;
+          }
+        }
+        mStream << '\n';
+      }
+    }
+
+    const uint64_t mMaxRecords;
+    const uint32_t mLinks;
+    std::string mPath;
+    std::ofstream mStream;
+
+    std::unique_ptr<Slot[]> mSlots;
+    uint64_t mMask = 0;
+    /// Next position to write to, shared by the adding threads
+    std::atomic<uint64_t> mHead {0};
+    /// Next position to read from, only used by the writing thread
+    uint64_t mTail = 0;
+
+    /// Counts per category and link, indexed by category * mLinks + link
+    std::vector<std::atomic<uint64_t>> mCounts;
+    /// Records given to add() that counted toward the maximum. Stops growing just past the maximum.
+    std::atomic<uint64_t> mAccepted {0};
+    std::atomic<uint64_t> mWritten {0};
+    std::atomic<uint64_t> mDropped {0};
+};
+
+} // namespace CommandLineUtilities
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_READOUTCARD_ERRORJOURNAL_H
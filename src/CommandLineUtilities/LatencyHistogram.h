@@ -0,0 +1,111 @@
+/// \file LatencyHistogram.h
+/// \brief Definition of the LatencyHistogram class.
+
+#ifndef ALICEO2_READOUTCARD_LATENCYHISTOGRAM_H
+#define ALICEO2_READOUTCARD_LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace AliceO2 {
+namespace roc {
+namespace CommandLineUtilities {
+
+/// Histogram of latencies with a fixed relative precision, in the style of HdrHistogram.
+///
+/// Each power of two of nanoseconds is split in 32 buckets, so percentiles are within about 3% of the real value, from
+/// nanoseconds to centuries, in a fixed 15 KiB. Only one thread may record, but any thread can read percentiles while
+/// it does.
+class LatencyHistogram
+{
+  public:
+    void record(std::chrono::steady_clock::duration latency)
+    {
+      auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+      auto value = uint64_t(nanoseconds > 0 ? nanoseconds : 0);
+      increment(mBuckets[getIndex(value)]);
+      increment(mCount);
+      if (value > mMax.load(std::memory_order_relaxed)) {
+        mMax.store(value, std::memory_order_relaxed);
+      }
+    }
+
+    /// Gets the number of latencies recorded
+    uint64_t getCount() const
+    {
+      return mCount.load(std::memory_order_relaxed);
+    }
+
+    /// Gets the highest latency recorded in nanoseconds
+    uint64_t getMax() const
+    {
+      return mMax.load(std::memory_order_relaxed);
+    }
+
+    /// Gets a percentile of the latencies in nanoseconds. It's the upper bound of the bucket the percentile falls in,
+    /// but never more than the maximum.
+    /// \param percentile Percentile, e.g. 99.9
+    uint64_t getPercentile(double percentile) const
+    {
+      auto count = getCount();
+      if (count == 0) {
+        return 0;
+      }
+      auto rank = uint64_t(percentile / 100.0 * double(count) + 0.5);
+      rank = rank < 1 ? 1 : rank;
+      uint64_t seen = 0;
+      for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += mBuckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+          auto upper = getUpperBound(i);
+          return upper < getMax() ? upper : getMax();
+        }
+      }
+      return getMax();
+    }
+
+  private:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    /// Values below 2 * SUB_BUCKETS have their own bucket, above that every power of two has SUB_BUCKETS
+    static constexpr size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static size_t getIndex(uint64_t value)
+    {
+      if (value < SUB_BUCKETS) {
+        return size_t(value);
+      }
+      int exponent = 63 - __builtin_clzll(value);
+      int shift = exponent - SUB_BUCKET_BITS;
+      return size_t(shift + 1) * SUB_BUCKETS + size_t((value >> shift) - SUB_BUCKETS);
+    }
+
+    static uint64_t getUpperBound(size_t index)
+    {
+      if (index < SUB_BUCKETS) {
+        return index;
+      }
+      int shift = int(index / SUB_BUCKETS) - 1;
+      uint64_t lower = uint64_t((index % SUB_BUCKETS) + SUB_BUCKETS) << shift;
+      return lower + ((uint64_t(1) << shift) - 1);
+    }
+
+    /// Only one thread writes, so it doesn't need an atomic read-modify-write
+    static void increment(std::atomic<uint64_t>& value)
+    {
+      value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKETS> mBuckets {};
+    std::atomic<uint64_t> mCount {0};
+    std::atomic<uint64_t> mMax {0};
+};
+
+} // namespace CommandLineUtilities
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_READOUTCARD_LATENCYHISTOGRAM_H
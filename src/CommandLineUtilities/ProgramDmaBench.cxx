@@ -5,16 +5,19 @@
 /// \author Kostas Alexopoulos (kostas.alexopoulos@cern.ch)
 
 
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <future>
+#include <map>
 #include <fstream>
 #include <random>
 #include <queue>
 #include <sstream>
 #include <stdexcept>
 #include <thread>
+#include <boost/algorithm/string.hpp>
 #include <boost/circular_buffer.hpp>
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/interprocess/sync/named_mutex.hpp>
@@ -24,13 +27,20 @@
 #include <boost/tokenizer.hpp>
 #include "BarHammer.h"
 #include "CommandLineUtilities/Common.h"
+#include "CommandLineUtilities/ErrorJournal.h"
+#include "CommandLineUtilities/LatencyHistogram.h"
 #include "CommandLineUtilities/Options.h"
 #include "CommandLineUtilities/Program.h"
+#include "CommandLineUtilities/StatsWriter.h"
+#include "CommandLineUtilities/SuperpageWriter.h"
 #include "Common/Iommu.h"
 #include "Common/SuffixOption.h"
 #include "Cru/DataFormat.h"
+#include "DmaCapture.h"
 #include "ExceptionInternal.h"
+#include "Factory/ChannelFactoryUtils.h"
 #include "InfoLogger/InfoLogger.hxx"
+#include "PatternVerifier.h"
 #include "folly/ProducerConsumerQueue.h"
 #include "ReadoutCard/ChannelFactory.h"
 #include "ReadoutCard/MemoryMappedFile.h"
@@ -38,6 +48,7 @@
 #include "ReadoutCard/ReadoutCard.h"
 #include "time.h"
 #include "Utilities/Hugetlbfs.h"
+#include "Utilities/Numa.h"
 #include "Utilities/SmartPointer.h"
 #include "Utilities/Util.h"
 
@@ -66,10 +77,15 @@ constexpr uint32_t BUFFER_DEFAULT_VALUE = 0xCcccCccc;
 const std::string PROGRESS_FORMAT_HEADER("  %-8s   %-12s  %-12s %-18s  %-12s  %-5.1f");
 /// Fields: Time(hour:minute:second), Pages pushed, Pages read, Errors, °C
 const std::string PROGRESS_FORMAT("  %02s:%02s:%02s   %-12s  %-12s  %-18s  %-12s  %-5.1f");
+/// Fields added with --display-latency: 99th percentile and maximum of the push-to-ready latency
+const std::string PROGRESS_FORMAT_LATENCY_HEADER("  %-16s  %-16s");
+const std::string PROGRESS_FORMAT_LATENCY("  %-16.1f  %-16.1f");
 /// Path for error log
 auto READOUT_ERRORS_PATH = "readout_errors.txt";
-/// Max amount of errors that are recorded into the error stream
+/// Max amount of error records that are written to the error log
 constexpr int64_t MAX_RECORDED_ERRORS = 10000;
+/// Number of error records the readout threads can be ahead of the thread writing them
+constexpr size_t ERROR_JOURNAL_CAPACITY = 4096;
 /// End InfoLogger message alias
 constexpr auto endm = InfoLogger::endm;
 /// We use steady clock because otherwise system clock changes could affect the running of the program
@@ -80,6 +96,86 @@ struct TimeLimit {
     uint64_t minutes = 0;
     uint64_t hours = 0;
 };
+/// Superpage passed from the push thread to the readout thread
+struct ReadySuperpage {
+    size_t offset = 0;
+    size_t received = 0;
+    TimePoint arrival;
+};
+
+/// Thread that reads out and checks superpages given by the readout thread, for --readout-threads
+struct CheckerThread {
+    CheckerThread(uint32_t queueSize) : input(queueSize), done(queueSize)
+    {
+    }
+
+    /// Superpages to read out
+    folly::ProducerConsumerQueue<ReadySuperpage> input;
+    /// Offsets of superpages that were read out
+    folly::ProducerConsumerQueue<size_t> done;
+    std::future<void> future;
+    /// Time spent reading out
+    std::chrono::steady_clock::duration readoutTime {0};
+};
+
+/// A card and DMA channel given with --channels
+struct ChannelSpec {
+    std::string cardId;
+    int channel = 0;
+};
+
+/// Parses the --channels option, a comma separated list of [card ID]/[DMA channel]. The card ID is separated with a
+/// slash, since PCI addresses contain colons.
+std::vector<ChannelSpec> parseChannelSpecs(const std::string& string)
+{
+  std::vector<ChannelSpec> specs;
+  std::vector<std::string> items;
+  b::split(items, string, b::is_any_of(","));
+  for (const auto& item : items) {
+    std::vector<std::string> parts;
+    b::split(parts, b::trim_copy(item), b::is_any_of("/"));
+    ChannelSpec spec;
+    if (parts.size() != 2 || parts[0].empty() || !b::conversion::try_lexical_convert<int>(parts[1], spec.channel)
+        || spec.channel < 0) {
+      BOOST_THROW_EXCEPTION(ParameterException()
+          << ErrorInfo::Message("Malformed channel '" + item + "', expected [card ID]/[DMA channel]"));
+    }
+    Parameters::cardIdFromString(parts[0]); // Throws if it's not a serial number or PCI address
+    spec.cardId = parts[0];
+    for (const auto& other : specs) {
+      if (other.cardId == spec.cardId && other.channel == spec.channel) {
+        BOOST_THROW_EXCEPTION(ParameterException() << ErrorInfo::Message("Channel '" + item + "' given twice"));
+      }
+    }
+    specs.push_back(spec);
+  }
+  return specs;
+}
+
+/// Inserts a suffix in a path before the extension, e.g. "readout_errors.txt" to "readout_errors_1_0.txt"
+std::string addPathSuffix(const std::string& path, const std::string& suffix)
+{
+  auto dot = path.rfind('.');
+  auto slash = path.rfind('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return path + suffix;
+  }
+  return path.substr(0, dot) + suffix + path.substr(dot);
+}
+
+/// Gets the NUMA node of a card, or -1 if it's unknown, like for the dummy card
+int getCardNumaNode(const Parameters::CardIdType& cardId)
+{
+  auto serial = boost::get<int>(&cardId);
+  if (serial && (*serial == ChannelFactory::getDummySerialNumber())) {
+    return -1;
+  }
+#ifdef ALICEO2_READOUTCARD_PDA_ENABLED
+  return ChannelFactoryUtils::findCard(cardId).numaNode;
+#else
+  return -1;
+#endif
+}
 } // Anonymous namespace
 
 
@@ -115,6 +211,12 @@ class ProgramDmaBench: public Program
           ("bytes",
               SuffixOption<uint64_t>::make(&mOptions.maxBytes)->default_value("0"),
               "Limit of bytes to transfer. Give 0 for infinite.")
+          ("channels",
+              po::value<std::string>(&mOptions.channelsString),
+              "Run on several DMA channels at once, instead of the one given by --id and --dma-channel. A comma "
+              "separated list of [card ID]/[DMA channel], e.g. '42:0.0/0,3b:0.0/0'. Each channel gets its own buffer, "
+              "on the NUMA node of its card, and its own push and readout thread, pinned to cores of that node. Limits "
+              "like --bytes apply to each channel.")
           ("buffer-size",
               SuffixOption<size_t>::make(&mBufferSize)->default_value("1Gi"),
               "Buffer size in bytes. Rounded down to 2 MiB multiple. Minimum of 2 MiB. Use 2 MiB hugepage by default; |"
@@ -127,7 +229,18 @@ class ProgramDmaBench: public Program
               "Enable data generator")
           ("generator-size",
               SuffixOption<size_t>::make(&mOptions.dataGeneratorSize)->default_value("0"),
-              "Data generator data size. 0 will use internal driver default.");
+              "Data generator data size. 0 will use internal driver default.")
+          ("generator-rate",
+              SuffixOption<size_t>::make(&mOptions.generatorRate)->default_value("0"),
+              "Data generator rate per link in bytes per second, for the dummy card (--id=-1). 0 for unlimited.")
+          ("generator-faults",
+              po::value<std::string>(&mOptions.generatorFaultsString),
+              "Faults to inject with the dummy card's data generator, with their probability per page (per superpage "
+              "for READY_QUEUE_OVERFLOW). A comma separated list of [DROP_PAGE, CORRUPT_RDH, SKIP_PACKET_COUNTER, "
+              "STALL_LINK, READY_QUEUE_OVERFLOW]:[probability], e.g. 'DROP_PAGE:1e-4,STALL_LINK:1e-5'")
+          ("generator-stall",
+              po::value<uint64_t>(&mOptions.generatorStallTime)->default_value(10),
+              "Time in milliseconds a link stops sending data on a STALL_LINK fault");
       Options::addOptionCardId(options);
       options.add_options()
           ("links",
@@ -136,6 +249,12 @@ class ProgramDmaBench: public Program
           ("loopback",
               po::value<std::string>(&mOptions.loopbackModeString)->default_value("INTERNAL"),
               "Generator loopback mode [NONE, INTERNAL, DIU, SIU]")
+          ("display-latency",
+              po::bool_switch(&mOptions.displayLatency),
+              "Show the 99th percentile and maximum of the push-to-ready latency of the superpages in the status display")
+          ("checksum",
+              po::bool_switch(&mOptions.checksum),
+              "Compute the CRC32C of every superpage before reading it out, and report the throughput of the checksums")
           ("no-errorcheck",
               po::bool_switch(&mOptions.noErrorCheck),
               "Skip error checking")
@@ -144,7 +263,7 @@ class ProgramDmaBench: public Program
               "Disable command-line display")
           ("no-resync",
               po::bool_switch(&mOptions.noResyncCounter),
-              "Disable counter resync")
+              "Disable counter resync. The DDG data of the CRU and dummy card is always resynced.")
           ("no-rm-pages-file",
               po::bool_switch(&mOptions.noRemovePagesFile),
               "Don't remove the file used for pages after benchmark completes")
@@ -169,9 +288,23 @@ class ProgramDmaBench: public Program
           ("random-pause",
               po::bool_switch(&mOptions.randomPause),
               "Randomly pause readout")
+          ("readout-threads",
+              po::value<size_t>(&mOptions.readoutThreads)->default_value(1),
+              "Number of threads that read out and check the superpages. With more than one, superpages are given to "
+              "the threads by link ID, so the data of a link is always checked by the same thread, in order")
           ("readout-mode",
               po::value<std::string>(&mOptions.readoutModeString),
               "Set readout mode [CONTINUOUS]")
+          ("record",
+              po::value<std::string>(&mOptions.recordPath),
+              "Record the superpages to the given file as a DMA capture, with their link IDs and arrival times, so "
+              "they can be replayed with --replay")
+          ("replay",
+              po::value<std::string>(&mOptions.replayPath),
+              "Replay the given DMA capture instead of generating data. Only supported by the dummy card.")
+          ("replay-no-pacing",
+              po::bool_switch(&mOptions.replayNoPacing),
+              "Replay the capture as fast as possible, instead of at the pacing it was recorded with")
           ("superpage-size",
               SuffixOption<size_t>::make(&mSuperpageSize)->default_value("1Mi"),
               "Superpage size in bytes. Note that it can't be larger than the buffer. If the IOMMU is not enabled, the "
@@ -179,27 +312,61 @@ class ProgramDmaBench: public Program
           ("time",
               po::value<std::string>(&mOptions.timeLimitString),
               "Time limit for benchmark. Any combination of [n]h, [n]m, & [n]s. For example: '5h30m', '10s', '1s2h3m'.")
+          ("output-format",
+              po::value<std::string>(&mOptions.outputFormat),
+              "Also write statistics every sampling period in a machine-readable format [json, csv]. JSON is written as "
+              "one object per line. The last line is a summary of the whole run.")
+          ("output-path",
+              po::value<std::string>(&mOptions.outputPath),
+              "Path for the --output-format statistics. Default is 'readout_stats.json' or 'readout_stats.csv'")
+          ("output-period",
+              po::value<size_t>(&mOptions.outputPeriod)->default_value(1000),
+              "Sampling period of the --output-format statistics in milliseconds")
           ("to-file-ascii",
               po::value<std::string>(&mOptions.fileOutputPathAscii),
               "Read out to given file in ASCII format")
           ("to-file-bin",
               po::value<std::string>(&mOptions.fileOutputPathBin),
-              "Read out to given file in binary format (only contains raw data from pages)");
+              "Read out to given file in binary format (only contains raw data from pages). Whole superpages are "
+              "written with O_DIRECT by separate I/O threads, so the readout doesn't wait for the storage unless the "
+              "write queue is full")
+          ("write-queue",
+              po::value<size_t>(&mOptions.writeQueue)->default_value(64),
+              "Maximum number of superpages queued for writing with --to-file-bin. When it's full, the readout waits.")
+          ("write-threads",
+              po::value<size_t>(&mOptions.writeThreads)->default_value(1),
+              "Number of I/O threads writing the superpages with --to-file-bin");
     }
 
     virtual void run(const po::variables_map& map)
     {
-      for (auto& i : mDataGeneratorCounters) {
-        i = DATA_COUNTER_INITIAL_VALUE;
+      if (!mOptions.channelsString.empty()) {
+        runChannels();
+      } else {
+        runChannel(Options::getOptionCardId(map), Options::getOptionCardIdString(map));
+        outputErrors();
+        outputStats();
       }
+      getLogger() << "Benchmark complete" << endm;
+    }
 
-      for (auto&i : mPacketCounters) {
-        i = PACKET_COUNTER_INITIAL_VALUE;
+  private:
+
+    /// Runs the benchmark on one DMA channel, until it's done or stopped
+    void runChannel(const Parameters::CardIdType& cardId, const std::string& cardIdString)
+    {
+      // In multi-channel mode, keep the buffer and the threads on the NUMA node of the card. Hugepages are allocated on
+      // the node of the thread that faults them in, which is this one when the channel registers the buffer.
+      if (!mNodeCpus.empty()) {
+        Utilities::setThreadAffinity(mNodeCpus);
+      }
+
+      for (auto& i : mDataGeneratorCounters) {
+        i = DATA_COUNTER_INITIAL_VALUE;
       }
 
       getLogger() << "DMA channel: " << mOptions.dmaChannel << endm;
 
-      auto cardId = Options::getOptionCardId(map);
       auto params = Parameters::makeParameters(cardId, mOptions.dmaChannel);
       params.setDmaPageSize(mOptions.dmaPageSize);
       params.setGeneratorEnabled(mOptions.generatorEnabled);
@@ -214,16 +381,48 @@ class ProgramDmaBench: public Program
 
         if (mOptions.fileOutputAscii && mOptions.fileOutputBin) {
           throw ParameterException() << ErrorInfo::Message("File output can't be both ASCII and binary");
+        } else if ((mOptions.fileOutputAscii || mOptions.fileOutputBin) && (mOptions.readoutThreads > 1)) {
+          throw ParameterException() << ErrorInfo::Message("File output needs a single readout thread");
         } else {
           if (mOptions.fileOutputAscii) {
             mReadoutStream.open(mOptions.fileOutputPathAscii);
           }
           if (mOptions.fileOutputBin) {
-            mReadoutStream.open(mOptions.fileOutputPathBin, std::ios::binary);
+            // O_DIRECT needs aligned superpages. The buffer is hugepage aligned, so that's up to the superpage size.
+            mFileWriter = std::make_unique<SuperpageWriter>(mOptions.fileOutputPathBin, mOptions.writeQueue,
+                mOptions.writeThreads, Utilities::isMultiple(mSuperpageSize, SuperpageWriter::ALIGNMENT));
+            getLogger() << "Writing to: " << mOptions.fileOutputPathBin
+              << (mFileWriter->isDirect() ? " with O_DIRECT" : " through the page cache") << endm;
           }
         }
       }
 
+      // Handle machine-readable statistics options
+      if (!mOptions.outputFormat.empty()) {
+        auto format = StatsWriter::parseFormat(mOptions.outputFormat);
+        if (mOptions.outputPeriod == 0) {
+          throw ParameterException() << ErrorInfo::Message("Output period must be larger than 0");
+        }
+        if (mOptions.outputPath.empty()) {
+          mOptions.outputPath = std::string("readout_stats.") + mOptions.outputFormat;
+        }
+        mStatsStream.open(mOptions.outputPath);
+        mStatsWriter = std::make_unique<StatsWriter>(mStatsStream, format);
+        getLogger() << "Writing statistics to: " << mOptions.outputPath << endm;
+      }
+
+      // Handle DMA capture options
+      if (!mOptions.recordPath.empty()) {
+        mCaptureWriter = std::make_unique<DmaCaptureWriter>(mOptions.recordPath, mOptions.dmaPageSize);
+        getLogger() << "Recording to: " << mOptions.recordPath << endm;
+      }
+      if (!mOptions.replayPath.empty()) {
+        params.setReplayFile(mOptions.replayPath);
+        params.setReplayPacingEnabled(!mOptions.replayNoPacing);
+        getLogger() << "Replaying: " << mOptions.replayPath << (mOptions.replayNoPacing ? " without pacing" : "")
+          << endm;
+      }
+
       // Handle generator pattern option
       if (!mOptions.generatorPatternString.empty()) {
         mOptions.generatorPattern = GeneratorPattern::fromString(mOptions.generatorPatternString);
@@ -245,7 +444,7 @@ class ProgramDmaBench: public Program
 
         // Add time to the buffer's filename. This way we guard our buffer from being overwritten by another process
         // as this is before the DMA Channel initialization and no lock protection is in place.
-        std::string bufferName = (b::format("roc-bench-dma_id=%s_chan=%s_%s_pages") % map["id"].as<std::string>()
+        std::string bufferName = (b::format("roc-bench-dma_id=%s_chan=%s_%s_pages") % cardIdString
             % mOptions.dmaChannel
             % time(0)).str();
 
@@ -286,6 +485,17 @@ class ProgramDmaBench: public Program
       getLogger() << "Page limit: " << mMaxPages << endm;
       getLogger() << "Pages per superpage: " << mPagesPerSuperpage << endm;
 
+      if (mOptions.generatorRate != 0) {
+        params.setGeneratorRate(mOptions.generatorRate);
+        getLogger() << "Generator rate: " << mOptions.generatorRate << " B/s per link" << endm;
+      }
+
+      if (!mOptions.generatorFaultsString.empty()) {
+        params.setGeneratorFaultMap(Parameters::generatorFaultMapFromString(mOptions.generatorFaultsString));
+        params.setGeneratorStallTime(std::chrono::milliseconds(mOptions.generatorStallTime));
+        getLogger() << "Generator faults: " << mOptions.generatorFaultsString << endm;
+      }
+
       if (mOptions.dataGeneratorSize != 0) {
         params.setGeneratorDataSize(mOptions.dataGeneratorSize);
         getLogger() << "Generator data size: " << mOptions.dataGeneratorSize << endm;
@@ -304,6 +514,14 @@ class ProgramDmaBench: public Program
       }
 
       mCardType = mChannel->getCardType();
+      if (mCardType == CardType::Cru || mCardType == CardType::Dummy) {
+        mIntegrityChecker = std::make_unique<LinkIntegrityChecker>(mCardType, true);
+      }
+
+      // The number of dropped packets is in BAR 2 of the CRU
+      if (mStatsWriter && mCardType == CardType::Cru) {
+        mStatsBar = ChannelFactory().getBar(Parameters::makeParameters(cardId, 2));
+      }
       getLogger() << "Card type: " << CardType::toString(mChannel->getCardType()) << endm;
       getLogger() << "Card PCI address: " << mChannel->getPciAddress().toString() << endm;
       getLogger() << "Card NUMA node: " << mChannel->getNumaNode() << endm;
@@ -329,10 +547,17 @@ class ProgramDmaBench: public Program
           << endm;
       }
 
+      mErrorJournal.start(mErrorsPath);
       mRunTime.start = std::chrono::steady_clock::now();
+      mLastStats.time = mRunTime.start;
       dmaLoop();
       mRunTime.end = std::chrono::steady_clock::now();
 
+      if (mCaptureWriter) {
+        mCaptureWriter->close();
+        getLogger() << "Recorded " << mCaptureWriter->getRecordCount() << " superpages" << endm;
+      }
+
       if (mBarHammer) {
         mBarHammer->join();
       }
@@ -342,12 +567,153 @@ class ProgramDmaBench: public Program
       int popped = freeExcessPages(10ms);
       getLogger() << "Popped " << popped << " remaining superpages" << endm;
 
-      outputErrors();
-      outputStats();
-      getLogger() << "Benchmark complete" << endm;
+      if (mFileWriter) {
+        mFileWriter->close();
+      }
     }
 
-  private:
+    /// Runs the benchmark on all channels of --channels at once, each with its own ProgramDmaBench in a thread, and
+    /// reports their statistics and the aggregate throughput
+    void runChannels()
+    {
+      if (!mOptions.fileOutputPathAscii.empty() || !mOptions.fileOutputPathBin.empty() || !mOptions.recordPath.empty()
+          || mOptions.barHammer) {
+        BOOST_THROW_EXCEPTION(ParameterException() << ErrorInfo::Message(
+            "File output, recording and BAR hammer are not supported with multiple channels"));
+      }
+
+      auto specs = parseChannelSpecs(mOptions.channelsString);
+      std::atomic<bool> stop {false};
+      // Per NUMA node, the index of the next core to pin a thread to
+      std::map<int, size_t> nextCpus;
+      std::vector<std::unique_ptr<ProgramDmaBench>> benches;
+      for (const auto& spec : specs) {
+        auto bench = std::make_unique<ProgramDmaBench>();
+        bench->mOptions = mOptions;
+        bench->mOptions.dmaChannel = spec.channel;
+        bench->mOptions.noDisplay = true;
+        bench->mBufferSize = mBufferSize;
+        bench->mSuperpageSize = mSuperpageSize;
+        bench->mLabel = spec.cardId + "/" + std::to_string(spec.channel);
+        bench->mStopAll = &stop;
+
+        // Every channel writes its own files
+        auto suffix = "_" + spec.cardId + "_" + std::to_string(spec.channel);
+        bench->mErrorsPath = addPathSuffix(READOUT_ERRORS_PATH, suffix);
+        if (!mOptions.outputFormat.empty()) {
+          bench->mOptions.outputPath = addPathSuffix(mOptions.outputPath.empty()
+              ? "readout_stats." + mOptions.outputFormat : mOptions.outputPath, suffix);
+        }
+
+        auto numaNode = getCardNumaNode(Parameters::cardIdFromString(spec.cardId));
+        if (numaNode >= 0) {
+          bench->mNodeCpus = Utilities::getNumaNodeCpus(numaNode);
+          auto& next = nextCpus[numaNode];
+          bench->mPushCpu = bench->mNodeCpus[next++ % bench->mNodeCpus.size()];
+          bench->mReadoutCpu = bench->mNodeCpus[next++ % bench->mNodeCpus.size()];
+          getLogger() << "Channel " << bench->mLabel << ": NUMA node " << numaNode << ", push thread on CPU "
+            << *bench->mPushCpu << ", readout thread on CPU " << *bench->mReadoutCpu << endm;
+        } else {
+          getLogger() << "Channel " << bench->mLabel << ": NUMA node unknown, threads not pinned" << endm;
+        }
+        benches.push_back(std::move(bench));
+      }
+
+      std::vector<std::future<void>> futures;
+      for (size_t i = 0; i < benches.size(); ++i) {
+        auto bench = benches[i].get();
+        auto cardIdString = specs[i].cardId;
+        futures.push_back(std::async(std::launch::async, [&stop, bench, cardIdString]{
+          try {
+            bench->runChannel(Parameters::cardIdFromString(cardIdString), cardIdString);
+          }
+          catch (std::exception& e) {
+            // Stop the other channels too
+            stop = true;
+            throw;
+          }
+        }));
+      }
+
+      // Display the throughput of every channel and the total, averaged since the start
+      auto start = std::chrono::steady_clock::now();
+      auto nextDisplay = start;
+      if (!mOptions.noDisplay) {
+        cout << '\n' << b::format("  %-8s") % "Time";
+        for (const auto& bench : benches) {
+          cout << b::format("  %-16s") % bench->mLabel;
+        }
+        cout << b::format("  %-16s") % "Total (Gbps)" << '\n';
+      }
+      auto isDone = [&]{
+        return std::all_of(futures.begin(), futures.end(), [](const std::future<void>& future) {
+          return future.wait_for(0s) == std::future_status::ready;
+        });
+      };
+      while (!isDone()) {
+        auto now = std::chrono::steady_clock::now();
+        if (!mOptions.noDisplay && now >= nextDisplay) {
+          using namespace std::chrono;
+          auto diff = now - start;
+          double seconds = duration<double>(diff).count();
+          cout << '\r' << b::format("  %02d:%02d:%02d") % duration_cast<hours>(diff).count()
+            % (duration_cast<minutes>(diff).count() % 60) % (duration_cast<std::chrono::seconds>(diff).count() % 60);
+          double total = 0;
+          for (const auto& bench : benches) {
+            double Gb = double(bench->mReadoutCount.load()) * bench->mPageSize * 8 / (1000 * 1000 * 1000);
+            total += Gb / seconds;
+            cout << b::format("  %-16.2f") % (Gb / seconds);
+          }
+          cout << b::format("  %-16.2f") % total << std::flush;
+          nextDisplay += 1s;
+        }
+        std::this_thread::sleep_for(LOW_PRIORITY_INTERVAL);
+      }
+
+      for (auto& future : futures) {
+        future.get();
+      }
+
+      for (auto& bench : benches) {
+        bench->outputErrors();
+        bench->outputStats();
+      }
+      outputAggregateStats(benches);
+    }
+
+    /// Outputs the statistics of all channels of --channels together. They run concurrently, so the throughput is over
+    /// the time from the first start to the last end.
+    void outputAggregateStats(const std::vector<std::unique_ptr<ProgramDmaBench>>& benches)
+    {
+      auto start = benches.front()->mRunTime.start;
+      auto end = benches.front()->mRunTime.end;
+      double bytes = 0;
+      int64_t errors = 0;
+      for (const auto& bench : benches) {
+        start = std::min(start, bench->mRunTime.start);
+        end = std::max(end, bench->mRunTime.end);
+        bytes += double(bench->mReadoutCount.load()) * bench->mPageSize;
+        errors += bench->mErrorCount.load();
+      }
+      double runTime = std::chrono::duration<double>(end - start).count();
+      double GB = bytes / (1000 * 1000 * 1000);
+      double GBs = GB / runTime;
+
+      auto put = [&](auto label, auto value) { cout << b::format("  %-24s  %-10s\n") % label % value; };
+      cout << '\n';
+      put("Channels", benches.size());
+      put("Seconds", runTime);
+      put("Bytes", bytes);
+      put("GB/s", GBs);
+      put("Gb/s", GBs * 8);
+      put("GiB/s", bytes / (1024 * 1024 * 1024) / runTime);
+      if (mOptions.noErrorCheck) {
+        put("Errors", "n/a");
+      } else {
+        put("Errors", errors);
+      }
+      cout << '\n';
+    }
 
     void dmaLoop()
     {
@@ -357,7 +723,7 @@ class ProgramDmaBench: public Program
 
       // Lock-free queues. Usable size is (size-1), so we add 1
       /// Queue for passing filled superpages from the push thread to the readout thread
-      folly::ProducerConsumerQueue<size_t> readoutQueue {static_cast<uint32_t>(mMaxSuperpages) + 1};
+      folly::ProducerConsumerQueue<ReadySuperpage> readoutQueue {static_cast<uint32_t>(mMaxSuperpages) + 1};
       /// Queue for free superpages. This starts out as full, then the readout thread consumes them. When superpages
       /// arrive, they are passed via the readoutQueue to the readout thread. When the readout thread is done with it,
       /// it is put back in the freeQueue.
@@ -376,6 +742,7 @@ class ProgramDmaBench: public Program
       auto lowPriorityFuture = std::async(std::launch::async, [&]{
         try {
           auto next = std::chrono::steady_clock::now();
+          auto nextSample = next + std::chrono::milliseconds(mOptions.outputPeriod);
           while (!isStopDma()) {
             // Handle a SIGINT abort
             if (isSigInt()) {
@@ -385,6 +752,12 @@ class ProgramDmaBench: public Program
               return;
             }
 
+            // In multi-channel mode, stop when another channel failed
+            if (mStopAll && mStopAll->load(std::memory_order_relaxed)) {
+              mDmaLoopBreak = true;
+              return;
+            }
+
             // If there's a time limit, check it
             if (auto limit = mTimeLimitOptional) {
               if (std::chrono::steady_clock::now() >= limit) {
@@ -398,6 +771,12 @@ class ProgramDmaBench: public Program
             if (!mOptions.noDisplay && mPushCount.load(std::memory_order_relaxed) != 0) {
               updateStatusDisplay();
             }
+
+            // Machine-readable statistics
+            if (mStatsWriter && std::chrono::steady_clock::now() >= nextSample) {
+              writeStats("sample", readoutQueue.sizeGuess(), freeQueue.sizeGuess());
+              nextSample += std::chrono::milliseconds(mOptions.outputPeriod);
+            }
             next += LOW_PRIORITY_INTERVAL;
             std::this_thread::sleep_until(next);
           }
@@ -411,8 +790,15 @@ class ProgramDmaBench: public Program
       // Thread for pushing & checking arrivals
       auto pushFuture = std::async(std::launch::async, [&]{
         try {
+          if (mPushCpu) {
+            Utilities::setThreadAffinity({*mPushCpu});
+          }
           RandomPauses pauses;
           int currentPagesCounted = 0;
+          // Time each superpage was pushed, by index in the buffer
+          std::vector<TimePoint> pushTimes(mMaxSuperpages);
+          // Time each superpage was first seen ready, kept while the readout queue is full so retries don't move it
+          std::vector<TimePoint> arrivalTimes(mMaxSuperpages);
 
           while (!isStopDma()) {
             // Check if we need to stop in the case of a page limit
@@ -430,14 +816,16 @@ class ProgramDmaBench: public Program
             auto shouldRest = false;
 
             // Give free superpages to the driver
-            if (mChannel->getTransferQueueAvailable() != 0) {
-              while (mChannel->getTransferQueueAvailable() != 0) {
+            if (mChannel->getTransferQueueAvailableForSize(mSuperpageSize) != 0) {
+              while (mChannel->getTransferQueueAvailableForSize(mSuperpageSize) != 0) {
                 Superpage superpage;
                 size_t offsetRead;
                 if (freeQueue.read(offsetRead)) {
                   superpage.setSize(mSuperpageSize);
                   superpage.setOffset(offsetRead);
                   mChannel->pushSuperpage(superpage);
+                  pushTimes[offsetRead / mSuperpageSize] = std::chrono::steady_clock::now();
+                  arrivalTimes[offsetRead / mSuperpageSize] = TimePoint();
                 } else {
                   // No free pages available, so take a little break
                   shouldRest = true;
@@ -459,10 +847,21 @@ class ProgramDmaBench: public Program
               mPushCount.fetch_add(pagesToCount, std::memory_order_relaxed);
               currentPagesCounted += pagesToCount;
 
-              if (superpage.isReady() && readoutQueue.write(superpage.getOffset())) {
+              if (!superpage.isReady()) {
+                // Still being filled, so rest a while
+                shouldRest = true;
+                break;
+              }
+              auto index = superpage.getOffset() / mSuperpageSize;
+              if (arrivalTimes[index] == TimePoint()) {
+                arrivalTimes[index] = std::chrono::steady_clock::now();
+              }
+              if (readoutQueue.write(ReadySuperpage{superpage.getOffset(), superpage.getReceived(),
+                  arrivalTimes[index]})) {
                 // Move full superpage to readout queue
                 currentPagesCounted = 0;
                 mChannel->popSuperpage();
+                mPushToReady.record(arrivalTimes[index] - pushTimes[index]);
               } else {
                 // Readout is backed up, so rest a while
                 shouldRest = true;
@@ -481,9 +880,54 @@ class ProgramDmaBench: public Program
         }
       });
 
+      // Checker threads, only used with more than one readout thread. Each has a queue of superpages to read out, and
+      // a queue to hand them back to the readout thread when done, since the free queue only allows one producer.
+      std::vector<std::unique_ptr<CheckerThread>> checkers;
+      std::atomic<bool> checkersStop {false};
+      if (mOptions.readoutThreads > 1) {
+        for (size_t i = 0; i < mOptions.readoutThreads; ++i) {
+          checkers.push_back(std::make_unique<CheckerThread>(static_cast<uint32_t>(mMaxSuperpages) + 1));
+        }
+        for (auto& checker : checkers) {
+          auto checkerPointer = checker.get();
+          checker->future = std::async(std::launch::async, [&, checkerPointer]{
+            try {
+              ReadySuperpage ready;
+              while (true) {
+                if (checkerPointer->input.read(ready)) {
+                  checkerPointer->readoutTime += readoutSuperpage(ready);
+                  checkerPointer->done.write(ready.offset);
+                } else if (checkersStop.load(std::memory_order_relaxed)) {
+                  break;
+                } else {
+                  std::this_thread::sleep_for(std::chrono::microseconds(mOptions.pauseRead));
+                }
+              }
+            }
+            catch (std::exception& e) {
+              mDmaLoopBreak = true;
+              throw;
+            }
+          });
+        }
+      }
+
       // Readout thread (main thread)
-      {
+      try {
+        if (mReadoutCpu) {
+          Utilities::setThreadAffinity({*mReadoutCpu});
+        }
         RandomPauses pauses;
+        // Time each superpage was taken from the readout queue, by index in the buffer
+        std::vector<TimePoint> popTimes(mMaxSuperpages);
+
+        // Add superpage back to free queue
+        auto releaseSuperpage = [&](size_t offset) {
+          mPopToRelease.record(std::chrono::steady_clock::now() - popTimes[offset / mSuperpageSize]);
+          if (!freeQueue.write(offset)) {
+            BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Something went horribly wrong"));
+          }
+        };
 
         while (!isStopDma()) {
           if (!mInfinitePages && mReadoutCount.load(std::memory_order_relaxed) >= mMaxPages) {
@@ -494,29 +938,162 @@ class ProgramDmaBench: public Program
             pauses.pauseIfNeeded();
           }
 
-          size_t offset;
-          if (readoutQueue.read(offset)) {
-            // Read out pages
-            int pages = mSuperpageSize / mPageSize;
-            for (int i = 0; i < pages; ++i) {
-              auto readoutCount = fetchAddReadoutCount();
-              readoutPage(mBufferBaseAddress + offset + i * mPageSize, mPageSize, readoutCount);
+          bool didWork = false;
+          ReadySuperpage ready;
+          if (readoutQueue.read(ready)) {
+            didWork = true;
+            auto offset = ready.offset;
+            popTimes[offset / mSuperpageSize] = std::chrono::steady_clock::now();
+            mReadyToPop.record(popTimes[offset / mSuperpageSize] - ready.arrival);
+            if (mCaptureWriter) {
+              recordSuperpage(ready);
             }
 
-            // Page has been read out
-            // Add superpage back to free queue
-            if (!freeQueue.write(offset)) {
-              BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Something went horribly wrong"));
+            if (checkers.empty()) {
+              // Queue the superpage for writing first, so the storage works while we check it
+              if (mFileWriter) {
+                mFileWriter->write(reinterpret_cast<const void*>(mBufferBaseAddress + offset), mSuperpageSize, offset);
+              }
+
+              // Read out pages
+              mReadoutTime += readoutSuperpage(ready);
+
+              // Page has been read out. If it's being written, it's released when that's done.
+              if (!mFileWriter) {
+                releaseSuperpage(offset);
+              }
+            } else {
+              // Can't fail, the queue has room for all superpages
+              checkers[getSuperpageLinkId(ready) % checkers.size()]->input.write(ready);
+            }
+          }
+
+          // Add superpages that were written back to the free queue
+          if (mFileWriter) {
+            size_t offset;
+            while (mFileWriter->popDone(offset)) {
+              didWork = true;
+              if (mOptions.pageReset) {
+                resetPage(mBufferBaseAddress + offset, mSuperpageSize);
+              }
+              releaseSuperpage(offset);
+            }
+          }
+
+          // Add superpages the checkers are done with back to the free queue
+          for (auto& checker : checkers) {
+            size_t offset;
+            while (checker->done.read(offset)) {
+              didWork = true;
+              releaseSuperpage(offset);
             }
-          } else {
+          }
+
+          if (!didWork) {
             // No superpages available to read out, so have a nap
             std::this_thread::sleep_for(std::chrono::microseconds(mOptions.pauseRead));
           }
         }
       }
+      catch (std::exception& e) {
+        // Stop the other threads, or waiting for them on the way out would hang
+        mDmaLoopBreak = true;
+        checkersStop = true;
+        throw;
+      }
+
+      // Let the checkers finish the superpages they were given
+      checkersStop = true;
+      for (auto& checker : checkers) {
+        checker->future.get();
+        mReadoutTime += checker->readoutTime;
+      }
 
       pushFuture.get();
       lowPriorityFuture.get();
+
+      if (mStatsWriter) {
+        writeStats("summary", readoutQueue.sizeGuess(), freeQueue.sizeGuess());
+      }
+    }
+
+    /// Writes a sample of the statistics with the StatsWriter. The throughput of samples is over the period since the
+    /// previous one, the throughput of the summary over the whole run.
+    void writeStats(const std::string& type, size_t readoutQueueSize, size_t freeQueueSize)
+    {
+      auto now = std::chrono::steady_clock::now();
+      auto readCount = mReadoutCount.load(std::memory_order_relaxed);
+
+      StatsSample sample;
+      sample.type = type;
+      sample.time = std::chrono::duration<double>(now - mRunTime.start).count();
+      sample.pushed = mPushCount.load(std::memory_order_relaxed) / mPagesPerSuperpage;
+      sample.read = readCount / mPagesPerSuperpage;
+
+      bool isSummary = (type == "summary");
+      auto periodStart = isSummary ? mRunTime.start : mLastStats.time;
+      auto periodPages = isSummary ? readCount : (readCount - mLastStats.readCount);
+      double seconds = std::chrono::duration<double>(now - periodStart).count();
+      if (seconds > 0) {
+        sample.gbps = double(periodPages) * mPageSize * 8 / (1000.0 * 1000.0 * 1000.0) / seconds;
+      }
+      mLastStats.time = now;
+      mLastStats.readCount = readCount;
+
+      if (!mOptions.noErrorCheck) {
+        sample.errors = mErrorCount.load();
+      }
+      if (!mOptions.noTemperature) {
+        if (auto temperature = mChannel->getTemperature()) {
+          sample.temperature = *temperature;
+        }
+      }
+      if (mStatsBar) {
+        sample.droppedPackets = mStatsBar->getDroppedPackets();
+      }
+      sample.readoutQueue = readoutQueueSize;
+      sample.freeQueue = freeQueueSize;
+      sample.pushToReadyP99 = mPushToReady.getPercentile(99) / 1000.0;
+      mStatsWriter->write(sample);
+    }
+
+    /// Reads out and checks the pages of a superpage
+    /// \return The time it took
+    std::chrono::steady_clock::duration readoutSuperpage(const ReadySuperpage& ready)
+    {
+      auto readoutStart = std::chrono::steady_clock::now();
+      auto offset = ready.offset;
+      if (mOptions.checksum) {
+        Superpage superpage(offset, mSuperpageSize);
+        superpage.setReceived(ready.received);
+        checksumSuperpage(superpage, reinterpret_cast<const void*>(mBufferBaseAddress));
+        auto checksumTime = std::chrono::steady_clock::now() - readoutStart;
+        mChecksumNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(checksumTime).count(),
+            std::memory_order_relaxed);
+        mChecksumBytes.fetch_add(ready.received, std::memory_order_relaxed);
+      }
+      int pages = mSuperpageSize / mPageSize;
+      for (int i = 0; i < pages; ++i) {
+        auto readoutCount = fetchAddReadoutCount();
+        readoutPage(mBufferBaseAddress + offset + i * mPageSize, mPageSize, readoutCount);
+      }
+      return std::chrono::steady_clock::now() - readoutStart;
+    }
+
+    /// Gets the link ID of a superpage from its first page, since a CRU superpage only holds pages of one link
+    uint32_t getSuperpageLinkId(const ReadySuperpage& ready)
+    {
+      if ((mCardType == CardType::Cru || mCardType == CardType::Dummy) && (ready.received != 0)) {
+        return Cru::DataFormat::getLinkId(reinterpret_cast<const char*>(mBufferBaseAddress + ready.offset));
+      }
+      return 0; // Use 0 for non-CRU cards
+    }
+
+    /// Writes a superpage to the DMA capture
+    void recordSuperpage(const ReadySuperpage& ready)
+    {
+      auto data = reinterpret_cast<const char*>(mBufferBaseAddress + ready.offset);
+      mCaptureWriter->write(data, ready.received, getSuperpageLinkId(ready), ready.arrival);
     }
 
     /// Atomically fetch and increment the readout count. We do this because it is accessed by multiple threads.
@@ -536,6 +1113,10 @@ class ProgramDmaBench: public Program
         for (int i = 0; i < size; ++i) {
           auto superpage = mChannel->popSuperpage();
           if (mOptions.loopbackModeString == "NONE") { //if it's ddg
+            if (mFileWriter) {
+              mFileWriter->write(reinterpret_cast<const void*>(mBufferBaseAddress + superpage.getOffset()),
+                  mSuperpageSize, superpage.getOffset());
+            }
             int pages = mSuperpageSize / mPageSize;
             for (int i = 0; i < pages; ++i) {
               auto readoutCount = fetchAddReadoutCount();
@@ -563,7 +1144,8 @@ class ProgramDmaBench: public Program
       switch (mCardType) {
         case CardType::Crorc:
           return get32bitFromPage(pageAddress, 0);
-        case CardType::Cru: {
+        case CardType::Cru:
+        case CardType::Dummy: {
           // Grab the first payload word as the counter's beginning
           auto payload = reinterpret_cast<const volatile uint32_t *>(pageAddress + headerSize);
           return payload[0];
@@ -582,7 +1164,7 @@ class ProgramDmaBench: public Program
 
         // Get link ID if needed
         uint32_t linkId = 0; // Use 0 for non-CRU cards
-        if (mCardType == CardType::Cru) {
+        if (mCardType == CardType::Cru || mCardType == CardType::Dummy) {
           linkId = Cru::DataFormat::getLinkId(reinterpret_cast<const char*>(pageAddress));
           if (linkId >= mDataGeneratorCounters.size()) {
             BOOST_THROW_EXCEPTION(Exception()
@@ -600,6 +1182,9 @@ class ProgramDmaBench: public Program
           case CardType::Cru:
             hasError = checkErrorsCru(pageAddress, pageSize, readoutCount, linkId, mOptions.loopbackModeString);
             break;
+          case CardType::Dummy:
+            hasError = checkErrorsDummy(pageAddress, pageSize, readoutCount, linkId);
+            break;
           default:
             throw std::runtime_error("Error checking unsupported for this card type");
         }
@@ -607,12 +1192,12 @@ class ProgramDmaBench: public Program
         if (hasError && !mOptions.noResyncCounter) {
           // There was an error, so we resync the counter on the next page
           mDataGeneratorCounters[linkId] = DATA_COUNTER_INITIAL_VALUE;
-          mPacketCounters[linkId] = PACKET_COUNTER_INITIAL_VALUE;
         }
       }
 
-      if (mOptions.pageReset) {
-        // Set the buffer to the default value after the readout
+      if (mOptions.pageReset && !mFileWriter) {
+        // Set the buffer to the default value after the readout. If the superpage is being written, it's reset when
+        // that's done.
         resetPage(pageAddress, pageSize);
       }
     }
@@ -637,133 +1222,118 @@ class ProgramDmaBench: public Program
       // Get dataCounter value only if page is valid...
       if (mDataGeneratorCounters[linkId] == DATA_COUNTER_INITIAL_VALUE) {
         auto dataCounter = getDataGeneratorCounterFromPage(pageAddress, 0x0); // no header!
-        mErrorStream << b::format("resync dataCounter for e:%d l:%d cnt:%x\n") % eventNumber % linkId % dataCounter;
+        addRecord(ErrorCategory::DataResync, eventNumber, linkId, dataCounter);
         mDataGeneratorCounters[linkId] = dataCounter;
       }
       
       const uint32_t dataCounter = mDataGeneratorCounters[linkId];
+      const auto payload = reinterpret_cast<const void*>(pageAddress);
+      const size_t words = pageSize / sizeof(uint32_t);
+      const auto pattern = PatternVerifier::makeCruInternalPattern(dataCounter);
+      bool foundError = checkPattern(payload, 0, words, pattern, eventNumber, linkId, dataCounter, pageSize);
 
-      bool foundError = false;
-      auto checkValue = [&](uint32_t i, uint32_t expectedValue, uint32_t actualValue) {
-        if (expectedValue != actualValue) {
-          foundError = true;
-          addError(eventNumber, linkId, i, dataCounter, expectedValue, actualValue, pageSize);
-        }
-      };
-
-      const auto payload = reinterpret_cast<const volatile uint32_t*> (pageAddress);
-
-      // Check iterating through 256-bit words
-      uint32_t offset = (dataCounter % (0x100000000)); // mod 0xffffffff + 1
-      uint32_t i = 0;
-
-      while ((i*4) < pageSize) { //this is indexing, it has nothing to do with iterating step
-        uint32_t word32 = i; // 32-bit word pointer
-
-        checkValue(word32 + 0, offset, payload[word32 + 0]); //32-bit counter
-        checkValue(word32 + 1, offset, payload[word32 + 1]); //32-bit counter
-        checkValue(word32 + 2, offset, payload[word32 + 2]); //32-bit counter 
-        checkValue(word32 + 3, offset, payload[word32 + 3]); //32-bit counter
-        checkValue(word32 + 4, offset, payload[word32 + 4]); //32-bit counter
-        checkValue(word32 + 5, offset, payload[word32 + 5]); //32-bit counter
-        checkValue(word32 + 6, offset, payload[word32 + 6]); //32-bit counter 
-        checkValue(word32 + 7, offset, payload[word32 + 7]); //32-bit counter 
+      // The counter is incremented every 256-bit word
+      mDataGeneratorCounters[linkId] = dataCounter + uint32_t((words + 7) / 8);
+      return foundError;
+    }
 
-        offset = (offset+1) % (0x100000000); //Increase dataCounter by 1 - mod 0xffffffff + 1
-        i += 8; // 8 = expected 2*sizeof(uint32_t);
+    /// Checks the data against a pattern, adding an error for every word that differs
+    /// \return True if an error was found
+    bool checkPattern(const void* data, size_t begin, size_t end, const PatternVerifier::LinearPattern& pattern,
+        int64_t eventNumber, int linkId, uint32_t generatorCounter, uint32_t payloadBytes)
+    {
+      bool foundError = false;
+      for (auto i = PatternVerifier::findMismatch(data, begin, end, pattern); i < end;
+          i = PatternVerifier::findMismatch(data, i + 1, end, pattern)) {
+        foundError = true;
+        addError(eventNumber, linkId, i, generatorCounter, pattern.getExpected(i), PatternVerifier::getWord(data, i),
+            payloadBytes);
       }
-      
-      mDataGeneratorCounters[linkId] = offset;
       return foundError;
     }
 
     bool checkErrorsCruDdg(uintptr_t pageAddress, size_t pageSize, int64_t eventNumber, int linkId)
     {
+      const auto page = reinterpret_cast<const char*>(pageAddress);
+      const auto headerSize = Cru::DataFormat::getHeaderSize();
       // Get memsize from the header
-      const auto memBytes = Cru::DataFormat::getEventSize(reinterpret_cast<const char*>(pageAddress)); // Memory size [RDH, Payload]
+      const auto memBytes = Cru::DataFormat::getEventSize(page); // Memory size [RDH, Payload]
 
-      if (memBytes < 40 || memBytes > pageSize) {
+      if (memBytes < headerSize || memBytes > pageSize) {
         // Report RDH error
         mErrorCount++;
-        if (mErrorCount < MAX_RECORDED_ERRORS) {
-          mErrorStream << b::format("[RDHERR]\tevent:%1% l:%2% payloadBytes:%3% size:%4% words out of range\n") % eventNumber
-            % linkId % memBytes % pageSize;
-        }
+        addRecord(ErrorCategory::RdhSize, eventNumber, linkId, 0, 0, 0, 0, memBytes, pageSize);
         return true;
       }
 
-      // check link's packet counter here
-      const auto packetCounter = Cru::DataFormat::getPacketCounter(reinterpret_cast<const char*>(pageAddress));
-
-      if (mPacketCounters[linkId] == PACKET_COUNTER_INITIAL_VALUE) {
-        mErrorStream << b::format("resync packet counter for e:%d l:%d packet_cnt:%x mpacket_cnt:%x\n") % eventNumber % linkId % packetCounter % 
-          mPacketCounters[linkId];
-        mPacketCounters[linkId] = packetCounter;
-      } else if (((mPacketCounters[linkId] + 1) % 0x100) != packetCounter) { //packetCounter is 8bits long
-        // log packet counter error
+      Packet packet;
+      packet.header = page;
+      packet.payload = page + headerSize;
+      packet.payloadSize = memBytes - headerSize;
+
+      // The integrity checker applies the packet and data counter rules, here we only journal the details
+      const auto lastPacketCounter = mIntegrityChecker->getLastPacketCounter(linkId);
+      const auto expectedDataCounter = mIntegrityChecker->getExpectedDataCounter(linkId);
+      const auto before = mIntegrityChecker->getCounters(linkId);
+      const bool foundError = mIntegrityChecker->check(packet);
+      const auto after = mIntegrityChecker->getCounters(linkId);
+
+      const auto packetCounter = Cru::DataFormat::getPacketCounter(page);
+      if (!lastPacketCounter) {
+        addRecord(ErrorCategory::PacketResync, eventNumber, linkId, 0, 0, PACKET_COUNTER_INITIAL_VALUE, packetCounter);
+      } else if ((after.gaps != before.gaps) || (after.duplicates != before.duplicates)) {
         mErrorCount++;
-        if (mErrorCount < MAX_RECORDED_ERRORS) {
-          mErrorStream << b::format("[RDHERR]\tevent:%1% l:%2% payloadBytes:%3% size:%4% packet_cnt:%5% mpacket_cnt:%6% unexpected packet counter\n")
-            % eventNumber % linkId % memBytes % pageSize % packetCounter % mPacketCounters[linkId];
-        }
+        addRecord(ErrorCategory::PacketCounter, eventNumber, linkId, 0, 0, *lastPacketCounter, packetCounter,
+            memBytes, pageSize);
+        // The data counter is taken from this packet, so there's nothing more to say about it
         return true;
-      } else {
-        //mErrorStream << b::format("packet_cnt:%x mpacket_cnt:%x\n") % packetCounter % mPacketCounters[linkId];
-        mPacketCounters[linkId] = packetCounter; // same as = (mPacketCounters + 1) % 0x100
       }
 
-      // Get counter value only if page is valid...
-      const auto dataCounter = getDataGeneratorCounterFromPage(pageAddress, Cru::DataFormat::getHeaderSize());
-      if (mDataGeneratorCounters[linkId] == DATA_COUNTER_INITIAL_VALUE) {
-        mErrorStream << b::format("resync counter for e:%d l:%d cnt:%x\n") % eventNumber % linkId % dataCounter;
-        mDataGeneratorCounters[linkId] = dataCounter;
+      if (!expectedDataCounter) {
+        addRecord(ErrorCategory::DataResync, eventNumber, linkId, PatternVerifier::getWord(packet.payload, 0));
+      } else if (after.payloadErrors != before.payloadErrors) {
+        // ddg pattern
+        // Every 256-bit word is built as follows:
+        // 32 bits counter       + 32 bits counter       + 16 lsb counter       + 32 bit 0
+        // 32 bits (counter + 1) + 32 bits (counter + 1) + 16 lsb (counter + 1) + 32 bit 0
+        const size_t words = packet.payloadSize / sizeof(uint32_t);
+        const auto pattern = PatternVerifier::makeDdgPattern(*expectedDataCounter);
+        checkPattern(packet.payload, 0, words, pattern, eventNumber, linkId, *expectedDataCounter,
+            packet.payloadSize);
+      } else if (foundError) {
+        // A size mismatch or an RDH anomaly
+        mErrorCount++;
+        addRecord(ErrorCategory::RdhSize, eventNumber, linkId, 0, 0, 0, 0, memBytes, pageSize);
       }
-      //const uint32_t dataCounter = mDataGeneratorCounters[linkId];
-
-      //skip the header -> address + 0x40
-      const auto payload = reinterpret_cast<const volatile uint32_t*>(pageAddress + Cru::DataFormat::getHeaderSize()); 
-      const auto payloadBytes = memBytes - Cru::DataFormat::getHeaderSize();
-      
-      bool foundError = false;
-      auto checkValue = [&](uint32_t i, uint32_t expectedValue, uint32_t actualValue) {
-        if (expectedValue != actualValue) {
-          foundError = true;
-          addError(eventNumber, linkId, i, dataCounter, expectedValue, actualValue, payloadBytes);
-        }
-      };
-
-      // Check iterating through 256-bit words
-      uint32_t offset = (dataCounter % (0x100000000)); // mod 0xffffffff + 1
-      uint32_t i = 0;
-
-      // ddg pattern
-      // Every 256-bit word is built as follows:
-      // 32 bits counter       + 32 bits counter       + 16 lsb counter       + 32 bit 0
-      // 32 bits (counter + 1) + 32 bits (counter + 1) + 16 lsb (counter + 1) + 32 bit 0
+      return foundError;
+    }
 
-      while ((i*4) < payloadBytes) {
-        uint32_t word32 = i; // 32-bit word pointer
+    bool checkErrorsDummy(uintptr_t pageAddress, size_t pageSize, int64_t eventNumber, int linkId)
+    {
+      // The dummy card's data generator emulates the CRU's DDG
+      if (mOptions.generatorPattern == GeneratorPattern::Incremental) {
+        return checkErrorsCruDdg(pageAddress, pageSize, eventNumber, linkId);
+      }
 
-        checkValue(word32 + 0, offset         , payload[word32 + 0]); //32-bit counter
-        checkValue(word32 + 1, offset         , payload[word32 + 1]); //32-bit counter
-        checkValue(word32 + 2, offset & 0xffff, payload[word32 + 2]); //16-lsb truncated counter 
-        checkValue(word32 + 3, 0x0            , payload[word32 + 3]); //32-bit 0-padding word
+      BOOST_THROW_EXCEPTION(Exception()
+          << ErrorInfo::Message("Unsupported pattern for dummy error checking")
+          << ErrorInfo::GeneratorPattern(mOptions.generatorPattern));
+    }
 
-        offset = (offset+1) % (0x100000000); //Increase counter by 1 - mod 0xffffffff + 1
-        i += 4; // 4 = expected sizeof(uint32_t);
-      }
-      mDataGeneratorCounters[linkId] = offset;
-      return foundError;
+    /// Adds a record to the error journal. Formatting is left to the journal's thread, so this is cheap enough for the
+    /// readout threads.
+    void addRecord(ErrorCategory category, int64_t eventNumber, uint32_t linkId, uint32_t counter, uint32_t index = 0,
+        uint32_t expected = 0, uint32_t actual = 0, uint32_t size = 0, uint32_t pageSize = 0)
+    {
+      mErrorJournal.add(ErrorRecord{eventNumber, category, linkId, index, counter, expected, actual, size, pageSize});
     }
 
     void addError(int64_t eventNumber, int linkId, int index, uint32_t generatorCounter, uint32_t expectedValue,
         uint32_t actualValue, uint32_t payloadBytes)
     {
       mErrorCount++;
-       if (mErrorCount < MAX_RECORDED_ERRORS) {
-         mErrorStream << b::format("[ERROR]\tevent:%d link:%d cnt:%x payloadBytes:%d i:%d exp:%x val:%x\n")
-             % eventNumber % linkId % generatorCounter % payloadBytes % index % expectedValue % actualValue;
-       }
+      addRecord(ErrorCategory::DataMismatch, eventNumber, linkId, generatorCounter, index, expectedValue, actualValue,
+          payloadBytes);
     }
 
     bool checkErrorsCrorc(uintptr_t pageAddress, size_t pageSize, int64_t eventNumber, int linkId)
@@ -771,33 +1341,30 @@ class ProgramDmaBench: public Program
       uint64_t counter = mDataGeneratorCounters[linkId];
       mDataGeneratorCounters[linkId]++;
 
-      auto check = [&](auto patternFunction) {
-        auto page = reinterpret_cast<const volatile uint32_t*>(pageAddress);
-        auto pageSize32 = pageSize / sizeof(int32_t);
+      auto page = reinterpret_cast<const void*>(pageAddress);
+      auto pageSize32 = pageSize / sizeof(int32_t);
 
-        if (page[0] != counter) {
-          addError(eventNumber, linkId, 0, counter, counter, page[0], 0);
-        }
+      if (PatternVerifier::getWord(page, 0) != counter) {
+        addError(eventNumber, linkId, 0, counter, counter, PatternVerifier::getWord(page, 0), 0);
+      }
 
-        // We skip the SDH
-        for (uint32_t i = 8; i < pageSize32; ++i) {
-          uint32_t expectedValue = patternFunction(i);
-          uint32_t actualValue = page[i];
-          if (actualValue != expectedValue) {
-            addError(eventNumber, linkId, i, counter, expectedValue, actualValue, 0);
-            return true;
-          }
+      // We skip the SDH, and only report the first error
+      auto check = [&](const PatternVerifier::LinearPattern& pattern) {
+        auto i = PatternVerifier::findMismatch(page, 8, pageSize32, pattern);
+        if (i < pageSize32) {
+          addError(eventNumber, linkId, i, counter, pattern.getExpected(i), PatternVerifier::getWord(page, i), 0);
+          return true;
         }
         return false;
       };
 
       switch (mOptions.generatorPattern) {
         case GeneratorPattern::Incremental:
-          return check([&](uint32_t i) {return i - 1;});
+          return check(PatternVerifier::makeWordCounterPattern(uint32_t(-1))); // Word i holds i - 1
         case GeneratorPattern::Alternating:
-          return check([&](uint32_t) {return 0xa5a5a5a5;});
+          return check(PatternVerifier::makeConstantPattern(0xa5a5a5a5));
         case GeneratorPattern::Constant:
-          return check([&](uint32_t) {return 0x12345678;});
+          return check(PatternVerifier::makeConstantPattern(0x12345678));
         default: ;
       }
 
@@ -839,7 +1406,7 @@ class ProgramDmaBench: public Program
        double Gbps = Gb / runTime;
        format % Gbps;
        
-       mOptions.noErrorCheck ? format % "n/a" : format % mErrorCount; // Errors
+       mOptions.noErrorCheck ? format % "n/a" : format % mErrorCount.load(); // Errors
 
        if (mOptions.noTemperature) {
          format % "n/a";
@@ -852,6 +1419,10 @@ class ProgramDmaBench: public Program
        }
 
        cout << '\r' << format;
+       if (mOptions.displayLatency) {
+         cout << b::format(PROGRESS_FORMAT_LATENCY) % (mPushToReady.getPercentile(99) / 1000.0)
+           % (mPushToReady.getMax() / 1000.0);
+       }
 
        // This takes care of adding a "line" to the stdout every so many seconds
        {
@@ -872,6 +1443,9 @@ class ProgramDmaBench: public Program
        auto line1 = b::format(PROGRESS_FORMAT_HEADER) % "Time" % "Pushed" % "Read" % "Throughput (Gbps)" % "Errors" % "°C";
        auto line2 = b::format(PROGRESS_FORMAT) % "00" % "00" % "00" % '-' % '-' % '-' % '-' % '-';
        cout << '\n' << line1;
+       if (mOptions.displayLatency) {
+         cout << b::format(PROGRESS_FORMAT_LATENCY_HEADER) % "p99 ready (us)" % "Max ready (us)";
+       }
        cout << '\n' << line2;
      }
 
@@ -888,6 +1462,9 @@ class ProgramDmaBench: public Program
 
        auto put = [&](auto label, auto value) { cout << b::format("  %-24s  %-10s\n") % label % value; };
        cout << '\n';
+       if (!mLabel.empty()) {
+         put("Channel", mLabel);
+       }
        put("Seconds", runTime);
        put("Superpages", mReadoutCount.load()/mPagesPerSuperpage);
        put("Superpage Latency(s)", runTime/(mReadoutCount.load()/mPagesPerSuperpage));
@@ -902,8 +1479,41 @@ class ProgramDmaBench: public Program
          if (mOptions.noErrorCheck) {
            put("Errors", "n/a");
          } else {
-           put("Errors", mErrorCount);
+           put("Errors", mErrorCount.load());
+           put("Errors/GB", mErrorCount.load() / GB);
+         }
+
+         // Throughput of the readout thread alone, which shows how much the error checking slows down on faults
+         double readoutTime = std::chrono::duration<double>(mReadoutTime).count();
+         if (readoutTime > 0) {
+           put("Readout GB/s", GB / readoutTime);
+         }
+         // Throughput of a single thread computing checksums
+         if (mOptions.checksum && mChecksumNanoseconds.load() > 0) {
+           put("Checksum GB/s", double(mChecksumBytes.load()) / double(mChecksumNanoseconds.load()));
          }
+         if (!mOptions.generatorFaultsString.empty()) {
+           put("Faults", mOptions.generatorFaultsString);
+         }
+       }
+
+       // Superpage latencies in microseconds
+       auto putLatency = [&](auto label, const LatencyHistogram& histogram) {
+         if (histogram.getCount() != 0) {
+           put(label, b::format("p50 %.1f  p99 %.1f  p99.9 %.1f  max %.1f") % (histogram.getPercentile(50) / 1000.0)
+               % (histogram.getPercentile(99) / 1000.0) % (histogram.getPercentile(99.9) / 1000.0)
+               % (histogram.getMax() / 1000.0));
+         }
+       };
+       putLatency("Push to ready (us)", mPushToReady);
+       putLatency("Ready to pop (us)", mReadyToPop);
+       putLatency("Pop to release (us)", mPopToRelease);
+
+       if (mFileWriter) {
+         put("Write GB/s", mFileWriter->getThroughput() / (1000 * 1000 * 1000));
+         put("Write queue max", mFileWriter->getMaxDepth());
+         put("Write stall (s)", std::chrono::duration<double>(mFileWriter->getStallTime()).count());
+         put("Write O_DIRECT", mFileWriter->isDirect() ? "yes" : "no");
        }
 
        if (mOptions.barHammer) {
@@ -923,17 +1533,25 @@ class ProgramDmaBench: public Program
 
     void outputErrors()
     {
-      auto errorStr = mErrorStream.str();
+      mErrorJournal.stop();
 
-      if (!errorStr.empty()) {
-        getLogger() << "Outputting " << std::min(mErrorCount, MAX_RECORDED_ERRORS) << " errors to '"
-          << READOUT_ERRORS_PATH << "'" << endm;
-        std::ofstream stream(READOUT_ERRORS_PATH);
-        stream << errorStr;
+      if (mErrorJournal.getWritten() != 0) {
+        getLogger() << "Wrote " << mErrorJournal.getWritten() << " error records to '" << mErrorsPath << "'"
+          << endm;
+        if (mErrorJournal.getDropped() != 0) {
+          getLogger() << "Dropped " << mErrorJournal.getDropped() << " error records, the journal was full" << endm;
+        }
+        for (size_t i = 0; i < ERROR_CATEGORIES; ++i) {
+          auto category = ErrorCategory(i);
+          if (auto count = mErrorJournal.getCount(category)) {
+            getLogger() << "  " << ErrorJournal::getCategoryName(category) << ": " << count << endm;
+          }
+        }
       }
     }
 
-    /// Prints the page to a file in ASCII or binary format if such output is enabled
+    /// Prints the page to a file in ASCII format if such output is enabled. Binary output is written per superpage by
+    /// the SuperpageWriter.
     void printToFile(uintptr_t pageAddress, size_t pageSize, int64_t pageNumber)
     {
       auto page = reinterpret_cast<const volatile uint32_t*>(pageAddress);
@@ -950,9 +1568,6 @@ class ProgramDmaBench: public Program
           mReadoutStream << '\n';
         }
         mReadoutStream << '\n';
-      } else if (mOptions.fileOutputBin) {
-        // TODO Is there a more elegant way to write from volatile memory?
-        mReadoutStream.write(reinterpret_cast<const char*>(pageAddress), pageSize);
       }
     }
 
@@ -1032,14 +1647,29 @@ class ProgramDmaBench: public Program
         std::string readoutModeString;
         std::string fileOutputPathBin;
         std::string fileOutputPathAscii;
+        std::string recordPath;
+        std::string replayPath;
+        bool replayNoPacing = false;
+        size_t readoutThreads = 1;
+        size_t writeQueue = 64;
+        size_t writeThreads = 1;
+        bool checksum = false;
+        bool displayLatency = false;
+        std::string outputFormat;
+        std::string outputPath;
+        size_t outputPeriod = 1000;
         GeneratorPattern::type generatorPattern = GeneratorPattern::Incremental;
         b::optional<ReadoutMode::type> readoutMode;
         std::string links;
         bool generatorEnabled = false;
         size_t dataGeneratorSize;
+        size_t generatorRate;
+        std::string generatorFaultsString;
+        uint64_t generatorStallTime;
         size_t dmaPageSize;
         std::string loopbackModeString;
         std::string timeLimitString;
+        std::string channelsString;
         uint64_t pausePush;
         uint64_t pauseRead;
     } mOptions;
@@ -1053,8 +1683,8 @@ class ProgramDmaBench: public Program
     /// Page counters per link. Indexed by link ID.
     std::array<std::atomic<uint32_t>, MAX_LINKS> mDataGeneratorCounters;
 
-    // Packet counter per link
-    std::array<std::atomic<uint32_t>, MAX_LINKS> mPacketCounters;
+    /// Checks the packet and data counters of CRU-format DDG data
+    std::unique_ptr<LinkIntegrityChecker> mIntegrityChecker;
 
     // Keep these as DMA page counters for better granularity
     /// Amount of DMA pages pushed
@@ -1064,7 +1694,21 @@ class ProgramDmaBench: public Program
     std::atomic<uint64_t> mReadoutCount { 0 };
 
     /// Total amount of errors encountered
-    int64_t mErrorCount = 0;
+    std::atomic<int64_t> mErrorCount { 0 };
+
+    /// Time the readout thread spent reading out and checking superpages
+    std::chrono::steady_clock::duration mReadoutTime {0};
+
+    /// Amount of data and time spent computing superpage checksums, over all readout threads
+    std::atomic<uint64_t> mChecksumBytes {0};
+    std::atomic<uint64_t> mChecksumNanoseconds {0};
+
+    /// Latency from pushing a superpage to the driver until it's ready, as seen by the push thread
+    LatencyHistogram mPushToReady;
+    /// Latency from a superpage being ready until the readout thread takes it
+    LatencyHistogram mReadyToPop;
+    /// Latency from the readout thread taking a superpage until it's read out and free again
+    LatencyHistogram mPopToRelease;
 
     /// Keep on pushing until we're explicitly stopped
     bool mInfinitePages = false;
@@ -1096,11 +1740,46 @@ class ProgramDmaBench: public Program
     /// Object for BAR throughput testing
     std::unique_ptr<BarHammer> mBarHammer;
 
-    /// Stream for file readout, only opened if enabled by the --file program options
+    /// Stream for file readout, only opened if enabled by the --to-file-ascii program option
     std::ofstream mReadoutStream;
 
-    /// Stream for error output
-    std::ostringstream mErrorStream;
+    /// Writer of the superpages, only created if enabled by the --to-file-bin program option
+    std::unique_ptr<SuperpageWriter> mFileWriter;
+
+    /// Stream and writer of the machine-readable statistics, only opened if enabled by --output-format
+    std::ofstream mStatsStream;
+    std::unique_ptr<StatsWriter> mStatsWriter;
+
+    /// BAR to read the dropped packets from for the statistics
+    std::shared_ptr<BarInterface> mStatsBar;
+
+    /// Time and readout count of the previous statistics sample
+    struct
+    {
+        TimePoint time;
+        uint64_t readCount = 0;
+    } mLastStats;
+
+    /// Writer of the DMA capture, only created if enabled by the --record program option
+    std::unique_ptr<DmaCaptureWriter> mCaptureWriter;
+
+    /// Error records of the readout threads, written to READOUT_ERRORS_PATH in the background
+    ErrorJournal mErrorJournal {ERROR_JOURNAL_CAPACITY, MAX_RECORDED_ERRORS, MAX_LINKS};
+
+    /// Path of the error records
+    std::string mErrorsPath = READOUT_ERRORS_PATH;
+
+    /// Card ID and DMA channel, only set in multi-channel mode (--channels)
+    std::string mLabel;
+
+    /// In multi-channel mode, raised when another channel failed
+    const std::atomic<bool>* mStopAll = nullptr;
+
+    /// In multi-channel mode, the CPUs of the NUMA node of the card, and the cores the push and readout threads are
+    /// pinned to
+    std::vector<int> mNodeCpus;
+    boost::optional<int> mPushCpu;
+    boost::optional<int> mReadoutCpu;
 
     /// Was the header printed?
     bool mHeaderPrinted = false;
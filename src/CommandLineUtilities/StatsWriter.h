@@ -0,0 +1,110 @@
+/// \file StatsWriter.h
+/// \brief Definition of the StatsWriter class.
+
+#ifndef ALICEO2_READOUTCARD_STATSWRITER_H
+#define ALICEO2_READOUTCARD_STATSWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <boost/optional.hpp>
+#include "ExceptionInternal.h"
+
+namespace AliceO2 {
+namespace roc {
+namespace CommandLineUtilities {
+
+/// Statistics of a benchmark at one point in time
+struct StatsSample
+{
+    /// "sample" for the periodic samples, "summary" for the end of the run
+    std::string type;
+    /// Seconds since the start of the run
+    double time = 0;
+    /// Superpages pushed and read out since the start
+    uint64_t pushed = 0;
+    uint64_t read = 0;
+    /// Readout throughput in Gb/s, over the period since the previous sample, or the whole run for the summary
+    double gbps = 0;
+    /// Errors since the start, if error checking is enabled
+    boost::optional<int64_t> errors;
+    boost::optional<float> temperature;
+    /// Packets dropped by the card, if it reports them
+    boost::optional<int32_t> droppedPackets;
+    /// Superpages waiting to be read out
+    size_t readoutQueue = 0;
+    /// Superpages waiting to be pushed
+    size_t freeQueue = 0;
+    /// 99th percentile of the push-to-ready latency of the superpages in microseconds
+    double pushToReadyP99 = 0;
+};
+
+/// Writes benchmark statistics in a machine-readable format, one line per sample.
+///
+/// JSON is written as JSON Lines: one object per line, with null for unavailable values. CSV starts with a header line,
+/// and leaves unavailable values empty.
+class StatsWriter
+{
+  public:
+    enum class Format
+    {
+      Json,
+      Csv
+    };
+
+    /// \throw ParameterException If the format is not "json" or "csv"
+    static Format parseFormat(const std::string& string)
+    {
+      if (string == "json") {
+        return Format::Json;
+      } else if (string == "csv") {
+        return Format::Csv;
+      }
+      BOOST_THROW_EXCEPTION(ParameterException()
+          << ErrorInfo::Message("Unknown output format '" + string + "', expected 'json' or 'csv'"));
+    }
+
+    StatsWriter(std::ostream& stream, Format format) : mStream(stream), mFormat(format)
+    {
+      if (mFormat == Format::Csv) {
+        mStream << "type,time,pushed,read,gbps,errors,temperature,dropped_packets,readout_queue,free_queue,"
+            "push_to_ready_p99_us\n";
+      }
+    }
+
+    void write(const StatsSample& s)
+    {
+      if (mFormat == Format::Json) {
+        mStream << "{\"type\":\"" << s.type << "\",\"time\":" << s.time << ",\"pushed\":" << s.pushed
+            << ",\"read\":" << s.read << ",\"gbps\":" << s.gbps << ",\"errors\":" << optional(s.errors, "null")
+            << ",\"temperature\":" << optional(s.temperature, "null")
+            << ",\"dropped_packets\":" << optional(s.droppedPackets, "null")
+            << ",\"readout_queue\":" << s.readoutQueue << ",\"free_queue\":" << s.freeQueue
+            << ",\"push_to_ready_p99_us\":" << s.pushToReadyP99 << "}\n";
+      } else {
+        mStream << s.type << ',' << s.time << ',' << s.pushed << ',' << s.read << ',' << s.gbps << ','
+            << optional(s.errors, "") << ',' << optional(s.temperature, "") << ','
+            << optional(s.droppedPackets, "") << ',' << s.readoutQueue << ',' << s.freeQueue << ','
+            << s.pushToReadyP99 << '\n';
+      }
+      // Flush, so the samples can be followed while the benchmark runs
+      mStream.flush();
+    }
+
+  private:
+    template <typename T>
+    static std::string optional(const boost::optional<T>& value, const std::string& none)
+    {
+      return value ? std::to_string(*value) : none;
+    }
+
+    std::ostream& mStream;
+    const Format mFormat;
+};
+
+} // namespace CommandLineUtilities
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_READOUTCARD_STATSWRITER_H
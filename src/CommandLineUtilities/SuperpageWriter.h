@@ -0,0 +1,278 @@
+/// \file SuperpageWriter.h
+/// \brief Definition of the SuperpageWriter class.
+
+#ifndef ALICEO2_READOUTCARD_SUPERPAGEWRITER_H
+#define ALICEO2_READOUTCARD_SUPERPAGEWRITER_H
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ExceptionInternal.h"
+
+namespace AliceO2 {
+namespace roc {
+namespace CommandLineUtilities {
+
+/// Writes superpages to a file from a pool of I/O threads, so the readout thread doesn't wait for the storage.
+///
+/// The superpages are written in place with O_DIRECT, bypassing the page cache, at the file offset given by the order
+/// they were queued in, so the threads can write them in parallel. A superpage is only handed back once it's written,
+/// so its memory can't be reused too early. The queue is bounded: when the storage can't keep up, write() blocks, which
+/// holds up the readout, and the time it blocked is reported.
+///
+/// If the file system doesn't support O_DIRECT, like tmpfs, the file is written through the page cache instead.
+class SuperpageWriter
+{
+  public:
+    /// Alignment of the addresses and sizes of O_DIRECT writes
+    static constexpr size_t ALIGNMENT = 4096;
+
+    /// \param path File to write to. It's truncated if it exists.
+    /// \param capacity Maximum number of superpages being written or waiting to be written
+    /// \param threads Number of I/O threads
+    /// \param direct Use O_DIRECT if the file system supports it. The superpages must then be aligned to ALIGNMENT.
+    SuperpageWriter(const std::string& path, size_t capacity, size_t threads, bool direct = true)
+      : mCapacity(std::max<size_t>(capacity, 1))
+    {
+      int flags = O_WRONLY | O_CREAT | O_TRUNC;
+      mDirect = direct;
+      mFile = direct ? ::open(path.c_str(), flags | O_DIRECT, 0644) : -1;
+      if (mFile == -1 && (!direct || errno == EINVAL)) {
+        mDirect = false;
+        mFile = ::open(path.c_str(), flags, 0644);
+      }
+      if (mFile == -1) {
+        BOOST_THROW_EXCEPTION(Exception()
+            << ErrorInfo::Message("Failed to open file '" + path + "': " + std::strerror(errno)));
+      }
+
+      for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i) {
+        mThreads.emplace_back([&]{ writeLoop(); });
+      }
+    }
+
+    ~SuperpageWriter()
+    {
+      try {
+        close();
+      }
+      catch (const std::exception&) {
+        // Nothing to be done about it here
+      }
+    }
+
+    /// Queues a superpage to be written after the previous one. Blocks while the queue is full.
+    /// \param data Superpage data. It must stay valid until its tag is returned by popDone().
+    /// \param size Size in bytes
+    /// \param tag Identifies the superpage in popDone(), e.g. its offset in the DMA buffer
+    /// \throw Exception If an earlier write failed
+    void write(const void* data, size_t size, size_t tag)
+    {
+      if (mDirect && ((reinterpret_cast<uintptr_t>(data) % ALIGNMENT) != 0 || (size % ALIGNMENT) != 0)) {
+        BOOST_THROW_EXCEPTION(ParameterException()
+            << ErrorInfo::Message("Superpage not aligned for O_DIRECT writes")
+            << ErrorInfo::SuperpageSize(size));
+      }
+
+      std::unique_lock<std::mutex> lock(mMutex);
+      if (mDepth >= mCapacity) {
+        auto stallStart = std::chrono::steady_clock::now();
+        mNotFull.wait(lock, [&]{ return mDepth < mCapacity || mError; });
+        mStallTime += std::chrono::steady_clock::now() - stallStart;
+      }
+      throwIfFailed();
+      if (mFileOffset == 0) {
+        mStart = std::chrono::steady_clock::now();
+      }
+      mQueue.push_back(Job{data, size, tag, mFileOffset});
+      mFileOffset += size;
+      mDepth++;
+      mMaxDepth = std::max(mMaxDepth, mDepth);
+      mNotEmpty.notify_one();
+    }
+
+    /// Gets the tag of a superpage that was written
+    /// \return False if there was none
+    bool popDone(size_t& tag)
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (mDone.empty()) {
+        return false;
+      }
+      tag = mDone.front();
+      mDone.pop_front();
+      return true;
+    }
+
+    /// Waits until all queued superpages are written, and closes the file
+    /// \throw Exception If a write failed
+    void close()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mClosing = true;
+      }
+      mNotEmpty.notify_all();
+      for (auto& thread : mThreads) {
+        thread.join();
+      }
+      mThreads.clear();
+      if (mFile != -1) {
+        ::close(mFile);
+        mFile = -1;
+        mEnd = std::chrono::steady_clock::now();
+      }
+      std::lock_guard<std::mutex> lock(mMutex);
+      throwIfFailed();
+    }
+
+    /// Is the file written with O_DIRECT?
+    bool isDirect() const
+    {
+      return mDirect;
+    }
+
+    uint64_t getBytesWritten() const
+    {
+      return mBytesWritten.load(std::memory_order_relaxed);
+    }
+
+    /// Gets the number of superpages being written or waiting to be written
+    size_t getDepth()
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      return mDepth;
+    }
+
+    size_t getMaxDepth()
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      return mMaxDepth;
+    }
+
+    /// Gets the time write() blocked because the queue was full
+    std::chrono::steady_clock::duration getStallTime()
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      return mStallTime;
+    }
+
+    /// Gets the write throughput in bytes per second, from the first write until now, or until the file was closed
+    double getThroughput() const
+    {
+      auto end = (mFile == -1) ? mEnd : std::chrono::steady_clock::now();
+      double seconds = std::chrono::duration<double>(end - mStart).count();
+      return seconds > 0 ? double(getBytesWritten()) / seconds : 0;
+    }
+
+  private:
+    struct Job
+    {
+        const void* data;
+        size_t size;
+        size_t tag;
+        off_t fileOffset;
+    };
+
+    void writeLoop()
+    {
+      while (true) {
+        Job job;
+        {
+          std::unique_lock<std::mutex> lock(mMutex);
+          mNotEmpty.wait(lock, [&]{ return !mQueue.empty() || mClosing || mError; });
+          if (mQueue.empty() || mError) {
+            return;
+          }
+          job = mQueue.front();
+          mQueue.pop_front();
+        }
+
+        try {
+          writeJob(job);
+        }
+        catch (const std::exception&) {
+          std::lock_guard<std::mutex> lock(mMutex);
+          mError = std::current_exception();
+          mNotFull.notify_all();
+          mNotEmpty.notify_all();
+          return;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mDone.push_back(job.tag);
+        mDepth--;
+        mNotFull.notify_one();
+      }
+    }
+
+    void writeJob(const Job& job)
+    {
+      auto data = reinterpret_cast<const char*>(job.data);
+      size_t written = 0;
+      while (written < job.size) {
+        auto result = ::pwrite(mFile, data + written, job.size - written, job.fileOffset + off_t(written));
+        if (result == -1) {
+          if (errno == EINTR) {
+            continue;
+          }
+          BOOST_THROW_EXCEPTION(Exception()
+              << ErrorInfo::Message(std::string("Failed to write superpage: ") + std::strerror(errno))
+              << ErrorInfo::Offset(job.fileOffset + written));
+        }
+        written += size_t(result);
+      }
+      mBytesWritten.fetch_add(job.size, std::memory_order_relaxed);
+    }
+
+    /// Must be called with the mutex held
+    void throwIfFailed()
+    {
+      if (mError) {
+        std::rethrow_exception(mError);
+      }
+    }
+
+    const size_t mCapacity;
+    bool mDirect = false;
+    int mFile = -1;
+    std::vector<std::thread> mThreads;
+
+    std::mutex mMutex;
+    std::condition_variable mNotEmpty;
+    std::condition_variable mNotFull;
+    /// Superpages waiting for an I/O thread
+    std::deque<Job> mQueue;
+    /// Tags of superpages that were written
+    std::deque<size_t> mDone;
+    /// Superpages waiting or being written
+    size_t mDepth = 0;
+    size_t mMaxDepth = 0;
+    /// File offset of the next superpage
+    off_t mFileOffset = 0;
+    bool mClosing = false;
+    std::exception_ptr mError;
+    std::chrono::steady_clock::duration mStallTime {0};
+
+    std::atomic<uint64_t> mBytesWritten {0};
+    std::chrono::steady_clock::time_point mStart;
+    std::chrono::steady_clock::time_point mEnd;
+};
+
+} // namespace CommandLineUtilities
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_READOUTCARD_SUPERPAGEWRITER_H
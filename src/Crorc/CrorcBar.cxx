@@ -10,7 +10,12 @@ namespace AliceO2 {
 namespace roc {
 
 CrorcBar::CrorcBar(const Parameters& parameters)
-    : BarInterfaceBase(parameters)
+    : CrorcBar(parameters, nullptr)
+{
+}
+
+CrorcBar::CrorcBar(const Parameters& parameters, std::shared_ptr<Pda::PdaBar> bar)
+    : BarInterfaceBase(parameters, bar)
 {
 }
 
@@ -19,6 +19,9 @@ class CrorcBar final : public BarInterfaceBase
 {
   public:
     CrorcBar(const Parameters& parameters);
+
+    /// Constructor for a CrorcBar on top of the given BAR, for example an emulated one
+    CrorcBar(const Parameters& parameters, std::shared_ptr<Pda::PdaBar> bar);
     virtual ~CrorcBar();
     //virtual void checkReadSafe(int index) override;
     //virtual void checkWriteSafe(int index, uint32_t value) override;
@@ -0,0 +1,303 @@
+/// \file CrorcBarEmulator.cxx
+/// \brief Implementation of the CrorcBarEmulator class.
+
+#include "CrorcBarEmulator.h"
+#include <algorithm>
+#include <map>
+#include "Crorc/Constants.h"
+#include "Crorc/ReadyFifo.h"
+#include "ExceptionInternal.h"
+#include "ReadoutCard/ParameterTypes/GeneratorPattern.h"
+#include "Utilities/Util.h"
+
+namespace AliceO2 {
+namespace roc {
+namespace {
+/// Maximum amount of pages filled before the lock is released, so register accesses don't have to wait too long
+constexpr int PAGES_PER_ITERATION = 16;
+/// Pause of the firmware thread if no work could be done
+constexpr auto IDLE_PAUSE = std::chrono::microseconds(10);
+/// Firmware ID register value. The 0x2 in bits 24 to 31 is checked by CrorcBar::getFirmwareInfo().
+constexpr uint32_t FIRMWARE_ID = 0x02000000;
+/// C_DG4 value for an infinite amount of events
+constexpr uint32_t GENERATOR_INFINITE = 0x80000000;
+} // Anonymous namespace
+
+std::shared_ptr<CrorcBarEmulator> CrorcBarEmulator::getInstance(int barIndex)
+{
+  static std::mutex mutex;
+  static std::map<int, std::weak_ptr<CrorcBarEmulator>> instances;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto bar = instances[barIndex].lock();
+  if (!bar) {
+    bar = std::make_shared<CrorcBarEmulator>(barIndex);
+    instances[barIndex] = bar;
+  }
+  return bar;
+}
+
+CrorcBarEmulator::CrorcBarEmulator(int barIndex) : mBarIndex(barIndex)
+{
+  mRegisters[Rorc::RFID] = FIRMWARE_ID;
+}
+
+CrorcBarEmulator::~CrorcBarEmulator()
+{
+  mStopFlag = true;
+  if (mThread.joinable()) {
+    mThread.join();
+  }
+}
+
+void CrorcBarEmulator::setRate(size_t bytesPerSecond)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mRate = bytesPerSecond;
+}
+
+uint32_t CrorcBarEmulator::readRegister(int index)
+{
+  checkIndex(index);
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  switch (index) {
+    case Rorc::C_CSR:
+      return readControl();
+    case Rorc::C_DSR: {
+      // Reading the status register takes the status word out of the mailbox
+      if (mDdlStatus.empty()) {
+        return 0;
+      }
+      auto status = mDdlStatus.front();
+      mDdlStatus.pop_front();
+      return status;
+    }
+    case Rorc::C_RAFO:
+      return mFreeFifo.size();
+    default:
+      return getRegister(index);
+  }
+}
+
+void CrorcBarEmulator::writeRegister(int index, uint32_t value)
+{
+  checkIndex(index);
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  switch (index) {
+    case Rorc::C_CSR:
+      writeControl(value);
+      return;
+    case Rorc::C_DCR:
+      writeDdlCommand(value);
+      return;
+    case Rorc::RCSR:
+      if (value & Rorc::RcsrCommand::RESET_CHAN) {
+        mFreeFifo.clear();
+        mDdlStatus.clear();
+        mReceiverOn = false;
+        mLoopbackOn = false;
+        mGeneratorOn = false;
+      }
+      return;
+    case Rorc::C_RAFL: {
+      // Writing the low word pushes the descriptor into the Free FIFO. Like on the card, pushing into a full FIFO
+      // loses the descriptor.
+      if (mFreeFifo.size() < FREE_FIFO_CAPACITY) {
+        auto address = (uintptr_t(getRegister(Rorc::C_RAFX)) << 32) | uintptr_t(getRegister(Rorc::C_RAFH));
+        mFreeFifo.push_back(Descriptor{address, value >> 8, value & 0xff});
+      }
+      return;
+    }
+    default:
+      mRegisters[index] = value;
+  }
+}
+
+void CrorcBarEmulator::modifyRegister(int index, int position, int width, uint32_t value)
+{
+  uint32_t regValue = readRegister(index);
+  Utilities::setBits(regValue, position, width, value);
+  writeRegister(index, regValue);
+}
+
+void CrorcBarEmulator::checkIndex(int index) const
+{
+  if (index < 0 || (size_t(index) * sizeof(uint32_t)) >= BAR_SIZE) {
+    BOOST_THROW_EXCEPTION(Exception()
+        << ErrorInfo::Message("BAR offset out of range")
+        << ErrorInfo::BarIndex(size_t(index) * sizeof(uint32_t))
+        << ErrorInfo::BarSize(BAR_SIZE));
+  }
+}
+
+uint32_t CrorcBarEmulator::getRegister(int index)
+{
+  auto iter = mRegisters.find(index);
+  return (iter != mRegisters.end()) ? iter->second : 0;
+}
+
+uint32_t CrorcBarEmulator::readControl()
+{
+  // The link is always up and the command register is always ready to take a command
+  uint32_t value = 0;
+  if (mReceiverOn) {
+    value |= Rorc::CcsrCommand::DATA_RX_ON_OFF;
+  }
+  if (mLoopbackOn) {
+    value |= Rorc::CcsrCommand::LOOPB_ON_OFF;
+  }
+  if (mFreeFifo.empty()) {
+    value |= Rorc::CcsrStatus::RXAFF_EMPTY;
+  }
+  if (mFreeFifo.size() >= FREE_FIFO_CAPACITY) {
+    value |= Rorc::CcsrStatus::RXAFF_FULL;
+  }
+  if (!mDdlStatus.empty()) {
+    value |= Rorc::CcsrStatus::RXSTAT_NOT_EMPTY;
+  }
+  return value;
+}
+
+void CrorcBarEmulator::writeControl(uint32_t value)
+{
+  if (value & Rorc::CcsrCommand::CLEAR_RXFF) {
+    mFreeFifo.clear();
+  }
+  if (value & Rorc::CcsrCommand::DATA_RX_ON_OFF) {
+    mReceiverOn = !mReceiverOn;
+    // Start the firmware thread the first time the channel is used for DMA
+    if (mReceiverOn && !mThread.joinable()) {
+      mThread = std::thread([&]{ run(); });
+    }
+  }
+  if (value & Rorc::CcsrCommand::LOOPB_ON_OFF) {
+    mLoopbackOn = !mLoopbackOn;
+  }
+  if (value & Rorc::CcsrCommand::START_DG) {
+    auto cycle = getRegister(Rorc::C_DG4);
+    mGeneratorOn = true;
+    mGeneratorEventsLeft = (cycle & GENERATOR_INFINITE) ? -1 : int64_t(cycle) + 1;
+    mEventCounter = getRegister(Rorc::C_DG3);
+    mRandom.seed(getRegister(Rorc::C_DG2));
+    mNext = std::chrono::steady_clock::now();
+  }
+  if (value & Rorc::CcsrCommand::STOP_DG) {
+    mGeneratorOn = false;
+  }
+}
+
+void CrorcBarEmulator::writeDdlCommand(uint32_t command)
+{
+  // Answer with a status word for the same destination and transaction ID. Reading the interface status of the DIU
+  // or SIU gives an IFSTW followed by a CTSTW, anything else just gives a CTSTW.
+  auto destination = Utilities::getBits(command, 0, 3);
+  auto code = Utilities::getBits(command, 4, 7);
+  auto transactionId = Utilities::getBits(command, 8, 11);
+  auto makeStatus = [&](uint32_t statusCode) {
+    return destination | (statusCode << 4) | (transactionId << 8);
+  };
+
+  if ((destination == Ddl::Destination::DIU || destination == Ddl::Destination::SIU) && (code == Ddl::RandCIFST)) {
+    mDdlStatus.push_back(makeStatus(Ddl::IFSTW));
+  }
+  mDdlStatus.push_back(makeStatus(Ddl::CTSTW));
+}
+
+uint32_t CrorcBarEmulator::writeEvent(uint32_t* page, uint32_t maxWords)
+{
+  // Inverse of the encoding in Crorc::armDataGenerator(). Events that do not fit in the page are cut off.
+  auto blockLength = getRegister(Rorc::C_DG1);
+  auto pattern = Utilities::getBits(blockLength, 0, 3);
+  uint32_t words = std::min(Utilities::getBits(blockLength, 4, 22) + 1, maxWords);
+  uint32_t initialWord = getRegister(Rorc::C_DG2);
+
+  if (words == 0) {
+    return 0;
+  }
+
+  // The first word holds the event number, the rest of the event follows the pattern
+  page[0] = mEventCounter++;
+  for (uint32_t i = 1; i < words; ++i) {
+    switch (pattern) {
+      case GeneratorPattern::Constant:
+        page[i] = 0x12345678;
+        break;
+      case GeneratorPattern::Alternating:
+        page[i] = 0xa5a5a5a5;
+        break;
+      case GeneratorPattern::Flying0:
+        page[i] = ~(uint32_t(1) << ((i - 1) % 32));
+        break;
+      case GeneratorPattern::Flying1:
+        page[i] = uint32_t(1) << ((i - 1) % 32);
+        break;
+      case GeneratorPattern::Random:
+        page[i] = mRandom();
+        break;
+      default:
+        page[i] = initialWord + i - 1;
+        break;
+    }
+  }
+  return words;
+}
+
+bool CrorcBarEmulator::transfer()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  auto readyFifoAddress = (uintptr_t(getRegister(Rorc::C_RRBX)) << 32) | uintptr_t(getRegister(Rorc::C_RRBAR));
+  if (!(mReceiverOn && mGeneratorOn && mLoopbackOn) || (readyFifoAddress == 0)) {
+    return false;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  if (mFreeFifo.empty()) {
+    // Don't let an idle channel build up credit for a burst
+    mNext = std::max(mNext, now);
+    return false;
+  }
+
+  auto readyFifo = reinterpret_cast<ReadyFifo*>(readyFifoAddress);
+  bool didWork = false;
+
+  for (int i = 0; (i < PAGES_PER_ITERATION) && !mFreeFifo.empty() && (mGeneratorEventsLeft != 0); ++i) {
+    if (mRate != 0 && now < mNext) {
+      break;
+    }
+
+    auto descriptor = mFreeFifo.front();
+    mFreeFifo.pop_front();
+    auto words = writeEvent(reinterpret_cast<uint32_t*>(descriptor.address), descriptor.lengthWords);
+    if (mGeneratorEventsLeft > 0) {
+      mGeneratorEventsLeft--;
+    }
+
+    // The status word must not be seen before the length and the data, since it tells the driver the page arrived
+    auto& entry = readyFifo->entries[descriptor.readyFifoIndex % READYFIFO_ENTRIES];
+    entry.length = words;
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.status = (words << 12) | Ddl::DTSW;
+
+    if (mRate != 0) {
+      mNext += std::chrono::nanoseconds((words * sizeof(uint32_t) * 1000000000ull) / mRate);
+    }
+    didWork = true;
+  }
+
+  return didWork;
+}
+
+void CrorcBarEmulator::run()
+{
+  while (!mStopFlag.load(std::memory_order_relaxed)) {
+    if (!transfer()) {
+      std::this_thread::sleep_for(IDLE_PAUSE);
+    }
+  }
+}
+
+} // namespace roc
+} // namespace AliceO2
@@ -0,0 +1,128 @@
+/// \file CrorcBarEmulator.h
+/// \brief Definition of the CrorcBarEmulator class.
+
+#ifndef ALICEO2_READOUTCARD_CRORC_CRORCBAREMULATOR_H_
+#define ALICEO2_READOUTCARD_CRORC_CRORCBAREMULATOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include "Pda/PdaBar.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Software model of a C-RORC channel BAR, so the CrorcBar and CrorcDmaChannel can run without hardware.
+///
+/// Registers are kept in memory. Writes to the C_RAFX/C_RAFH/C_RAFL registers push page descriptors into the Free FIFO.
+/// A thread plays the part of the firmware: while the data receiver, the data generator and the loopback are on, it
+/// takes the descriptors from the Free FIFO in order, fills the pages with the pattern configured in the C_DG*
+/// registers, and then writes the ReadyFIFO entry given by the descriptor: first the length, then a DTSW status word
+/// that also holds the length, like the card does in internal loopback.
+///
+/// DDL commands written to C_DCR are answered with the status words the Crorc functions expect, and the link is always
+/// up. The flash is not emulated, so the card has no serial number.
+///
+/// The "bus addresses" of the pages and the ReadyFIFO are used as userspace addresses, so the buffer must be provided
+/// by an EmulatedDmaBufferProvider.
+class CrorcBarEmulator final : public Pda::PdaBar
+{
+  public:
+    /// Gets the emulated BAR with the given index. There is one emulated card per process, so every caller gets the
+    /// same BAR for as long as someone holds on to it.
+    static std::shared_ptr<CrorcBarEmulator> getInstance(int barIndex);
+
+    CrorcBarEmulator(int barIndex);
+    virtual ~CrorcBarEmulator();
+
+    virtual uint32_t readRegister(int index) override;
+    virtual void writeRegister(int index, uint32_t value) override;
+    virtual void modifyRegister(int index, int position, int width, uint32_t value) override;
+
+    virtual int getIndex() const override
+    {
+      return mBarIndex;
+    }
+
+    virtual size_t getSize() const override
+    {
+      return BAR_SIZE;
+    }
+
+    virtual CardType::type getCardType() override
+    {
+      return CardType::Crorc;
+    }
+
+    /// Limits the rate at which the emulated data generator fills pages
+    /// \param bytesPerSecond Rate in bytes per second, 0 means unlimited
+    void setRate(size_t bytesPerSecond);
+
+  private:
+    /// Size of the emulated BARs
+    static constexpr size_t BAR_SIZE = 1024 * 1024;
+    /// Capacity of the Free FIFO
+    static constexpr size_t FREE_FIFO_CAPACITY = 128;
+
+    /// A page descriptor as pushed into the Free FIFO
+    struct Descriptor
+    {
+        uintptr_t address;
+        uint32_t lengthWords;
+        uint32_t readyFifoIndex;
+    };
+
+    /// Thread function of the emulated firmware
+    void run();
+
+    /// Fills pages from the Free FIFO
+    /// \return True if any page was filled
+    bool transfer();
+
+    /// Fills one page with an event from the data generator
+    /// \return The length of the event in 32-bit words
+    uint32_t writeEvent(uint32_t* page, uint32_t maxWords);
+
+    /// Handles a write to the C_CSR register
+    void writeControl(uint32_t value);
+
+    /// Handles a write to the C_DCR register
+    void writeDdlCommand(uint32_t command);
+
+    /// Gets the value of the C_CSR register, which combines the switches with the status bits
+    uint32_t readControl();
+
+    uint32_t getRegister(int index);
+    void checkIndex(int index) const;
+
+    const int mBarIndex;
+
+    /// Protects everything below
+    std::mutex mMutex;
+    std::unordered_map<int, uint32_t> mRegisters;
+    std::deque<Descriptor> mFreeFifo;
+    std::deque<uint32_t> mDdlStatus;
+    bool mReceiverOn = false;
+    bool mLoopbackOn = false;
+    bool mGeneratorOn = false;
+    /// Events the data generator still has to produce, -1 for infinite
+    int64_t mGeneratorEventsLeft = 0;
+    uint32_t mEventCounter = 0;
+    std::mt19937 mRandom;
+    size_t mRate = 0;
+    std::chrono::steady_clock::time_point mNext;
+
+    std::atomic<bool> mStopFlag {false};
+    std::thread mThread;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_READOUTCARD_CRORC_CRORCBAREMULATOR_H_
@@ -61,19 +61,26 @@ CrorcDmaChannel::CrorcDmaChannel(const Parameters& parameters)
     // Note: if resizing the file fails, we might've accidentally put the file in a hugetlbfs mount with 1 GB page size
     constexpr auto FIFO_SIZE = sizeof(ReadyFifo);
     Utilities::resetSmartPtr(mBufferFifoFile, getPaths().fifo(), FIFO_SIZE, true);
-    Utilities::resetSmartPtr(mPdaDmaBufferFifo, getRocPciDevice().getPciDevice(), mBufferFifoFile->getAddress(),
-        FIFO_SIZE, getPdaDmaBufferIndexFifo(getChannelNumber()), false);// note the 'false' at the end specifies non-hugepage memory
-
-    const auto& entry = mPdaDmaBufferFifo->getScatterGatherList().at(0);
-    if (entry.size < FIFO_SIZE) {
-      // Something must've failed at some point
-      BOOST_THROW_EXCEPTION(Exception()
-          << ErrorInfo::Message("Scatter gather list entry for internal FIFO was too small")
-          << ErrorInfo::ScatterGatherEntrySize(entry.size)
-          << ErrorInfo::FifoSize(FIFO_SIZE));
+
+    if (isEmulated()) {
+      // The emulated card runs in this process, so it uses the userspace address as "bus address"
+      mReadyFifoAddressUser = reinterpret_cast<uintptr_t>(mBufferFifoFile->getAddress());
+      mReadyFifoAddressBus = mReadyFifoAddressUser;
+    } else {
+      Utilities::resetSmartPtr(mPdaDmaBufferFifo, getRocPciDevice().getPciDevice(), mBufferFifoFile->getAddress(),
+          FIFO_SIZE, getPdaDmaBufferIndexFifo(getChannelNumber()), false);// note the 'false' at the end specifies non-hugepage memory
+
+      const auto& entry = mPdaDmaBufferFifo->getScatterGatherList().at(0);
+      if (entry.size < FIFO_SIZE) {
+        // Something must've failed at some point
+        BOOST_THROW_EXCEPTION(Exception()
+            << ErrorInfo::Message("Scatter gather list entry for internal FIFO was too small")
+            << ErrorInfo::ScatterGatherEntrySize(entry.size)
+            << ErrorInfo::FifoSize(FIFO_SIZE));
+      }
+      mReadyFifoAddressUser = entry.addressUser;
+      mReadyFifoAddressBus = entry.addressBus;
     }
-    mReadyFifoAddressUser = entry.addressUser;
-    mReadyFifoAddressBus = entry.addressBus;
   }
 
   getReadyFifoUser()->reset();
@@ -305,7 +312,7 @@ void CrorcDmaChannel::pushSuperpage(Superpage superpage)
   entry.maxPages = superpage.getSize() / mPageSize;
   entry.pushedPages = 0;
   entry.superpage = superpage;
-  entry.superpage.setReceived(0);
+  resetSuperpage(entry.superpage);
 
   mSuperpageQueue.addToQueue(entry);
 }
@@ -23,7 +23,12 @@ namespace roc {
 using Link = Cru::Link;
 
 CruBar::CruBar(const Parameters& parameters)
-    : BarInterfaceBase(parameters),
+    : CruBar(parameters, nullptr)
+{
+}
+
+CruBar::CruBar(const Parameters& parameters, std::shared_ptr<Pda::PdaBar> bar)
+    : BarInterfaceBase(parameters, bar),
       mClock(parameters.getClock().get_value_or(Clock::Local)),
       mDatapathMode(parameters.getDatapathMode().get_value_or(DatapathMode::Packet)),
       mDownstreamData(parameters.getDownstreamData().get_value_or(DownstreamData::Ctp)),
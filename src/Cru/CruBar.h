@@ -30,6 +30,7 @@ class CruBar final : public BarInterfaceBase
 
     CruBar(const Parameters& parameters);
     CruBar(std::shared_ptr<Pda::PdaBar> bar);
+    CruBar(const Parameters& parameters, std::shared_ptr<Pda::PdaBar> bar);
     virtual ~CruBar();
     //virtual void checkReadSafe(int index) override;
     //virtual void checkWriteSafe(int index, uint32_t value) override;
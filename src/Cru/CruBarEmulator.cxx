@@ -0,0 +1,222 @@
+/// \file CruBarEmulator.cxx
+/// \brief Implementation of the CruBarEmulator class.
+
+#include "CruBarEmulator.h"
+#include <algorithm>
+#include <map>
+#include "Cru/DataFormat.h"
+#include "ExceptionInternal.h"
+#include "Utilities/Util.h"
+
+namespace AliceO2 {
+namespace roc {
+namespace {
+/// Maximum amount of pages written per link before moving on to the next link, so links are served fairly
+constexpr int PAGES_PER_ITERATION = 16;
+/// Pause of the firmware thread if no work could be done
+constexpr auto IDLE_PAUSE = std::chrono::microseconds(10);
+
+/// Gets the link number of an interval register address
+/// \return The link number, or -1 if the index does not belong to the interval register
+int getIntervalLink(const IntervalRegister& reg, int index)
+{
+  auto address = uintptr_t(index) * sizeof(uint32_t);
+  if (address < reg.base || ((address - reg.base) % reg.interval) != 0) {
+    return -1;
+  }
+  auto link = (address - reg.base) / reg.interval;
+  return (link < uintptr_t(Cru::MAX_LINKS)) ? int(link) : -1;
+}
+} // Anonymous namespace
+
+std::shared_ptr<CruBarEmulator> CruBarEmulator::getInstance(int serial, int barIndex)
+{
+  static std::mutex mutex;
+  static std::map<std::pair<int, int>, std::weak_ptr<CruBarEmulator>> instances;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& instance = instances[std::make_pair(serial, barIndex)];
+  auto bar = instance.lock();
+  if (!bar) {
+    bar = std::make_shared<CruBarEmulator>(barIndex);
+    instance = bar;
+  }
+  return bar;
+}
+
+CruBarEmulator::CruBarEmulator(int barIndex) : mBarIndex(barIndex)
+{
+  // Only BAR 0 does DMA
+  if (mBarIndex == 0) {
+    mThread = std::thread([&]{ run(); });
+  }
+}
+
+CruBarEmulator::~CruBarEmulator()
+{
+  mStopFlag = true;
+  if (mThread.joinable()) {
+    mThread.join();
+  }
+}
+
+uint32_t CruBarEmulator::readRegister(int index)
+{
+  checkIndex(index);
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  auto link = getIntervalLink(Cru::Registers::LINK_SUPERPAGES_PUSHED, index);
+  if (mBarIndex == 0 && link >= 0) {
+    return mLinks[link].superpagesPushed;
+  }
+
+  auto iter = mRegisters.find(index);
+  return (iter != mRegisters.end()) ? iter->second : 0;
+}
+
+void CruBarEmulator::writeRegister(int index, uint32_t value)
+{
+  checkIndex(index);
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (mBarIndex == 0) {
+    int link = -1;
+    if ((link = getIntervalLink(Cru::Registers::LINK_SUPERPAGE_ADDRESS_HIGH, index)) >= 0) {
+      mLinks[link].addressHigh = value;
+      return;
+    }
+    if ((link = getIntervalLink(Cru::Registers::LINK_SUPERPAGE_ADDRESS_LOW, index)) >= 0) {
+      mLinks[link].addressLow = value;
+      return;
+    }
+    if ((link = getIntervalLink(Cru::Registers::LINK_SUPERPAGE_SIZE, index)) >= 0) {
+      // Writing the size pushes the descriptor into the link's FIFO
+      auto& l = mLinks[link];
+      auto address = (uintptr_t(l.addressHigh) << 32) | uintptr_t(l.addressLow);
+      l.descriptors.push_back(Descriptor{address, value, 0});
+      return;
+    }
+    if (index == int(Cru::Registers::RESET_CONTROL.index)) {
+      reset(value);
+      return;
+    }
+  }
+
+  mRegisters[index] = value;
+}
+
+void CruBarEmulator::modifyRegister(int index, int position, int width, uint32_t value)
+{
+  uint32_t regValue = readRegister(index);
+  Utilities::setBits(regValue, position, width, value);
+  writeRegister(index, regValue);
+}
+
+void CruBarEmulator::checkIndex(int index) const
+{
+  if (index < 0 || (size_t(index) * sizeof(uint32_t)) >= BAR_SIZE) {
+    BOOST_THROW_EXCEPTION(Exception()
+        << ErrorInfo::Message("BAR offset out of range")
+        << ErrorInfo::BarIndex(size_t(index) * sizeof(uint32_t))
+        << ErrorInfo::BarSize(BAR_SIZE));
+  }
+}
+
+uint32_t CruBarEmulator::getRegister(const Register& reg)
+{
+  auto iter = mRegisters.find(reg.index);
+  return (iter != mRegisters.end()) ? iter->second : 0;
+}
+
+void CruBarEmulator::reset(uint32_t value)
+{
+  if (value == 0x1) {
+    // Card reset: the FIFOs are emptied and the counters start from 0
+    for (auto& link : mLinks) {
+      link.descriptors.clear();
+      link.superpagesPushed = 0;
+      link.counters = DummyDataGenerator::Counters();
+    }
+  } else if (value == 0x2) {
+    // Data generator counter reset
+    for (auto& link : mLinks) {
+      link.counters = DummyDataGenerator::Counters();
+    }
+  }
+}
+
+bool CruBarEmulator::isTransferEnabled()
+{
+  return Utilities::getBit(getRegister(Cru::Registers::DMA_CONTROL), 0)
+    && Utilities::getBit(getRegister(Cru::Registers::DATA_GENERATOR_CONTROL), 0)
+    && (getRegister(Cru::Registers::DATA_SOURCE_SELECT) == Cru::Registers::DATA_SOURCE_SELECT_INTERNAL);
+}
+
+DummyDataGenerator::Config CruBarEmulator::getGeneratorConfig()
+{
+  // Inverse of the encoding in CruBar::setDataGeneratorPattern()
+  auto bits = getRegister(Cru::Registers::DATA_GENERATOR_CONTROL);
+
+  DummyDataGenerator::Config config;
+  config.pageSize = Cru::DMA_PAGE_SIZE;
+  // Leave room for the RDH and some payload, the real generator doesn't need to care about that
+  config.dataSize = std::max<size_t>((Utilities::getBits(bits, 8, 15) + 1) * 32,
+      Cru::DataFormat::getHeaderSize() + 32);
+  config.randomSizeEnabled = Utilities::getBit(bits, 16);
+  switch (Utilities::getBits(bits, 1, 2)) {
+    case 0b10:
+      config.pattern = GeneratorPattern::Alternating;
+      break;
+    case 0b11:
+      config.pattern = GeneratorPattern::Constant;
+      break;
+    default:
+      config.pattern = GeneratorPattern::Incremental;
+      break;
+  }
+  return config;
+}
+
+bool CruBarEmulator::transfer()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (!isTransferEnabled()) {
+    return false;
+  }
+
+  auto config = getGeneratorConfig();
+  bool didWork = false;
+
+  for (uint32_t id = 0; id < mLinks.size(); ++id) {
+    auto& link = mLinks[id];
+    for (int i = 0; (i < PAGES_PER_ITERATION) && !link.descriptors.empty(); ++i) {
+      auto& descriptor = link.descriptors.front();
+      if (descriptor.pagesWritten < descriptor.pages) {
+        auto page = reinterpret_cast<char*>(descriptor.address + descriptor.pagesWritten * config.pageSize);
+        auto memorySize = DummyDataGenerator::nextMemorySize(config, mRandom);
+        DummyDataGenerator::writePage(config, id, link.counters, page, memorySize, mRandom);
+        descriptor.pagesWritten++;
+        didWork = true;
+      }
+      if (descriptor.pagesWritten >= descriptor.pages) {
+        link.descriptors.pop_front();
+        link.superpagesPushed++;
+      }
+    }
+  }
+
+  return didWork;
+}
+
+void CruBarEmulator::run()
+{
+  while (!mStopFlag.load(std::memory_order_relaxed)) {
+    if (!transfer()) {
+      std::this_thread::sleep_for(IDLE_PAUSE);
+    }
+  }
+}
+
+} // namespace roc
+} // namespace AliceO2
@@ -0,0 +1,120 @@
+/// \file CruBarEmulator.h
+/// \brief Definition of the CruBarEmulator class.
+
+#ifndef ALICEO2_READOUTCARD_CRU_CRUBAREMULATOR_H_
+#define ALICEO2_READOUTCARD_CRU_CRUBAREMULATOR_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include "Cru/Constants.h"
+#include "Dummy/DummyDataGenerator.h"
+#include "Pda/PdaBar.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Software model of a CRU BAR, so the CruBar and CruDmaChannel can run without hardware.
+///
+/// Registers are kept in memory. On BAR 0, a thread plays the part of the firmware: it takes the superpage descriptors
+/// written to the LINK_SUPERPAGE_* registers, fills the superpages with data from the internal data generator, and
+/// increments the link's LINK_SUPERPAGES_PUSHED register when a superpage is full. Like the real card, data only flows
+/// while DMA_CONTROL is enabled, the data generator is enabled and the internal data source is selected.
+///
+/// The "bus addresses" of the descriptors are used as userspace addresses, so the buffer must be provided by an
+/// EmulatedDmaBufferProvider.
+class CruBarEmulator final : public Pda::PdaBar
+{
+  public:
+    /// Gets the emulated BAR with the given index of an emulated endpoint. Every caller asking for the same endpoint and
+    /// BAR gets the same object, for as long as someone holds on to it.
+    /// \param serial Serial number of the emulated endpoint, ChannelFactory::getCruEmulatorSerialNumber() or
+    ///   ChannelFactory::getCruEmulatorCompanionSerialNumber()
+    /// \param barIndex Index of the BAR
+    static std::shared_ptr<CruBarEmulator> getInstance(int serial, int barIndex);
+
+    CruBarEmulator(int barIndex);
+    virtual ~CruBarEmulator();
+
+    virtual uint32_t readRegister(int index) override;
+    virtual void writeRegister(int index, uint32_t value) override;
+    virtual void modifyRegister(int index, int position, int width, uint32_t value) override;
+
+    virtual int getIndex() const override
+    {
+      return mBarIndex;
+    }
+
+    virtual size_t getSize() const override
+    {
+      return BAR_SIZE;
+    }
+
+    virtual CardType::type getCardType() override
+    {
+      return CardType::Cru;
+    }
+
+  private:
+    /// Size of the emulated BARs, big enough for all CRU registers
+    static constexpr size_t BAR_SIZE = 4 * 1024 * 1024;
+
+    /// A superpage descriptor as pushed into a link's FIFO
+    struct Descriptor
+    {
+        uintptr_t address;
+        uint32_t pages;
+        uint32_t pagesWritten;
+    };
+
+    /// State of one emulated link
+    struct Link
+    {
+        uint32_t addressHigh = 0;
+        uint32_t addressLow = 0;
+        std::deque<Descriptor> descriptors;
+        uint32_t superpagesPushed = 0;
+        DummyDataGenerator::Counters counters;
+    };
+
+    /// Thread function of the emulated firmware
+    void run();
+
+    /// Writes pages into the superpages of the links
+    /// \return True if any page was written
+    bool transfer();
+
+    /// Handles a write to the RESET_CONTROL register
+    void reset(uint32_t value);
+
+    /// Gets the generator settings from the DATA_GENERATOR_CONTROL register
+    DummyDataGenerator::Config getGeneratorConfig();
+
+    /// Checks if data should be flowing
+    bool isTransferEnabled();
+
+    uint32_t getRegister(const Register& reg);
+    void checkIndex(int index) const;
+
+    const int mBarIndex;
+
+    /// Protects the registers and the links
+    std::mutex mMutex;
+    std::unordered_map<int, uint32_t> mRegisters;
+    std::array<Link, Cru::MAX_LINKS> mLinks;
+    std::mt19937 mRandom;
+
+    std::atomic<bool> mStopFlag {false};
+    std::thread mThread;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_READOUTCARD_CRU_CRUBAREMULATOR_H_
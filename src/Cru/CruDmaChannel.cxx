@@ -5,6 +5,7 @@
 /// \author Kostas Alexopoulos (kostas.alexopoulos@cern.ch)
 
 #include "CruDmaChannel.h"
+#include <algorithm>
 #include <thread>
 #include <boost/format.hpp>
 #include "ExceptionInternal.h"
@@ -20,7 +21,10 @@ namespace roc
 
 CruDmaChannel::CruDmaChannel(const Parameters& parameters)
     : DmaChannelPdaBase(parameters, allowedChannels()), //
+      mLinkSuperpageSizes(parameters.getLinkSuperpageSizeMap().get_value_or({})), //
       mInitialResetLevel(ResetLevel::Internal), // It's good to reset at least the card channel in general
+      mWarmStartEnabled(parameters.getWarmStartEnabled().get_value_or(false)), //
+      mDmaStopTimeout(parameters.getDmaStopTimeout().get_value_or(std::chrono::milliseconds(0))), //
       mLoopbackMode(parameters.getGeneratorLoopback().get_value_or(LoopbackMode::Internal)), // Internal loopback by default
       mGeneratorEnabled(parameters.getGeneratorEnabled().get_value_or(true)), // Use data generator by default
       mGeneratorPattern(parameters.getGeneratorPattern().get_value_or(GeneratorPattern::Incremental)), //
@@ -65,6 +69,15 @@ CruDmaChannel::CruDmaChannel(const Parameters& parameters)
     log(stream.str());
   }
 
+  for (const auto& entry : mLinkSuperpageSizes) {
+    if (entry.second == 0 || !Utilities::isMultiple(entry.second, size_t(32*1024))) {
+      BOOST_THROW_EXCEPTION(ParameterException()
+          << ErrorInfo::Message("Link superpage size must be a non-zero multiple of 32 KiB")
+          << ErrorInfo::LinkId(entry.first)
+          << ErrorInfo::SuperpageSize(entry.second));
+    }
+  }
+
   // Insert links
   {
     std::stringstream stream;
@@ -77,7 +90,7 @@ CruDmaChannel::CruDmaChannel(const Parameters& parameters)
           << ErrorInfo::LinkId(id));
       }
       stream << id << " ";
-      mLinks.push_back({static_cast<LinkId>(id)});
+      mLinks.push_back(makeLink(id, 0));
     }
     log(stream.str());
   }
@@ -135,13 +148,20 @@ void CruDmaChannel::deviceStartDma()
     }
   }
 
-  // Reset CRU (should be done after link mask set)
-  resetCru();
-
   // Initialize link queues
-  for (auto &link : mLinks) {
+  for (auto& link : mLinks) {
     link.queue.clear();
-    link.superpageCounter = 0;
+  }
+  removeDrainedLinks();
+
+  if (mWarmStartEnabled && !mNeedsColdStart) {
+    warmStart();
+  } else {
+    // Reset CRU (should be done after link mask set)
+    resetCru();
+    for (auto &link : mLinks) {
+      link.superpageCounter = 0;
+    }
   }
   mReadyQueue.clear();
   mLinkQueuesTotalAvailable = LINK_QUEUE_CAPACITY * mLinks.size();
@@ -165,23 +185,64 @@ void CruDmaChannel::setBufferNonReady()
 
 void CruDmaChannel::deviceStopDma()
 {
+  if (mDmaStopTimeout.count() > 0) {
+    // Keep the DMA running, so superpages in flight can still arrive
+    reserveReadyQueue();
+    auto deadline = std::chrono::steady_clock::now() + mDmaStopTimeout;
+    while (!linkQueuesEmpty() && std::chrono::steady_clock::now() < deadline) {
+      fillSuperpages();
+      std::this_thread::sleep_for(1ms);
+    }
+  }
+
   setBufferNonReady();
+
+  // Make sure every superpage fits, so none are left behind in the link queues
+  reserveReadyQueue();
+
   int moved = 0;
+  int unfilled = 0;
   for (auto& link : mLinks) {
     int32_t superpageCount = getBar()->getSuperpageCount(link.id);
     uint32_t amountAvailable = superpageCount - link.superpageCounter;
+    if (link.queue.size() > amountAvailable) {
+      // The firmware still holds descriptors for unfilled superpages, only a reset gets rid of them
+      mNeedsColdStart = true;
+    }
     //log((format("superpageCount %1% amountAvailable %2%") % superpageCount % amountAvailable).str());
-    for (uint32_t i = 0; i < (amountAvailable + 1); ++i) {
-      if (mReadyQueue.size() >= READY_QUEUE_CAPACITY) {
-        break;
-      }
+
+    // Without a stop timeout, the superpage that was being filled is returned as if it were complete
+    size_t amountFilled = std::min<size_t>((mDmaStopTimeout.count() > 0) ? amountAvailable : amountAvailable + 1,
+        link.queue.size());
+    for (size_t i = 0; i < amountFilled; ++i) {
       transferSuperpageFromLinkToReady(link);
       moved++;
     }
-    assert(link.queue.empty());
+    while (!link.queue.empty()) {
+      transferSuperpageFromLinkToReady(link, false);
+      moved++;
+      unfilled++;
+    }
   }
+  removeDrainedLinks();
   assert(mLinkQueuesTotalAvailable == LINK_QUEUE_CAPACITY * mLinks.size());
-  log((format("Moved %1% remaining superpage(s) to ready queue") % moved).str());
+  log((format("Moved %1% remaining superpage(s) to ready queue, %2% unfilled") % moved % unfilled).str());
+}
+
+bool CruDmaChannel::linkQueuesEmpty() const
+{
+  return std::all_of(mLinks.begin(), mLinks.end(), [](const Link& link) { return link.queue.empty(); });
+}
+
+void CruDmaChannel::reserveReadyQueue()
+{
+  size_t inFlight = 0;
+  for (const auto& link : mLinks) {
+    inFlight += link.queue.size();
+  }
+  if (mReadyQueue.capacity() < (mReadyQueue.size() + inFlight)) {
+    mReadyQueue.set_capacity(mReadyQueue.size() + inFlight);
+  }
 }
 
 void CruDmaChannel::deviceResetChannel(ResetLevel::type resetLevel)
@@ -203,14 +264,47 @@ void CruDmaChannel::resetCru()
   std::this_thread::sleep_for(100ms);
   getBar()->resetCard();
   std::this_thread::sleep_for(100ms);
+  mNeedsColdStart = false;
+}
+
+void CruDmaChannel::warmStart()
+{
+  // The DMA engine was disabled by the previous stop, and no descriptors are outstanding. The firmware's superpage
+  // counters keep counting across runs, so we continue from where they are.
+  setBufferNonReady();
+  for (auto& link : mLinks) {
+    link.superpageCounter = getBar()->getSuperpageCount(link.id);
+  }
+  log("Warm start, skipped card reset");
 }
 
-auto CruDmaChannel::getNextLinkIndex() -> LinkIndex
+auto CruDmaChannel::makeLink(LinkId linkId, uint32_t superpageCounter) -> Link
+{
+  Link link;
+  link.id = linkId;
+  link.superpageCounter = superpageCounter;
+  auto iter = mLinkSuperpageSizes.find(linkId);
+  if (iter != mLinkSuperpageSizes.end()) {
+    link.superpageSize = iter->second;
+  }
+  return link;
+}
+
+auto CruDmaChannel::findLink(LinkId linkId) -> Link*
+{
+  auto iter = std::find_if(mLinks.begin(), mLinks.end(), [&](const Link& link) { return link.id == linkId; });
+  return (iter != mLinks.end()) ? &(*iter) : nullptr;
+}
+
+auto CruDmaChannel::getNextLinkIndex(size_t superpageSize) -> LinkIndex
 {
   auto smallestQueueIndex = std::numeric_limits<LinkIndex>::max();
   auto smallestQueueSize = std::numeric_limits<size_t>::max();
 
   for (size_t i = 0; i < mLinks.size(); ++i) {
+    if (mLinks[i].draining || (mLinks[i].superpageSize != 0 && mLinks[i].superpageSize != superpageSize)) {
+      continue;
+    }
     auto queueSize = mLinks[i].queue.size();
     if (queueSize < smallestQueueSize) {
       smallestQueueIndex = i;
@@ -232,19 +326,47 @@ void CruDmaChannel::pushSuperpage(Superpage superpage)
   }
 
   // Get the next link to push
-  auto &link = mLinks[getNextLinkIndex()];
+  auto linkIndex = getNextLinkIndex(superpage.getSize());
+  if (linkIndex >= mLinks.size()) {
+    BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Could not push superpage, no link accepts its size")
+        << ErrorInfo::SuperpageSize(superpage.getSize()));
+  }
+  auto &link = mLinks[linkIndex];
 
   if (link.queue.size() >= LINK_QUEUE_CAPACITY) {
     // Is the link's FIFO out of space?
-    // This should never happen
-    BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Could not push superpage, link queue was full"));
+    // Without per-link superpage sizes this should never happen, with them the links accepting this size are full
+    BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Could not push superpage, link queue was full")
+        << ErrorInfo::LinkId(link.id));
   }
 
   // Once we've confirmed the link has a slot available, we push the superpage
   pushSuperpageToLink(link, superpage);
-  auto dmaPages = superpage.getSize() / Cru::DMA_PAGE_SIZE;
-  auto busAddress = getBusOffsetAddress(superpage.getOffset());
-  getBar()->pushSuperpageDescriptor(link.id, dmaPages, busAddress);
+}
+
+void CruDmaChannel::pushLinkSuperpage(uint32_t linkId, Superpage superpage)
+{
+  checkSuperpage(superpage);
+
+  auto link = findLink(linkId);
+  if (link == nullptr || link->draining) {
+    BOOST_THROW_EXCEPTION(InvalidLinkId() << ErrorInfo::Message("Could not push superpage, link is not enabled")
+        << ErrorInfo::LinkId(linkId));
+  }
+
+  if (link->superpageSize != 0 && link->superpageSize != superpage.getSize()) {
+    BOOST_THROW_EXCEPTION(Exception()
+        << ErrorInfo::Message("Could not push superpage, size does not match the link's superpage size")
+        << ErrorInfo::LinkId(linkId)
+        << ErrorInfo::SuperpageSize(superpage.getSize()));
+  }
+
+  if (link->queue.size() >= LINK_QUEUE_CAPACITY) {
+    BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Could not push superpage, link queue was full")
+        << ErrorInfo::LinkId(linkId));
+  }
+
+  pushSuperpageToLink(*link, superpage);
 }
 
 auto CruDmaChannel::getSuperpage() -> Superpage
@@ -265,22 +387,81 @@ auto CruDmaChannel::popSuperpage() -> Superpage
   return superpage;
 }
 
-void CruDmaChannel::pushSuperpageToLink(Link& link, const Superpage& superpage)
+void CruDmaChannel::pushSuperpageToLink(Link& link, Superpage superpage)
 {
+  resetSuperpage(superpage);
   mLinkQueuesTotalAvailable--;
   link.queue.push_back(superpage);
+  auto dmaPages = superpage.getSize() / Cru::DMA_PAGE_SIZE;
+  auto busAddress = getBusOffsetAddress(superpage.getOffset());
+  getBar()->pushSuperpageDescriptor(link.id, dmaPages, busAddress);
 }
 
-void CruDmaChannel::transferSuperpageFromLinkToReady(Link& link)
+void CruDmaChannel::transferSuperpageFromLinkToReady(Link& link, bool filled)
 {
-  link.queue.front().setReady(true);
-  link.queue.front().setReceived(link.queue.front().getSize());
+  // The CRU only reports a superpage once it is completely filled
+  link.queue.front().setReady(filled);
+  link.queue.front().setReceived(filled ? link.queue.front().getSize() : 0);
   mReadyQueue.push_back(link.queue.front());
-  mLinkQueuesTotalAvailable++;
+  if (!link.draining) {
+    mLinkQueuesTotalAvailable++;
+  }
   link.queue.pop_front();
   link.superpageCounter++;
 }
 
+void CruDmaChannel::removeDrainedLinks()
+{
+  auto isDrained = [](const Link& link) { return link.draining && link.queue.empty(); };
+  for (const auto& link : mLinks) {
+    if (isDrained(link)) {
+      log((format("Removed drained link %1%") % link.id).str());
+    }
+  }
+  mLinks.erase(std::remove_if(mLinks.begin(), mLinks.end(), isDrained), mLinks.end());
+}
+
+bool CruDmaChannel::enableLink(uint32_t linkId)
+{
+  if (linkId >= Cru::MAX_LINKS) {
+    BOOST_THROW_EXCEPTION(InvalidLinkId() << ErrorInfo::Message("CRU does not support given link ID")
+      << ErrorInfo::LinkId(linkId));
+  }
+
+  if (auto link = findLink(linkId)) {
+    if (link->draining) {
+      // Still has superpages in flight, so we can simply pick up where it left off
+      link->draining = false;
+      mLinkQueuesTotalAvailable += LINK_QUEUE_CAPACITY - link->queue.size();
+      log((format("Re-enabled draining link %1%") % linkId).str());
+    }
+    return true;
+  }
+
+  // The firmware's counter is not reset for a single link, so we continue counting from its current value
+  mLinks.push_back(makeLink(linkId, getBar()->getSuperpageCount(linkId)));
+  mLinkQueuesTotalAvailable += LINK_QUEUE_CAPACITY;
+  log((format("Enabled link %1%") % linkId).str());
+  return true;
+}
+
+bool CruDmaChannel::disableLink(uint32_t linkId)
+{
+  auto link = findLink(linkId);
+  if (link == nullptr) {
+    BOOST_THROW_EXCEPTION(InvalidLinkId() << ErrorInfo::Message("Link is not enabled")
+      << ErrorInfo::LinkId(linkId));
+  }
+
+  if (!link->draining) {
+    link->draining = true;
+    mLinkQueuesTotalAvailable -= LINK_QUEUE_CAPACITY - link->queue.size();
+    log((format("Disabling link %1%, %2% superpage(s) in flight") % linkId % link->queue.size()).str());
+  }
+  removeDrainedLinks();
+  return true;
+}
+
 void CruDmaChannel::fillSuperpages()
 {
   // Check for arrivals & handle them
@@ -303,7 +484,7 @@ void CruDmaChannel::fillSuperpages()
       }
 
       for (uint32_t i = 0; i < amountAvailable; ++i) {
-        if (mReadyQueue.size() >= READY_QUEUE_CAPACITY) {
+        if (mReadyQueue.full()) {
           break;
         }
 
@@ -312,6 +493,7 @@ void CruDmaChannel::fillSuperpages()
       }
     }
   }
+  removeDrainedLinks();
 }
 
 int CruDmaChannel::getTransferQueueAvailable()
@@ -319,6 +501,26 @@ int CruDmaChannel::getTransferQueueAvailable()
   return mLinkQueuesTotalAvailable;
 }
 
+int CruDmaChannel::getTransferQueueAvailableForSize(size_t superpageSize)
+{
+  int available = 0;
+  for (const auto& link : mLinks) {
+    if (!link.draining && (link.superpageSize == 0 || link.superpageSize == superpageSize)) {
+      available += LINK_QUEUE_CAPACITY - link.queue.size();
+    }
+  }
+  return available;
+}
+
+int CruDmaChannel::getLinkTransferQueueAvailable(uint32_t linkId)
+{
+  auto link = findLink(linkId);
+  if (link == nullptr || link->draining) {
+    return 0;
+  }
+  return LINK_QUEUE_CAPACITY - link->queue.size();
+}
+
 int CruDmaChannel::getReadyQueueSize()
 {
   return mReadyQueue.size();
@@ -8,6 +8,7 @@
 #define ALICEO2_READOUTCARD_CRU_CRUDMACHANNEL_H_
 
 #include "DmaChannelPdaBase.h"
+#include <chrono>
 #include <memory>
 #include <deque>
 //#define BOOST_CB_ENABLE_DEBUG 1
@@ -30,8 +31,11 @@ class CruDmaChannel final : public DmaChannelPdaBase
     virtual CardType::type getCardType() override;
 
     virtual void pushSuperpage(Superpage) override;
+    virtual void pushLinkSuperpage(uint32_t linkId, Superpage superpage) override;
 
     virtual int getTransferQueueAvailable() override;
+    virtual int getTransferQueueAvailableForSize(size_t superpageSize) override;
+    virtual int getLinkTransferQueueAvailable(uint32_t linkId) override;
     virtual int getReadyQueueSize() override;
 
     virtual Superpage getSuperpage() override;
@@ -43,6 +47,8 @@ class CruDmaChannel final : public DmaChannelPdaBase
     virtual boost::optional<float> getTemperature() override;
     virtual boost::optional<std::string> getFirmwareInfo() override;
     virtual boost::optional<std::string> getCardId() override;
+    virtual bool enableLink(uint32_t linkId) override;
+    virtual bool disableLink(uint32_t linkId) override;
     AllowedChannels allowedChannels();
 
   protected:
@@ -57,8 +63,9 @@ class CruDmaChannel final : public DmaChannelPdaBase
     /// This may not exceed the limit determined by the firmware capabilities.
     static constexpr size_t LINK_QUEUE_CAPACITY = Cru::MAX_SUPERPAGE_DESCRIPTORS;
 
-    /// Max amount of superpages in the ready queue.
-    /// This is an arbitrary size, can easily be increased if more headroom is needed.
+    /// Initial max amount of superpages in the ready queue.
+    /// This is an arbitrary size, can easily be increased if more headroom is needed. When stopping, the queue grows
+    /// as needed to take all remaining superpages.
     static constexpr size_t READY_QUEUE_CAPACITY = Cru::MAX_SUPERPAGE_DESCRIPTORS * Cru::MAX_LINKS;
 
     /// Queue for one link
@@ -79,11 +86,21 @@ class CruDmaChannel final : public DmaChannelPdaBase
         /// The amount of superpages received from this link
         uint32_t superpageCounter = 0;
 
+        /// Size of superpages this link accepts, or 0 if it accepts any size
+        size_t superpageSize = 0;
+
         /// The superpage queue
         SuperpageQueue queue {LINK_QUEUE_CAPACITY};
+
+        /// True if the link was disabled and only waits for its queue to empty before being removed.
+        /// Its free slots are not counted in mLinkQueuesTotalAvailable.
+        bool draining = false;
     };
 
     void resetCru();
+
+    /// Resynchronises the driver's link counters with the firmware instead of resetting the card
+    void warmStart();
     void setBufferReady();
     void setBufferNonReady();
 
@@ -98,13 +115,32 @@ class CruDmaChannel final : public DmaChannelPdaBase
     }
 
     /// Gets index of next link to push
-    LinkIndex getNextLinkIndex();
+    /// \param superpageSize Size of the superpage to push, only links accepting this size are considered
+    /// \return Index of the link, or std::numeric_limits<LinkIndex>::max() if no link accepts the size
+    LinkIndex getNextLinkIndex(size_t superpageSize);
+
+    /// Finds the link with the given ID
+    /// \return Pointer to the link, or nullptr if the link is not enabled
+    Link* findLink(LinkId linkId);
+
+    /// Makes a link object, applying its superpage size policy
+    Link makeLink(LinkId linkId, uint32_t superpageCounter);
+
+    /// Push a superpage to a link and hand its descriptor to the firmware
+    void pushSuperpageToLink(Link& link, Superpage superpage);
 
-    /// Push a superpage to a link
-    void pushSuperpageToLink(Link& link, const Superpage& superpage);
+    /// Transfer the front superpage of a link to the ready queue
+    /// \param filled True to mark it ready and completely received, false to return it unfilled
+    void transferSuperpageFromLinkToReady(Link& link, bool filled = true);
 
-    /// Mark the front superpage of a link ready and transfer it to the ready queue
-    void transferSuperpageFromLinkToReady(Link& link);
+    /// Checks if all link queues are empty
+    bool linkQueuesEmpty() const;
+
+    /// Grow the ready queue if needed, so it can hold every superpage that is still in the link queues
+    void reserveReadyQueue();
+
+    /// Remove disabled links whose queues are empty
+    void removeDrainedLinks();
 
     /// BAR 0 is needed for DMA engine interaction and various other functions
     std::shared_ptr<CruBar> cruBar;
@@ -119,16 +155,29 @@ class CruDmaChannel final : public DmaChannelPdaBase
     std::vector<Link> mLinks;
 
     /// To keep track of how many slots are available in the link queues (in mLinks) in total
-    size_t mLinkQueuesTotalAvailable;
+    size_t mLinkQueuesTotalAvailable = 0;
 
     /// Queue for superpages that have been transferred and are waiting for popping by the user
     SuperpageQueue mReadyQueue { READY_QUEUE_CAPACITY };
 
+    /// True if the card's state is unknown, or if the firmware may still hold superpage descriptors, in which case the
+    /// next start must reset the card
+    bool mNeedsColdStart = true;
+
     // These variables are configuration parameters
 
+    /// Per-link superpage sizes
+    const Parameters::LinkSuperpageSizeMapType mLinkSuperpageSizes;
+
     /// Reset level on initialization of channel
     const ResetLevel::type mInitialResetLevel;
 
+    /// Skip the card reset on start when the previous run stopped cleanly
+    const bool mWarmStartEnabled;
+
+    /// Maximum time to wait for superpages in flight when stopping, zero to stop immediately
+    const std::chrono::milliseconds mDmaStopTimeout;
+
     /// Gives the type of loopback
     const LoopbackMode::type mLoopbackMode;
 
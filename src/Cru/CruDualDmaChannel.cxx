@@ -0,0 +1,217 @@
+/// \file CruDualDmaChannel.cxx
+/// \brief Implementation of the CruDualDmaChannel class.
+
+#include "CruDualDmaChannel.h"
+#include "Cru/CruDmaChannel.h"
+#include "ExceptionInternal.h"
+
+namespace AliceO2
+{
+namespace roc
+{
+
+CruDualDmaChannel::CruDualDmaChannel(const Parameters& parameters)
+{
+  auto companionId = parameters.getCompanionCardIdRequired();
+  if (companionId == parameters.getCardIdRequired()) {
+    BOOST_THROW_EXCEPTION(ParameterException()
+        << ErrorInfo::Message("Companion endpoint must differ from the primary endpoint")
+        << ErrorInfo::CardId(companionId));
+  }
+
+  auto companionParameters = parameters;
+  companionParameters.setCardId(companionId);
+
+  mEndpoints[0] = std::make_unique<CruDmaChannel>(parameters);
+  mEndpoints[1] = std::make_unique<CruDmaChannel>(companionParameters);
+}
+
+CruDualDmaChannel::~CruDualDmaChannel()
+{
+}
+
+void CruDualDmaChannel::startDma()
+{
+  mReadyQueue.clear();
+  mPollFirst = 0;
+  mPushNext = 0;
+  for (auto& endpoint : mEndpoints) {
+    endpoint->startDma();
+  }
+}
+
+void CruDualDmaChannel::stopDma()
+{
+  for (auto& endpoint : mEndpoints) {
+    endpoint->stopDma();
+  }
+  collectReady(0);
+}
+
+void CruDualDmaChannel::resetChannel(ResetLevel::type resetLevel)
+{
+  for (auto& endpoint : mEndpoints) {
+    endpoint->resetChannel(resetLevel);
+  }
+}
+
+CardType::type CruDualDmaChannel::getCardType()
+{
+  return CardType::Cru;
+}
+
+void CruDualDmaChannel::pushSuperpage(Superpage superpage)
+{
+  // Give the superpage to the endpoint with the most room for its size, so neither runs dry while the other has a
+  // backlog
+  auto available0 = mEndpoints[0]->getTransferQueueAvailableForSize(superpage.getSize());
+  auto available1 = mEndpoints[1]->getTransferQueueAvailableForSize(superpage.getSize());
+
+  if (available0 == 0 && available1 == 0) {
+    BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Could not push superpage, transfer queue was full")
+        << ErrorInfo::SuperpageSize(superpage.getSize()));
+  }
+
+  size_t index = (available0 == available1) ? mPushNext : ((available0 > available1) ? 0 : 1);
+  mPushNext = (index + 1) % ENDPOINTS;
+  mEndpoints[index]->pushSuperpage(superpage);
+}
+
+void CruDualDmaChannel::pushLinkSuperpage(uint32_t linkId, Superpage superpage)
+{
+  auto available0 = mEndpoints[0]->getLinkTransferQueueAvailable(linkId);
+  auto available1 = mEndpoints[1]->getLinkTransferQueueAvailable(linkId);
+
+  if (available0 == 0 && available1 == 0) {
+    BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Could not push superpage, link queue was full")
+        << ErrorInfo::LinkId(linkId));
+  }
+
+  size_t index = (available0 == available1) ? mPushNext : ((available0 > available1) ? 0 : 1);
+  mPushNext = (index + 1) % ENDPOINTS;
+  mEndpoints[index]->pushLinkSuperpage(linkId, superpage);
+}
+
+int CruDualDmaChannel::getTransferQueueAvailable()
+{
+  return mEndpoints[0]->getTransferQueueAvailable() + mEndpoints[1]->getTransferQueueAvailable();
+}
+
+int CruDualDmaChannel::getTransferQueueAvailableForSize(size_t superpageSize)
+{
+  return mEndpoints[0]->getTransferQueueAvailableForSize(superpageSize)
+    + mEndpoints[1]->getTransferQueueAvailableForSize(superpageSize);
+}
+
+int CruDualDmaChannel::getLinkTransferQueueAvailable(uint32_t linkId)
+{
+  return mEndpoints[0]->getLinkTransferQueueAvailable(linkId) + mEndpoints[1]->getLinkTransferQueueAvailable(linkId);
+}
+
+int CruDualDmaChannel::getReadyQueueSize()
+{
+  return mReadyQueue.size();
+}
+
+auto CruDualDmaChannel::getSuperpage() -> Superpage
+{
+  if (mReadyQueue.empty()) {
+    BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Could not get superpage, ready queue was empty"));
+  }
+  return mReadyQueue.front();
+}
+
+auto CruDualDmaChannel::popSuperpage() -> Superpage
+{
+  if (mReadyQueue.empty()) {
+    BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Could not pop superpage, ready queue was empty"));
+  }
+  auto superpage = mReadyQueue.front();
+  mReadyQueue.pop_front();
+  return superpage;
+}
+
+void CruDualDmaChannel::fillSuperpages()
+{
+  auto first = mPollFirst;
+  mPollFirst = (mPollFirst + 1) % ENDPOINTS;
+
+  for (size_t i = 0; i < ENDPOINTS; ++i) {
+    mEndpoints[(first + i) % ENDPOINTS]->fillSuperpages();
+  }
+  collectReady(first);
+}
+
+void CruDualDmaChannel::collectReady(size_t first)
+{
+  for (size_t i = 0; i < ENDPOINTS; ++i) {
+    auto& endpoint = *mEndpoints[(first + i) % ENDPOINTS];
+    while (endpoint.getReadyQueueSize() > 0) {
+      mReadyQueue.push_back(endpoint.popSuperpage());
+    }
+  }
+}
+
+void CruDualDmaChannel::setLogLevel(InfoLogger::InfoLogger::Severity severity)
+{
+  for (auto& endpoint : mEndpoints) {
+    endpoint->setLogLevel(severity);
+  }
+}
+
+PciAddress CruDualDmaChannel::getPciAddress()
+{
+  return getPrimary().getPciAddress();
+}
+
+int CruDualDmaChannel::getNumaNode()
+{
+  return getPrimary().getNumaNode();
+}
+
+bool CruDualDmaChannel::injectError()
+{
+  return getPrimary().injectError();
+}
+
+boost::optional<int32_t> CruDualDmaChannel::getSerial()
+{
+  return getPrimary().getSerial();
+}
+
+boost::optional<float> CruDualDmaChannel::getTemperature()
+{
+  return getPrimary().getTemperature();
+}
+
+boost::optional<std::string> CruDualDmaChannel::getFirmwareInfo()
+{
+  return getPrimary().getFirmwareInfo();
+}
+
+boost::optional<std::string> CruDualDmaChannel::getCardId()
+{
+  return getPrimary().getCardId();
+}
+
+bool CruDualDmaChannel::enableLink(uint32_t linkId)
+{
+  // Both endpoints are opened with the same link mask, so they are kept in step
+  bool enabled = true;
+  for (auto& endpoint : mEndpoints) {
+    enabled = endpoint->enableLink(linkId) && enabled;
+  }
+  return enabled;
+}
+
+bool CruDualDmaChannel::disableLink(uint32_t linkId)
+{
+  bool disabled = true;
+  for (auto& endpoint : mEndpoints) {
+    disabled = endpoint->disableLink(linkId) && disabled;
+  }
+  return disabled;
+}
+
+} // namespace roc
+} // namespace AliceO2
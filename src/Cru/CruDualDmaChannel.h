@@ -0,0 +1,92 @@
+/// \file CruDualDmaChannel.h
+/// \brief Definition of the CruDualDmaChannel class.
+
+#ifndef ALICEO2_READOUTCARD_CRU_CRUDUALDMACHANNEL_H_
+#define ALICEO2_READOUTCARD_CRU_CRUDUALDMACHANNEL_H_
+
+#include <array>
+#include <deque>
+#include <memory>
+#include "ReadoutCard/DmaChannelInterface.h"
+#include "ReadoutCard/Parameters.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Aggregates the DMA channels of the two PCI endpoints of a CRU into one DmaChannelInterface.
+///
+/// Both endpoints are opened with the same buffer, so they share the superpage offset space. Superpages pushed by the
+/// user go to the endpoint with the most free transfer queue slots, and fillSuperpages() polls both endpoints in
+/// alternating order, merging their arrivals into a single ready queue. This way one thread can drive a whole CRU.
+class CruDualDmaChannel final : public DmaChannelInterface
+{
+  public:
+
+    /// Constructor
+    /// \param parameters Parameters of the primary endpoint. The companion endpoint is given by the CompanionCardId
+    ///   parameter and uses the same parameters otherwise.
+    CruDualDmaChannel(const Parameters& parameters);
+    virtual ~CruDualDmaChannel() override;
+
+    virtual void startDma() override;
+    virtual void stopDma() override;
+    virtual void resetChannel(ResetLevel::type resetLevel) override;
+
+    virtual CardType::type getCardType() override;
+
+    virtual void pushSuperpage(Superpage superpage) override;
+    virtual void pushLinkSuperpage(uint32_t linkId, Superpage superpage) override;
+
+    virtual int getTransferQueueAvailable() override;
+    virtual int getTransferQueueAvailableForSize(size_t superpageSize) override;
+    virtual int getLinkTransferQueueAvailable(uint32_t linkId) override;
+    virtual int getReadyQueueSize() override;
+
+    virtual Superpage getSuperpage() override;
+    virtual Superpage popSuperpage() override;
+    virtual void fillSuperpages() override;
+
+    virtual void setLogLevel(InfoLogger::InfoLogger::Severity severity) override;
+    virtual PciAddress getPciAddress() override;
+    virtual int getNumaNode() override;
+
+    virtual bool injectError() override;
+    virtual boost::optional<int32_t> getSerial() override;
+    virtual boost::optional<float> getTemperature() override;
+    virtual boost::optional<std::string> getFirmwareInfo() override;
+    virtual boost::optional<std::string> getCardId() override;
+    virtual bool enableLink(uint32_t linkId) override;
+    virtual bool disableLink(uint32_t linkId) override;
+
+  private:
+
+    /// Amount of endpoints on a CRU
+    static constexpr size_t ENDPOINTS = 2;
+
+    /// Moves all superpages from the endpoints' ready queues to the merged ready queue
+    /// \param first Index of the endpoint whose superpages are moved first
+    void collectReady(size_t first);
+
+    DmaChannelInterface& getPrimary()
+    {
+      return *mEndpoints[0];
+    }
+
+    /// The endpoint channels. Index 0 is the primary endpoint, index 1 the companion.
+    std::array<std::unique_ptr<DmaChannelInterface>, ENDPOINTS> mEndpoints;
+
+    /// Merged queue of superpages that have arrived on either endpoint
+    std::deque<Superpage> mReadyQueue;
+
+    /// Index of the endpoint that fillSuperpages() will poll first, alternated on every call so neither endpoint is
+    /// consistently favoured
+    size_t mPollFirst = 0;
+
+    /// Index of the endpoint that wins the next tie when pushing a superpage
+    size_t mPushNext = 0;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_READOUTCARD_CRU_CRUDUALDMACHANNEL_H_
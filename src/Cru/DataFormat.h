@@ -9,7 +9,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include "Utilities/Util.h"
+#include "ReadoutCard/Rdh.h"
 
 namespace AliceO2
 {
@@ -19,38 +19,31 @@ namespace Cru
 {
 namespace DataFormat
 {
-namespace
+inline uint32_t getLinkId(const char* data)
 {
-  uint32_t getWord(const char* data, int i)
-  {
-    uint32_t word = 0;
-    memcpy(&word, &data[sizeof(word)*i], sizeof(word));
-    return word;
-  }
-} // Anonymous namespace
+  return getRdhField(data, RDH_LAYOUT_V4.linkId);
+}
 
-uint32_t getLinkId(const char* data)
+inline uint32_t getEventSize(const char* data)
 {
-  return Utilities::getBits(getWord(data, 3), 0, 7); //bits #[96-103] from RDH
+  return getRdhField(data, RDH_LAYOUT_V4.memorySize);
 }
 
-uint32_t getEventSize(const char* data)
+inline uint32_t getPacketCounter(const char* data)
 {
-  return Utilities::getBits(getWord(data, 2), 16, 31); //bits #[80-95] from RDH
+  return getRdhField(data, RDH_LAYOUT_V4.packetCounter);
 }
 
-uint32_t getPacketCounter(const char* data)
+inline uint32_t getOffsetToNext(const char* data)
 {
-  return Utilities::getBits(getWord(data, 3), 8, 15); //bits #[104-111] from RDH
+  return getRdhField(data, RDH_LAYOUT_V4.offsetToNext);
 }
 
-////TODO: Add getOffset (pointer to the beginning of the next dma page)
-
 /// Get header size in bytes
 constexpr size_t getHeaderSize()
 {
   // Two 256-bit words = 64 bytes
-  return 0x40;
+  return RDH_SIZE;
 }
 
 /// Get header size in 256-bit words
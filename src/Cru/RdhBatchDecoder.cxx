@@ -0,0 +1,137 @@
+/// \file RdhBatchDecoder.cxx
+/// \brief Implementation of the RDH batch decoding functions
+
+#include "Cru/RdhBatchDecoder.h"
+#include <array>
+#include <limits>
+#include "Utilities/CpuFeatures.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ALICEO2_READOUTCARD_RDH_BATCH_AVX2
+#include <immintrin.h>
+#endif
+
+namespace AliceO2
+{
+namespace roc
+{
+namespace Cru
+{
+namespace DataFormat
+{
+namespace
+{
+/// A field to decode, and the array to decode it into
+struct Target
+{
+    RdhField field;
+    uint32_t* out;
+};
+
+using Targets = std::array<Target, 10>;
+
+/// Amount of 32-bit words in the RDH
+constexpr int RDH_WORDS = 16;
+
+Targets getTargets(const RdhLayout& layout, RdhBatch& batch)
+{
+  return {{
+    {layout.memorySize, batch.memorySize.data()},
+    {layout.offsetToNext, batch.offsetToNext.data()},
+    {layout.linkId, batch.linkId.data()},
+    {layout.packetCounter, batch.packetCounter.data()},
+    {layout.feeId, batch.feeId.data()},
+    {layout.orbit, batch.orbit.data()},
+    {layout.bunchCrossing, batch.bunchCrossing.data()},
+    {layout.triggerType, batch.triggerType.data()},
+    {layout.stopBit, batch.stopBit.data()},
+    {layout.pageCounter, batch.pageCounter.data()}}};
+}
+
+void decodeScalar(const char* data, size_t stride, size_t begin, size_t end, const Targets& targets)
+{
+  for (size_t i = begin; i < end; ++i) {
+    auto page = data + i * stride;
+    for (const auto& target : targets) {
+      target.out[i] = getRdhField(page, target.field);
+    }
+  }
+}
+
+#ifdef ALICEO2_READOUTCARD_RDH_BATCH_AVX2
+/// Decodes the pages in blocks of 8, gathering each needed RDH word of 8 pages at once
+/// \return The amount of pages decoded, the rest must be decoded by decodeScalar()
+__attribute__((target("avx2")))
+size_t decodeAvx2(const char* data, size_t stride, size_t count, const Targets& targets)
+{
+  const int wordStride = stride / sizeof(uint32_t);
+  const __m256i pageOffsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+      _mm256_set1_epi32(wordStride));
+
+  __m256i masks[std::tuple_size<Targets>::value];
+  for (size_t t = 0; t < targets.size(); ++t) {
+    auto width = targets[t].field.width;
+    masks[t] = _mm256_set1_epi32((width >= 32) ? -1 : int(~(~uint32_t(0) << width)));
+  }
+
+  size_t i = 0;
+  for (; (i + 8) <= count; i += 8) {
+    auto block = reinterpret_cast<const int*>(data + i * stride);
+    __m256i words[RDH_WORDS];
+    std::array<bool, RDH_WORDS> gathered {};
+
+    for (size_t t = 0; t < targets.size(); ++t) {
+      const auto& field = targets[t].field;
+      __m256i value = _mm256_setzero_si256();
+      if (field.width != 0) {
+        if (!gathered[field.word]) {
+          auto indexes = _mm256_add_epi32(pageOffsets, _mm256_set1_epi32(field.word));
+          words[field.word] = _mm256_i32gather_epi32(block, indexes, sizeof(uint32_t));
+          gathered[field.word] = true;
+        }
+        value = _mm256_and_si256(_mm256_srl_epi32(words[field.word], _mm_cvtsi32_si128(field.lsb)), masks[t]);
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(targets[t].out + i), value);
+    }
+  }
+  return i;
+}
+#endif
+} // Anonymous namespace
+
+void RdhBatch::resize(size_t size)
+{
+  for (auto array : {&memorySize, &offsetToNext, &linkId, &packetCounter, &feeId, &orbit, &bunchCrossing,
+      &triggerType, &stopBit, &pageCounter}) {
+    array->resize(size);
+  }
+}
+
+void decodeRdhBatch(const char* data, size_t stride, size_t count, const RdhLayout& layout, RdhBatch& batch)
+{
+  batch.resize(count);
+  auto targets = getTargets(layout, batch);
+  size_t decoded = 0;
+
+#ifdef ALICEO2_READOUTCARD_RDH_BATCH_AVX2
+  // The gather indexes of a block of 8 pages must fit in 32 bits
+  bool strideSupported = ((stride % sizeof(uint32_t)) == 0)
+    && (stride < (size_t(std::numeric_limits<int32_t>::max()) / 8));
+  if (strideSupported && Utilities::isAvx2Supported()) {
+    decoded = decodeAvx2(data, stride, count, targets);
+  }
+#endif
+
+  decodeScalar(data, stride, decoded, count, targets);
+}
+
+void decodeRdhBatchScalar(const char* data, size_t stride, size_t count, const RdhLayout& layout, RdhBatch& batch)
+{
+  batch.resize(count);
+  decodeScalar(data, stride, 0, count, getTargets(layout, batch));
+}
+
+} // namespace DataFormat
+} // namespace Cru
+} // namespace roc
+} // namespace AliceO2
@@ -0,0 +1,62 @@
+/// \file RdhBatchDecoder.h
+/// \brief Definition of the RDH batch decoding functions
+
+#ifndef ALICEO2_READOUTCARD_CRU_RDHBATCHDECODER_H_
+#define ALICEO2_READOUTCARD_CRU_RDHBATCHDECODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Cru/DataFormat.h"
+
+namespace AliceO2
+{
+namespace roc
+{
+namespace Cru
+{
+namespace DataFormat
+{
+
+/// The most used RDH fields of a batch of DMA pages, in structure-of-arrays form: element i of each array belongs to
+/// page i
+struct RdhBatch
+{
+    std::vector<uint32_t> memorySize;
+    std::vector<uint32_t> offsetToNext;
+    std::vector<uint32_t> linkId;
+    std::vector<uint32_t> packetCounter;
+    std::vector<uint32_t> feeId;
+    std::vector<uint32_t> orbit;
+    std::vector<uint32_t> bunchCrossing;
+    std::vector<uint32_t> triggerType;
+    std::vector<uint32_t> stopBit;
+    std::vector<uint32_t> pageCounter;
+
+    /// Resizes all arrays
+    void resize(size_t size);
+
+    size_t size() const
+    {
+      return memorySize.size();
+    }
+};
+
+/// Decodes the RDHs of DMA pages that are spaced at a fixed stride, such as the pages of a superpage.
+/// Uses AVX2 gathers if the CPU supports them, so it is much faster than decoding the pages one by one.
+/// \param data Address of the first page
+/// \param stride Distance between the pages in bytes. SIMD is only used if it's a multiple of 4 below 256 MiB.
+/// \param count Amount of pages
+/// \param layout Layout of the RDHs, all pages must have the same version
+/// \param batch Batch to decode into, it is resized to the amount of pages
+void decodeRdhBatch(const char* data, size_t stride, size_t count, const RdhLayout& layout, RdhBatch& batch);
+
+/// Same as decodeRdhBatch(), but never uses SIMD instructions. Mainly for testing and comparison.
+void decodeRdhBatchScalar(const char* data, size_t stride, size_t count, const RdhLayout& layout, RdhBatch& batch);
+
+} // namespace DataFormat
+} // namespace Cru
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_READOUTCARD_CRU_RDHBATCHDECODER_H_
@@ -0,0 +1,94 @@
+/// \file EmulatedDmaBufferProvider.h
+/// \brief Definition of the EmulatedDmaBufferProvider class.
+
+#ifndef ALICEO2_SRC_READOUTCARD_DMABUFFERPROVIDER_EMULATEDDMABUFFERPROVIDER_H_
+#define ALICEO2_SRC_READOUTCARD_DMABUFFERPROVIDER_EMULATEDDMABUFFERPROVIDER_H_
+
+#include "DmaBufferProvider/DmaBufferProviderInterface.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "ExceptionInternal.h"
+#include "ReadoutCard/MemoryMappedFile.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Implementation of the DmaBufferProviderInterface for emulated cards.
+/// The buffer is not registered with PDA: the emulated firmware runs in the same process, so the "bus address" of a
+/// location in the buffer is simply its userspace address.
+class EmulatedDmaBufferProvider : public DmaBufferProviderInterface
+{
+  public:
+    /// Constructor for a buffer in memory
+    EmulatedDmaBufferProvider(void* address, size_t size)
+        : mAddress(reinterpret_cast<uintptr_t>(address)), mSize(size)
+    {
+    }
+
+    /// Constructor for a memory-mapped file buffer
+    EmulatedDmaBufferProvider(std::string path, size_t size)
+        : mMappedFile(std::make_unique<MemoryMappedFile>(path, size, false, false)),
+          mAddress(reinterpret_cast<uintptr_t>(mMappedFile->getAddress())), mSize(mMappedFile->getSize())
+    {
+    }
+
+    virtual ~EmulatedDmaBufferProvider() = default;
+
+    /// Get starting userspace address of the DMA buffer
+    virtual uintptr_t getAddress() const
+    {
+      return mAddress;
+    }
+
+    /// Get total size of the DMA buffer
+    virtual size_t getSize() const
+    {
+      return mSize;
+    }
+
+    /// Amount of entries in the scatter-gather list. The buffer is one contiguous entry.
+    virtual size_t getScatterGatherListSize() const
+    {
+      return 1;
+    }
+
+    /// Get size of an entry of the scatter-gather list
+    virtual size_t getScatterGatherEntrySize(int index) const
+    {
+      checkIndex(index);
+      return mSize;
+    }
+
+    /// Get userspace address of an entry of the scatter-gather list
+    virtual uintptr_t getScatterGatherEntryAddress(int index) const
+    {
+      checkIndex(index);
+      return mAddress;
+    }
+
+    /// Function for getting the bus address that corresponds to the user address + given offset
+    virtual uintptr_t getBusOffsetAddress(size_t offset) const
+    {
+      return mAddress + offset;
+    }
+
+  private:
+    void checkIndex(int index) const
+    {
+      if (index != 0) {
+        BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Scatter-gather list index out of range")
+            << ErrorInfo::Index(index));
+      }
+    }
+
+    std::unique_ptr<MemoryMappedFile> mMappedFile;
+    uintptr_t mAddress;
+    size_t mSize;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_SRC_READOUTCARD_DMABUFFERPROVIDER_EMULATEDDMABUFFERPROVIDER_H_
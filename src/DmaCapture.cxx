@@ -0,0 +1,187 @@
+/// \file DmaCapture.cxx
+/// \brief Implementation of the DmaCaptureWriter and DmaCaptureReader classes.
+
+#include "DmaCapture.h"
+#include <cstring>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "ExceptionInternal.h"
+
+namespace AliceO2 {
+namespace roc {
+
+namespace bip = boost::interprocess;
+namespace bfs = boost::filesystem;
+
+using namespace DmaCapture;
+
+DmaCaptureWriter::DmaCaptureWriter(const std::string& fileName, size_t dmaPageSize)
+    : mFileName(fileName), mStream(fileName, std::ios::binary | std::ios::trunc), mDmaPageSize(dmaPageSize),
+      mOffset(sizeof(Header))
+{
+  // The header is filled in when closing, until then the file is recognizable but has no records
+  Header header {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.dmaPageSize = mDmaPageSize;
+  mStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  checkStream();
+}
+
+DmaCaptureWriter::~DmaCaptureWriter()
+{
+  try {
+    close();
+  }
+  catch (const std::exception&) {
+    // Nothing we can do about it in a destructor
+  }
+}
+
+void DmaCaptureWriter::checkStream()
+{
+  if (!mStream.good()) {
+    BOOST_THROW_EXCEPTION(Exception()
+        << ErrorInfo::Message("Failed to write DMA capture file")
+        << ErrorInfo::FileName(mFileName));
+  }
+}
+
+void DmaCaptureWriter::write(const char* data, size_t size, uint32_t linkId,
+    std::chrono::steady_clock::time_point arrival)
+{
+  if (!mStream.is_open()) {
+    BOOST_THROW_EXCEPTION(Exception()
+        << ErrorInfo::Message("DMA capture file was already closed")
+        << ErrorInfo::FileName(mFileName));
+  }
+
+  if (mIndex.empty()) {
+    mFirstArrival = arrival;
+  }
+
+  IndexEntry entry {};
+  entry.offset = mOffset;
+  entry.size = size;
+  entry.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(arrival - mFirstArrival).count();
+  entry.linkId = linkId;
+  mIndex.push_back(entry);
+
+  static const char padding[DATA_ALIGNMENT] = {};
+  auto paddingSize = (DATA_ALIGNMENT - (size % DATA_ALIGNMENT)) % DATA_ALIGNMENT;
+  mStream.write(data, size);
+  mStream.write(padding, paddingSize);
+  mOffset += size + paddingSize;
+  checkStream();
+}
+
+void DmaCaptureWriter::close()
+{
+  if (!mStream.is_open()) {
+    return;
+  }
+
+  mStream.write(reinterpret_cast<const char*>(mIndex.data()), mIndex.size() * sizeof(IndexEntry));
+
+  Header header {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.dmaPageSize = mDmaPageSize;
+  header.recordCount = mIndex.size();
+  header.indexOffset = mOffset;
+  mStream.seekp(0);
+  mStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  checkStream();
+  mStream.close();
+}
+
+struct DmaCaptureReader::Internal
+{
+    bip::file_mapping fileMapping;
+    bip::mapped_region mappedRegion;
+    const Header* header;
+    const IndexEntry* index;
+};
+
+DmaCaptureReader::DmaCaptureReader(const std::string& fileName) : mInternal(std::make_unique<Internal>())
+{
+  try {
+    if (!bfs::exists(fileName)) {
+      BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("DMA capture file does not exist"));
+    }
+
+    auto fileSize = bfs::file_size(fileName);
+    if (fileSize < sizeof(Header)) {
+      BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("DMA capture file too small to hold a header"));
+    }
+
+    try {
+      mInternal->fileMapping = bip::file_mapping(fileName.c_str(), bip::read_only);
+      mInternal->mappedRegion = bip::mapped_region(mInternal->fileMapping, bip::read_only, 0, fileSize);
+    } catch (const std::exception& e) {
+      BOOST_THROW_EXCEPTION(MemoryMapException()
+          << ErrorInfo::Message(std::string("Failed to memory map DMA capture file: ") + e.what()));
+    }
+
+    auto base = reinterpret_cast<const char*>(mInternal->mappedRegion.get_address());
+    mInternal->header = reinterpret_cast<const Header*>(base);
+    const auto& header = *mInternal->header;
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+      BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("File is not a DMA capture"));
+    }
+    if (header.version != VERSION) {
+      BOOST_THROW_EXCEPTION(Exception()
+          << ErrorInfo::Message("Unsupported DMA capture version " + std::to_string(header.version)));
+    }
+    if ((header.indexOffset > fileSize)
+        || (header.recordCount > ((fileSize - header.indexOffset) / sizeof(IndexEntry)))) {
+      BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("DMA capture index out of range of the file"));
+    }
+
+    mInternal->index = reinterpret_cast<const IndexEntry*>(base + header.indexOffset);
+    for (size_t i = 0; i < header.recordCount; ++i) {
+      const auto& entry = mInternal->index[i];
+      if ((entry.offset > header.indexOffset) || (entry.size > (header.indexOffset - entry.offset))) {
+        BOOST_THROW_EXCEPTION(Exception()
+            << ErrorInfo::Message("DMA capture record out of range of the file")
+            << ErrorInfo::Index(i));
+      }
+    }
+  }
+  catch (Exception& e) {
+    e << ErrorInfo::FileName(fileName);
+    throw;
+  }
+}
+
+DmaCaptureReader::~DmaCaptureReader()
+{
+}
+
+size_t DmaCaptureReader::getRecordCount() const
+{
+  return mInternal->header->recordCount;
+}
+
+size_t DmaCaptureReader::getDmaPageSize() const
+{
+  return mInternal->header->dmaPageSize;
+}
+
+auto DmaCaptureReader::getRecord(size_t index) const -> Record
+{
+  if (index >= getRecordCount()) {
+    BOOST_THROW_EXCEPTION(OutOfRangeException()
+        << ErrorInfo::Message("DMA capture record index out of range")
+        << ErrorInfo::Index(index));
+  }
+
+  const auto& entry = mInternal->index[index];
+  auto base = reinterpret_cast<const char*>(mInternal->mappedRegion.get_address());
+  return {base + entry.offset, entry.size, entry.linkId, std::chrono::nanoseconds(entry.timestamp)};
+}
+
+} // namespace roc
+} // namespace AliceO2
@@ -0,0 +1,144 @@
+/// \file DmaCapture.h
+/// \brief Definition of the DmaCaptureWriter and DmaCaptureReader classes.
+
+#ifndef ALICEO2_SRC_READOUTCARD_DMACAPTURE_H_
+#define ALICEO2_SRC_READOUTCARD_DMACAPTURE_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace AliceO2 {
+namespace roc {
+
+/// Layout of a DMA capture file, which holds a stream of superpages as they arrived from a DMA channel.
+///
+/// The file starts with a Header, followed by the data of the superpages, each starting on a multiple of
+/// DATA_ALIGNMENT bytes. The index, an array of IndexEntry with one entry per superpage, is at the end of the file.
+/// The header and index are only complete once the writer is closed, so a capture that was not closed properly has
+/// no records. All fields are in the byte order of the machine that wrote the capture.
+namespace DmaCapture
+{
+/// Identifies the file as a DMA capture
+constexpr char MAGIC[8] = {'R', 'O', 'C', 'C', 'A', 'P', 'T', '\0'};
+
+/// Version of the format
+constexpr uint32_t VERSION = 1;
+
+/// Alignment of the superpage data in the file
+constexpr size_t DATA_ALIGNMENT = 64;
+
+struct Header
+{
+    char magic[8];
+    uint32_t version;
+    /// Size of the DMA pages in the superpages
+    uint32_t dmaPageSize;
+    /// Amount of records in the index
+    uint64_t recordCount;
+    /// Offset of the index in the file
+    uint64_t indexOffset;
+    uint64_t reserved[4];
+};
+
+struct IndexEntry
+{
+    /// Offset of the superpage data in the file
+    uint64_t offset;
+    /// Amount of bytes received in the superpage
+    uint64_t size;
+    /// Arrival time of the superpage in nanoseconds, relative to the arrival of the first superpage
+    uint64_t timestamp;
+    /// Link ID of the first DMA page of the superpage
+    uint32_t linkId;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == 64, "Capture header has unexpected size");
+static_assert(sizeof(IndexEntry) == 32, "Capture index entry has unexpected size");
+} // namespace DmaCapture
+
+/// Writes superpages to a DMA capture file, see DmaCapture for the format
+class DmaCaptureWriter
+{
+  public:
+    /// Creates the file, overwriting any existing one
+    /// \param fileName Path of the file
+    /// \param dmaPageSize Size of the DMA pages in the superpages that will be written
+    DmaCaptureWriter(const std::string& fileName, size_t dmaPageSize);
+
+    /// Closes the file if close() was not called
+    ~DmaCaptureWriter();
+
+    /// Appends a superpage to the capture
+    /// \param data Address of the superpage data
+    /// \param size Amount of bytes received in the superpage
+    /// \param linkId Link ID of the data
+    /// \param arrival Time of arrival of the superpage
+    void write(const char* data, size_t size, uint32_t linkId, std::chrono::steady_clock::time_point arrival);
+
+    /// Writes the index and header, after which no more superpages can be written
+    void close();
+
+    /// Gets the amount of superpages written
+    size_t getRecordCount() const
+    {
+      return mIndex.size();
+    }
+
+  private:
+    void checkStream();
+
+    std::string mFileName;
+    std::ofstream mStream;
+    size_t mDmaPageSize;
+    uint64_t mOffset;
+    std::chrono::steady_clock::time_point mFirstArrival;
+    std::vector<DmaCapture::IndexEntry> mIndex;
+};
+
+/// Memory-maps a DMA capture file for reading, see DmaCapture for the format
+class DmaCaptureReader
+{
+  public:
+    /// A superpage in the capture
+    struct Record
+    {
+        /// Address of the superpage data in the mapping
+        const char* data;
+        /// Amount of bytes received in the superpage
+        size_t size;
+        /// Link ID of the data
+        uint32_t linkId;
+        /// Arrival time relative to the first superpage of the capture
+        std::chrono::nanoseconds timestamp;
+    };
+
+    /// Maps and checks the file
+    /// \param fileName Path of the file
+    DmaCaptureReader(const std::string& fileName);
+    ~DmaCaptureReader();
+
+    /// Gets the amount of superpages in the capture
+    size_t getRecordCount() const;
+
+    /// Gets the size of the DMA pages in the superpages
+    size_t getDmaPageSize() const;
+
+    /// Gets a superpage from the capture
+    /// \param index Index of the superpage, less than getRecordCount()
+    Record getRecord(size_t index) const;
+
+  private:
+    struct Internal;
+    std::unique_ptr<Internal> mInternal;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_SRC_READOUTCARD_DMACAPTURE_H_
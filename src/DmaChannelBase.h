@@ -41,6 +41,24 @@ class DmaChannelBase: public DmaChannelInterface
         const AllowedChannels& allowedChannels);
     virtual ~DmaChannelBase();
 
+    /// Default implementation for backends without per-link queues
+    virtual void pushLinkSuperpage(uint32_t, Superpage superpage) override
+    {
+      pushSuperpage(superpage);
+    }
+
+    /// Default implementation for backends without per-link superpage sizes
+    virtual int getTransferQueueAvailableForSize(size_t) override
+    {
+      return getTransferQueueAvailable();
+    }
+
+    /// Default implementation for backends without per-link queues
+    virtual int getLinkTransferQueueAvailable(uint32_t) override
+    {
+      return getTransferQueueAvailable();
+    }
+
     /// Default implementation for optional function
     virtual boost::optional<float> getTemperature() override
     {
@@ -59,6 +77,18 @@ class DmaChannelBase: public DmaChannelInterface
       return {};
     }
 
+    /// Default implementation for optional function
+    virtual bool enableLink(uint32_t) override
+    {
+      return false;
+    }
+
+    /// Default implementation for optional function
+    virtual bool disableLink(uint32_t) override
+    {
+      return false;
+    }
+
   protected:
     /// Namespace for enum describing the initialization state of the shared data
     struct InitializationState
@@ -91,6 +121,15 @@ class DmaChannelBase: public DmaChannelInterface
 
     void log(const std::string& message, boost::optional<InfoLogger::InfoLogger::Severity> severity = boost::none);
 
+    /// Clears what the previous fill of a superpage left in it, for when it's pushed again
+    static void resetSuperpage(Superpage& superpage)
+    {
+      superpage.setReady(false);
+      superpage.setReceived(0);
+      superpage.setPacketIndex(nullptr);
+      superpage.clearChecksum();
+    }
+
     InfoLogger::InfoLogger& getLogger()
     {
       return mLogger;
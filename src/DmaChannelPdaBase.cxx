@@ -13,6 +13,8 @@
 #include "DmaBufferProvider/PdaDmaBufferProvider.h"
 #include "DmaBufferProvider/FilePdaDmaBufferProvider.h"
 #include "DmaBufferProvider/NullDmaBufferProvider.h"
+#include "DmaBufferProvider/EmulatedDmaBufferProvider.h"
+#include "Factory/ChannelFactoryUtils.h"
 #include "Visitor.h"
 
 namespace AliceO2 {
@@ -21,6 +23,9 @@ namespace {
 
 CardDescriptor createCardDescriptor(const Parameters& parameters)
 {
+  if (auto emulated = ChannelFactoryUtils::findEmulatedCard(parameters.getCardIdRequired())) {
+    return *emulated;
+  }
   return Visitor::apply<CardDescriptor>(parameters.getCardIdRequired(),
       [&](int serial) {return RocPciDevice(serial).getCardDescriptor();},
       [&](const PciAddress& address) {return RocPciDevice(address).getCardDescriptor();});
@@ -32,11 +37,32 @@ DmaChannelPdaBase::DmaChannelPdaBase(const Parameters& parameters,
     const AllowedChannels& allowedChannels)
     : DmaChannelBase(createCardDescriptor(parameters), const_cast<Parameters&>(parameters), allowedChannels), mDmaState(DmaState::STOPPED)
 {
+  auto bufferParameters = parameters.getBufferParameters();
+  if (!bufferParameters) {
+    BOOST_THROW_EXCEPTION(ParameterException() << ErrorInfo::Message("DmaChannel requires buffer_parameters"));
+  }
+
+  if (ChannelFactoryUtils::findEmulatedCard(parameters.getCardIdRequired())) {
+    // No PCI device, and the buffer doesn't need to be registered or hugepage-backed
+    log("Initializing emulated card", InfoLogger::InfoLogger::Info);
+    mBufferProvider = Visitor::apply<std::unique_ptr<DmaBufferProviderInterface>>(*bufferParameters,
+        [&](buffer_parameters::Memory parameters){
+          return std::make_unique<EmulatedDmaBufferProvider>(parameters.address, parameters.size);
+        },
+        [&](buffer_parameters::File parameters){
+          return std::make_unique<EmulatedDmaBufferProvider>(parameters.path, parameters.size);
+        },
+        [&](buffer_parameters::Null){
+          return std::make_unique<NullDmaBufferProvider>();
+        });
+    return;
+  }
+
   // Initialize PDA & DMA objects
   Utilities::resetSmartPtr(mRocPciDevice, getCardDescriptor().pciAddress);
 
   // Create/register buffer
-  if (auto bufferParameters = parameters.getBufferParameters()) {
+  {
     // Create appropriate BufferProvider subclass
     auto bufferId = getPdaDmaBufferIndexPages(getChannelNumber(), 0);
     mBufferProvider = Visitor::apply<std::unique_ptr<DmaBufferProviderInterface>>(*bufferParameters,
@@ -54,8 +80,6 @@ DmaChannelPdaBase::DmaChannelPdaBase(const Parameters& parameters,
           log("Initializing with null DMA buffer", InfoLogger::InfoLogger::Debug);
           return std::make_unique<NullDmaBufferProvider>();
         });
-  } else {
-    BOOST_THROW_EXCEPTION(ParameterException() << ErrorInfo::Message("DmaChannel requires buffer_parameters"));
   }
 
   // Check if scatter-gather list is not suspicious
@@ -182,6 +206,9 @@ PciAddress DmaChannelPdaBase::getPciAddress()
 
 int DmaChannelPdaBase::getNumaNode()
 {
+  if (isEmulated()) {
+    return getCardDescriptor().numaNode;
+  }
   return Utilities::getNumaNode(getPciAddress());
 }
 
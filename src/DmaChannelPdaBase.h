@@ -102,6 +102,13 @@ class DmaChannelPdaBase: public DmaChannelBase
       return *(mRocPciDevice.get());
     }
 
+    /// Checks if the channel belongs to an emulated card. Emulated cards have no PCI device, and their buffer provider
+    /// gives userspace addresses as bus addresses.
+    bool isEmulated() const
+    {
+      return !mRocPciDevice;
+    }
+
   private:
     /// Contains addresses & size of the buffer
     std::unique_ptr<DmaBufferProviderInterface> mBufferProvider;
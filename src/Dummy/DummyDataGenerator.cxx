@@ -0,0 +1,246 @@
+/// \file DummyDataGenerator.cxx
+/// \brief Implementation of the DummyDataGenerator class.
+
+#include "DummyDataGenerator.h"
+#include <algorithm>
+#include <cstring>
+#include "Cru/DataFormat.h"
+#include "Utilities/Util.h"
+
+namespace AliceO2 {
+namespace roc {
+namespace {
+/// Maximum amount of pages written per link before moving on to the next link, so links are served fairly
+constexpr int PAGES_PER_ITERATION = 16;
+/// Pause of the generator thread if no work could be done
+constexpr auto IDLE_PAUSE = std::chrono::microseconds(10);
+/// Granularity of the generated data sizes
+constexpr size_t DATA_SIZE_STEP = 32;
+} // Anonymous namespace
+
+DummyDataGenerator::DummyDataGenerator(const Config& config, size_t capacity)
+    : mConfig(config), mInputQueue(capacity + 1), mOutputQueue(capacity + 1) // Usable size is (size-1), so we add 1
+{
+  for (auto id : mConfig.links) {
+    Link link;
+    link.id = id;
+    auto iter = mConfig.linkRates.find(id);
+    link.rate = (iter != mConfig.linkRates.end()) ? iter->second : 0;
+    mLinks.push_back(link);
+  }
+
+  if (mConfig.faultProbabilities.count(GeneratorFault::DropPage)) {
+    mDropPage.resize(mConfig.pageSize);
+  }
+}
+
+DummyDataGenerator::~DummyDataGenerator()
+{
+  stop();
+}
+
+void DummyDataGenerator::start()
+{
+  stop();
+  for (auto& link : mLinks) {
+    link.counters = Counters();
+    link.next = std::chrono::steady_clock::now();
+    link.queue.clear();
+  }
+  mStopFlag = false;
+  mThread = std::thread([&]{ run(); });
+}
+
+std::vector<Superpage> DummyDataGenerator::stop()
+{
+  std::vector<Superpage> remaining;
+  if (!mThread.joinable()) {
+    return remaining;
+  }
+
+  mStopFlag = true;
+  mThread.join();
+
+  // The generator thread is gone, so we can empty its queues from this side
+  Superpage superpage;
+  while (mOutputQueue.read(superpage)) {
+    remaining.push_back(superpage);
+  }
+  for (auto& link : mLinks) {
+    remaining.insert(remaining.end(), link.queue.begin(), link.queue.end());
+    link.queue.clear();
+  }
+  while (mInputQueue.read(superpage)) {
+    remaining.push_back(superpage);
+  }
+  return remaining;
+}
+
+bool DummyDataGenerator::push(const Superpage& superpage)
+{
+  return mInputQueue.write(superpage);
+}
+
+bool DummyDataGenerator::pop(Superpage& superpage)
+{
+  return mOutputQueue.read(superpage);
+}
+
+void DummyDataGenerator::run()
+{
+  auto buffer = reinterpret_cast<char*>(mConfig.bufferAddress);
+
+  while (!mStopFlag.load(std::memory_order_relaxed)) {
+    // Distribute new superpages over the links, like the CRU driver does
+    Superpage incoming;
+    while (mInputQueue.read(incoming)) {
+      auto link = std::min_element(mLinks.begin(), mLinks.end(),
+          [](const Link& a, const Link& b) { return a.queue.size() < b.queue.size(); });
+      link->queue.push_back(incoming);
+    }
+
+    bool didWork = false;
+    auto now = std::chrono::steady_clock::now();
+
+    for (auto& link : mLinks) {
+      if (link.queue.empty()) {
+        // Don't let an idle link build up credit for a burst
+        link.next = std::max(link.next, now);
+        continue;
+      }
+
+      for (int i = 0; (i < PAGES_PER_ITERATION) && !link.queue.empty(); ++i) {
+        auto& superpage = link.queue.front();
+
+        if ((superpage.getReceived() + mConfig.pageSize) <= superpage.getSize()) {
+          if (now < link.next) {
+            // Rate limited or stalled
+            break;
+          }
+
+          if (injectFault(GeneratorFault::StallLink)) {
+            link.next = now + mConfig.stallTime;
+            break;
+          }
+
+          if (injectFault(GeneratorFault::SkipPacketCounter)) {
+            link.counters.packetCounter = (link.counters.packetCounter + 1) & 0xff;
+          }
+
+          auto memorySize = nextMemorySize(mConfig, mRandom);
+          auto page = buffer + superpage.getOffset() + superpage.getReceived();
+          if (injectFault(GeneratorFault::DropPage)) {
+            // The data is lost on the way, so the page in the superpage keeps its old contents
+            writePage(mConfig, link.id, link.counters, mDropPage.data(), memorySize, mRandom);
+          } else {
+            writePage(mConfig, link.id, link.counters, page, memorySize, mRandom);
+            if (injectFault(GeneratorFault::CorruptRdh)) {
+              corruptRdh(page);
+            }
+          }
+          superpage.setReceived(superpage.getReceived() + mConfig.pageSize);
+          didWork = true;
+
+          if (link.rate != 0) {
+            link.next += std::chrono::nanoseconds((memorySize * 1000000000ull) / link.rate);
+          }
+        }
+
+        if ((superpage.getReceived() + mConfig.pageSize) > superpage.getSize()) {
+          if (injectFault(GeneratorFault::ReadyQueueOverflow)) {
+            // The arrival of the superpage is lost, so its buffer gets overwritten by the data that follows
+            superpage.setReceived(0);
+            continue;
+          }
+          superpage.setReady(true);
+          if (!mOutputQueue.write(superpage)) {
+            // Can't happen as long as the user respects the capacity, but don't lose the superpage if it does
+            break;
+          }
+          link.queue.pop_front();
+        }
+      }
+    }
+
+    if (!didWork) {
+      std::this_thread::sleep_for(IDLE_PAUSE);
+    }
+  }
+}
+
+bool DummyDataGenerator::injectFault(GeneratorFault::type fault)
+{
+  auto iter = mConfig.faultProbabilities.find(fault);
+  return (iter != mConfig.faultProbabilities.end()) && (mFaultDistribution(mRandom) < iter->second);
+}
+
+void DummyDataGenerator::corruptRdh(char* page)
+{
+  // Flip one of the 16 bits of the memory size, or one of the 8 bits of the packet counter
+  auto words = reinterpret_cast<uint32_t*>(page);
+  std::uniform_int_distribution<int> distribution(0, 16 + 8 - 1);
+  auto bit = distribution(mRandom);
+  if (bit < 16) {
+    words[2] ^= uint32_t(1) << (16 + bit);
+  } else {
+    words[3] ^= uint32_t(1) << (8 + bit - 16);
+  }
+}
+
+size_t DummyDataGenerator::nextMemorySize(const Config& config, std::mt19937& random)
+{
+  if (!config.randomSizeEnabled) {
+    return config.dataSize;
+  }
+  // Between one step of payload and the configured data size
+  auto steps = (config.dataSize - Cru::DataFormat::getHeaderSize()) / DATA_SIZE_STEP;
+  std::uniform_int_distribution<size_t> distribution(1, steps);
+  return Cru::DataFormat::getHeaderSize() + distribution(random) * DATA_SIZE_STEP;
+}
+
+void DummyDataGenerator::writePage(const Config& config, uint32_t linkId, Counters& counters, char* page,
+    size_t memorySize, std::mt19937& random)
+{
+  auto words = reinterpret_cast<uint32_t*>(page);
+
+  // RDH
+  const auto& layout = RDH_LAYOUT_V4;
+  std::memset(page, 0, Cru::DataFormat::getHeaderSize());
+  setRdhField(page, RDH_VERSION_FIELD, layout.version);
+  setRdhField(page, layout.headerSize, Cru::DataFormat::getHeaderSize());
+  setRdhField(page, layout.offsetToNext, config.pageSize);
+  setRdhField(page, layout.memorySize, memorySize);
+  setRdhField(page, layout.linkId, linkId);
+  setRdhField(page, layout.packetCounter, counters.packetCounter);
+  counters.packetCounter = (counters.packetCounter + 1) & 0xff;
+
+  // Payload
+  auto payload = words + (Cru::DataFormat::getHeaderSize() / sizeof(uint32_t));
+  auto payloadWords = (memorySize - Cru::DataFormat::getHeaderSize()) / sizeof(uint32_t);
+  switch (config.pattern) {
+    case GeneratorPattern::Incremental:
+      // Same as the CRU's DDG: every 128-bit word holds counter, counter, 16 LSB of counter, and 0
+      for (size_t i = 0; i + 3 < payloadWords; i += 4) {
+        payload[i + 0] = counters.dataCounter;
+        payload[i + 1] = counters.dataCounter;
+        payload[i + 2] = counters.dataCounter & 0xffff;
+        payload[i + 3] = 0;
+        counters.dataCounter++;
+      }
+      break;
+    case GeneratorPattern::Alternating:
+      std::fill_n(payload, payloadWords, 0xa5a5a5a5);
+      break;
+    case GeneratorPattern::Constant:
+      std::fill_n(payload, payloadWords, 0x12345678);
+      break;
+    default:
+      for (size_t i = 0; i < payloadWords; ++i) {
+        payload[i] = random();
+      }
+      break;
+  }
+}
+
+} // namespace roc
+} // namespace AliceO2
@@ -0,0 +1,147 @@
+/// \file DummyDataGenerator.h
+/// \brief Definition of the DummyDataGenerator class.
+
+#ifndef ALICEO2_SRC_READOUTCARD_DUMMY_DUMMYDATAGENERATOR_H_
+#define ALICEO2_SRC_READOUTCARD_DUMMY_DUMMYDATAGENERATOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Dummy/DummyDataSource.h"
+#include "folly/ProducerConsumerQueue.h"
+#include "ReadoutCard/ParameterTypes/GeneratorFault.h"
+#include "ReadoutCard/ParameterTypes/GeneratorPattern.h"
+#include "ReadoutCard/Superpage.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Emulates the data generator of a CRU for the DummyDmaChannel.
+/// A background thread fills superpages with CRU-format DMA pages: each page starts with an RDH carrying the link ID,
+/// a per-link packet counter and the memory size, followed by a payload in the configured pattern. The incremental
+/// pattern matches the CRU's DDG, so the output can be checked the same way as real CRU data.
+///
+/// Faults can be injected with configurable probabilities, see GeneratorFault, to test how a readout detects and
+/// recovers from them.
+///
+/// Superpages are exchanged with the user thread through single-producer single-consumer queues, so push() and pop()
+/// must be called from one thread only.
+class DummyDataGenerator final : public DummyDataSource
+{
+  public:
+    /// Configuration of the generator
+    struct Config
+    {
+        /// Userspace address of the buffer that superpage offsets refer to
+        uintptr_t bufferAddress = 0;
+
+        /// Size of a DMA page
+        size_t pageSize = 0;
+
+        /// Size of the data written to each DMA page, including the RDH. With random sizes enabled, it's the maximum.
+        size_t dataSize = 0;
+
+        /// Vary the data size of each page randomly, in steps of 32 bytes
+        bool randomSizeEnabled = false;
+
+        /// Pattern of the payload
+        GeneratorPattern::type pattern = GeneratorPattern::Incremental;
+
+        /// IDs of the links to generate data for
+        std::vector<uint32_t> links;
+
+        /// Rate limit per link in bytes per second. 0 or absent means unlimited.
+        std::map<uint32_t, size_t> linkRates;
+
+        /// Probabilities of the injected faults: per DMA page, or per superpage for ReadyQueueOverflow. 0 or absent
+        /// means the fault is not injected.
+        std::map<GeneratorFault::type, double> faultProbabilities;
+
+        /// How long a link stops sending data when a StallLink fault is injected
+        std::chrono::milliseconds stallTime {10};
+    };
+
+    /// \param config Configuration
+    /// \param capacity Maximum amount of superpages that may be in the generator at once
+    DummyDataGenerator(const Config& config, size_t capacity);
+    virtual ~DummyDataGenerator();
+
+    /// Starts the generator thread. Packet and data counters start from 0.
+    virtual void start() override;
+
+    /// Stops the generator thread
+    /// \return The superpages that were not completed, with the amount of bytes written as their received size
+    virtual std::vector<Superpage> stop() override;
+
+    /// Gives a superpage to the generator
+    /// \return False if the generator is full
+    virtual bool push(const Superpage& superpage) override;
+
+    /// Takes a completed superpage from the generator
+    /// \return False if no superpage was completed
+    virtual bool pop(Superpage& superpage) override;
+
+    /// Counters carried over from one page of a link to the next
+    struct Counters
+    {
+        uint32_t packetCounter = 0;
+        uint32_t dataCounter = 0;
+    };
+
+    /// Gets the memory size of the next page, according to the data size settings of the configuration
+    static size_t nextMemorySize(const Config& config, std::mt19937& random);
+
+    /// Writes one DMA page in the configured format. Also used by the CRU BAR emulator, so both produce the same data.
+    /// \param config Configuration. Only the page size, data size and pattern are used.
+    /// \param linkId Link ID to put in the RDH
+    /// \param counters Counters of the link, advanced by the page
+    /// \param page Address of the page
+    /// \param memorySize Size of the data, including the RDH
+    /// \param random Random number generator for the random pattern
+    static void writePage(const Config& config, uint32_t linkId, Counters& counters, char* page, size_t memorySize,
+        std::mt19937& random);
+
+  private:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    /// State of one emulated link
+    struct Link
+    {
+        uint32_t id = 0;
+        size_t rate = 0;
+        Counters counters;
+        TimePoint next;
+        std::deque<Superpage> queue;
+    };
+
+    /// Thread function
+    void run();
+
+    /// Decides if a fault is injected now
+    bool injectFault(GeneratorFault::type fault);
+
+    /// Flips a bit of the memory size or packet counter field of the page's RDH
+    void corruptRdh(char* page);
+
+    const Config mConfig;
+    std::vector<Link> mLinks;
+    folly::ProducerConsumerQueue<Superpage> mInputQueue;
+    folly::ProducerConsumerQueue<Superpage> mOutputQueue;
+    std::mt19937 mRandom;
+    std::uniform_real_distribution<double> mFaultDistribution {0.0, 1.0};
+    /// Page that dropped pages are written to, so the counters advance like for a real page
+    std::vector<char> mDropPage;
+    std::atomic<bool> mStopFlag {false};
+    std::thread mThread;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_SRC_READOUTCARD_DUMMY_DUMMYDATAGENERATOR_H_
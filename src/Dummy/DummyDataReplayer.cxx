@@ -0,0 +1,135 @@
+/// \file DummyDataReplayer.cxx
+/// \brief Implementation of the DummyDataReplayer class.
+
+#include "DummyDataReplayer.h"
+#include <algorithm>
+#include <cstring>
+#include "ExceptionInternal.h"
+
+namespace AliceO2 {
+namespace roc {
+namespace {
+/// Longest pause of the replayer thread, so it notices new superpages and the stop flag in time
+constexpr auto IDLE_PAUSE = std::chrono::microseconds(10);
+} // Anonymous namespace
+
+DummyDataReplayer::DummyDataReplayer(const Config& config, size_t capacity)
+    : mConfig(config), mReader(config.fileName), mInputQueue(capacity + 1),
+      mOutputQueue(capacity + 1) // Usable size is (size-1), so we add 1
+{
+  if (mReader.getRecordCount() == 0) {
+    BOOST_THROW_EXCEPTION(Exception()
+        << ErrorInfo::Message("DMA capture has no superpages to replay")
+        << ErrorInfo::FileName(mConfig.fileName));
+  }
+  if (mReader.getDmaPageSize() != mConfig.pageSize) {
+    BOOST_THROW_EXCEPTION(ParameterException()
+        << ErrorInfo::Message("DMA capture was recorded with a different DMA page size than the channel's ("
+          + std::to_string(mReader.getDmaPageSize()) + " bytes)")
+        << ErrorInfo::DmaPageSize(mConfig.pageSize)
+        << ErrorInfo::FileName(mConfig.fileName));
+  }
+}
+
+DummyDataReplayer::~DummyDataReplayer()
+{
+  stop();
+}
+
+void DummyDataReplayer::start()
+{
+  stop();
+  mPending.clear();
+  mNextRecord = 0;
+  mReplayStart = std::chrono::steady_clock::now();
+  mStopFlag = false;
+  mThread = std::thread([&]{ run(); });
+}
+
+std::vector<Superpage> DummyDataReplayer::stop()
+{
+  std::vector<Superpage> remaining;
+  if (!mThread.joinable()) {
+    return remaining;
+  }
+
+  mStopFlag = true;
+  mThread.join();
+
+  // The replayer thread is gone, so we can empty its queues from this side
+  Superpage superpage;
+  while (mOutputQueue.read(superpage)) {
+    remaining.push_back(superpage);
+  }
+  remaining.insert(remaining.end(), mPending.begin(), mPending.end());
+  mPending.clear();
+  while (mInputQueue.read(superpage)) {
+    remaining.push_back(superpage);
+  }
+  return remaining;
+}
+
+bool DummyDataReplayer::push(const Superpage& superpage)
+{
+  return mInputQueue.write(superpage);
+}
+
+bool DummyDataReplayer::pop(Superpage& superpage)
+{
+  return mOutputQueue.read(superpage);
+}
+
+void DummyDataReplayer::run()
+{
+  auto buffer = reinterpret_cast<char*>(mConfig.bufferAddress);
+  auto pageSize = mReader.getDmaPageSize();
+
+  while (!mStopFlag.load(std::memory_order_relaxed)) {
+    Superpage incoming;
+    while (mInputQueue.read(incoming)) {
+      mPending.push_back(incoming);
+    }
+
+    if (mPending.empty()) {
+      std::this_thread::sleep_for(IDLE_PAUSE);
+      continue;
+    }
+
+    auto record = mReader.getRecord(mNextRecord);
+    auto now = std::chrono::steady_clock::now();
+
+    if (mConfig.pacingEnabled) {
+      auto due = mReplayStart + record.timestamp;
+      if (now < due) {
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(due - now, IDLE_PAUSE));
+        continue;
+      }
+      // We're late, so the rest of the capture keeps its original spacing from here on
+      mReplayStart += now - due;
+    }
+
+    // Only whole DMA pages are replayed into a superpage that is too small
+    auto& superpage = mPending.front();
+    auto size = record.size;
+    if (size > superpage.getSize()) {
+      size = (pageSize != 0) ? superpage.getSize() - (superpage.getSize() % pageSize) : superpage.getSize();
+    }
+    std::memcpy(buffer + superpage.getOffset(), record.data, size);
+    superpage.setReceived(size);
+    superpage.setReady(true);
+
+    // There are never more superpages in the replayer than the output queue can hold
+    mOutputQueue.write(superpage);
+    mPending.pop_front();
+
+    mNextRecord++;
+    if (mNextRecord == mReader.getRecordCount()) {
+      // Start over, with the first record due right away
+      mNextRecord = 0;
+      mReplayStart = std::chrono::steady_clock::now();
+    }
+  }
+}
+
+} // namespace roc
+} // namespace AliceO2
@@ -0,0 +1,91 @@
+/// \file DummyDataReplayer.h
+/// \brief Definition of the DummyDataReplayer class.
+
+#ifndef ALICEO2_SRC_READOUTCARD_DUMMY_DUMMYDATAREPLAYER_H_
+#define ALICEO2_SRC_READOUTCARD_DUMMY_DUMMYDATAREPLAYER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <thread>
+#include "Dummy/DummyDataSource.h"
+#include "DmaCapture.h"
+#include "folly/ProducerConsumerQueue.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Replays a DMA capture for the DummyDmaChannel, see DmaCaptureWriter.
+/// A background thread copies the superpages of the capture in order into the superpages that are pushed, and starts
+/// over at the beginning when the capture ends. A superpage that is smaller than the captured one only receives as
+/// many whole DMA pages as fit.
+///
+/// With pacing enabled, superpages are completed with the same spacing in time as they arrived when recorded, so
+/// bursts and idle periods are reproduced. If no superpage is available when one is due, the rest of the schedule is
+/// delayed, rather than catching up with a burst that was not in the capture.
+class DummyDataReplayer final : public DummyDataSource
+{
+  public:
+    /// Configuration of the replayer
+    struct Config
+    {
+        /// Userspace address of the buffer that superpage offsets refer to
+        uintptr_t bufferAddress = 0;
+
+        /// Path of the capture file
+        std::string fileName;
+
+        /// DMA page size of the channel. It must match the one the capture was recorded with.
+        size_t pageSize = 0;
+
+        /// Replay at the original pacing, or as fast as possible
+        bool pacingEnabled = true;
+    };
+
+    /// \param config Configuration
+    /// \param capacity Maximum amount of superpages that may be in the replayer at once
+    DummyDataReplayer(const Config& config, size_t capacity);
+    virtual ~DummyDataReplayer();
+
+    /// Starts the replayer thread. The replay starts from the beginning of the capture.
+    virtual void start() override;
+
+    /// Stops the replayer thread
+    /// \return The superpages that were not completed
+    virtual std::vector<Superpage> stop() override;
+
+    /// Gives a superpage to the replayer
+    /// \return False if the replayer is full
+    virtual bool push(const Superpage& superpage) override;
+
+    /// Takes a completed superpage from the replayer
+    /// \return False if no superpage was completed
+    virtual bool pop(Superpage& superpage) override;
+
+  private:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    /// Thread function
+    void run();
+
+    const Config mConfig;
+    DmaCaptureReader mReader;
+    folly::ProducerConsumerQueue<Superpage> mInputQueue;
+    folly::ProducerConsumerQueue<Superpage> mOutputQueue;
+    /// Superpages taken from the input queue that were not filled yet
+    std::deque<Superpage> mPending;
+    /// Index of the next record of the capture
+    size_t mNextRecord = 0;
+    /// Time at which the first record of the current pass over the capture is replayed
+    TimePoint mReplayStart;
+    std::atomic<bool> mStopFlag {false};
+    std::thread mThread;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_SRC_READOUTCARD_DUMMY_DUMMYDATAREPLAYER_H_
@@ -0,0 +1,41 @@
+/// \file DummyDataSource.h
+/// \brief Definition of the DummyDataSource interface.
+
+#ifndef ALICEO2_SRC_READOUTCARD_DUMMY_DUMMYDATASOURCE_H_
+#define ALICEO2_SRC_READOUTCARD_DUMMY_DUMMYDATASOURCE_H_
+
+#include <vector>
+#include "ReadoutCard/Superpage.h"
+
+namespace AliceO2 {
+namespace roc {
+
+/// Interface of the objects that fill superpages for the DummyDmaChannel in a background thread.
+///
+/// Superpages are exchanged with the user thread through single-producer single-consumer queues, so push() and pop()
+/// must be called from one thread only.
+class DummyDataSource
+{
+  public:
+    virtual ~DummyDataSource() = default;
+
+    /// Starts the background thread
+    virtual void start() = 0;
+
+    /// Stops the background thread
+    /// \return The superpages that were not completed, with the amount of bytes written as their received size
+    virtual std::vector<Superpage> stop() = 0;
+
+    /// Gives a superpage to the source
+    /// \return False if the source is full
+    virtual bool push(const Superpage& superpage) = 0;
+
+    /// Takes a completed superpage from the source
+    /// \return False if no superpage was completed
+    virtual bool pop(Superpage& superpage) = 0;
+};
+
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_SRC_READOUTCARD_DUMMY_DUMMYDATASOURCE_H_
@@ -6,6 +6,7 @@
 #include "DummyDmaChannel.h"
 #include <chrono>
 #include <random>
+#include "Cru/DataFormat.h"
 #include "ReadoutCard/ChannelFactory.h"
 #include "Visitor.h"
 
@@ -19,6 +20,7 @@ CardDescriptor makeDummyDescriptor()
 
 constexpr size_t TRANSFER_QUEUE_SIZE = 16;
 constexpr size_t READY_QUEUE_SIZE = 32;
+constexpr size_t DEFAULT_DMA_PAGE_SIZE = 8 * 1024;
 }
 
 constexpr auto endm = InfoLogger::InfoLogger::StreamOps::endm;
@@ -30,15 +32,94 @@ DummyDmaChannel::DummyDmaChannel(const Parameters& params)
   getLogger() << "DummyDmaChannel::DummyDmaChannel(channel:" << params.getChannelNumberRequired() << ")"
       << InfoLogger::InfoLogger::endm;
 
+  // The data generator and replay are only used when explicitly requested, otherwise we keep the lightweight
+  // behaviour
+  auto replayFile = params.getReplayFile();
+  bool generatorEnabled = params.getGeneratorEnabled().get_value_or(false);
+  bool dataSourceEnabled = replayFile || generatorEnabled;
+  uintptr_t bufferAddress = 0;
+
   if (auto bufferParameters = params.getBufferParameters()) {
     // Create appropriate BufferProvider subclass
     Visitor::apply(*bufferParameters,
-        [&](buffer_parameters::Memory parameters){ mBufferSize = parameters.size; },
-        [&](buffer_parameters::File parameters){ mBufferSize = parameters.size; },
+        [&](buffer_parameters::Memory parameters){
+          mBufferSize = parameters.size;
+          bufferAddress = reinterpret_cast<uintptr_t>(parameters.address);
+        },
+        [&](buffer_parameters::File parameters){
+          mBufferSize = parameters.size;
+          if (dataSourceEnabled) {
+            mBufferFile = std::make_unique<MemoryMappedFile>(parameters.path, parameters.size, false, false);
+            bufferAddress = reinterpret_cast<uintptr_t>(mBufferFile->getAddress());
+          }
+        },
         [&](buffer_parameters::Null){ mBufferSize = 0; });
   } else {
     BOOST_THROW_EXCEPTION(ParameterException() << ErrorInfo::Message("DmaChannel requires buffer_parameters"));
   }
+
+  if (replayFile && bufferAddress == 0) {
+    BOOST_THROW_EXCEPTION(ParameterException()
+        << ErrorInfo::Message("Replay needs a buffer to write the superpages to, but the buffer is null"));
+  }
+
+  if (replayFile) {
+    DummyDataReplayer::Config config;
+    config.bufferAddress = bufferAddress;
+    config.fileName = *replayFile;
+    config.pageSize = params.getDmaPageSize().get_value_or(DEFAULT_DMA_PAGE_SIZE);
+    config.pacingEnabled = params.getReplayPacingEnabled().get_value_or(true);
+    mDataSource = std::make_unique<DummyDataReplayer>(config, TRANSFER_QUEUE_SIZE);
+    getLogger() << "DummyDmaChannel replaying " << config.fileName << InfoLogger::InfoLogger::endm;
+  } else if (generatorEnabled && bufferAddress != 0) {
+    DummyDataGenerator::Config config;
+    config.bufferAddress = bufferAddress;
+    config.pageSize = params.getDmaPageSize().get_value_or(DEFAULT_DMA_PAGE_SIZE);
+    config.dataSize = params.getGeneratorDataSize().get_value_or(config.pageSize);
+    config.randomSizeEnabled = params.getGeneratorRandomSizeEnabled().get_value_or(false);
+    config.pattern = params.getGeneratorPattern().get_value_or(GeneratorPattern::Incremental);
+
+    // The RDH's offset to the next packet is a 16-bit field, and the generator writes one packet per page
+    if (config.pageSize > 0xffff) {
+      BOOST_THROW_EXCEPTION(ParameterException()
+          << ErrorInfo::Message("Generator DMA page size must fit in the RDH's 16-bit offset to the next packet")
+          << ErrorInfo::DmaPageSize(config.pageSize));
+    }
+
+    if (config.dataSize > config.pageSize || config.dataSize < (Cru::DataFormat::getHeaderSize() + 32)
+        || !Utilities::isMultiple(config.dataSize, size_t(32))) {
+      BOOST_THROW_EXCEPTION(ParameterException()
+          << ErrorInfo::Message("Generator data size must be a multiple of 32 bytes, hold at least the header and 32 "
+            "bytes of payload, and fit in the DMA page")
+          << ErrorInfo::GeneratorEventLength(config.dataSize)
+          << ErrorInfo::DmaPageSize(config.pageSize));
+    }
+
+    auto linkMask = params.getLinkMask().value_or(Parameters::LinkMaskType{0});
+    if (linkMask.empty()) {
+      BOOST_THROW_EXCEPTION(ParameterException()
+          << ErrorInfo::Message("Generator needs at least one link, but the link mask is empty"));
+    }
+    auto rate = params.getGeneratorRate().get_value_or(0);
+    auto linkRates = params.getGeneratorLinkRateMap().get_value_or({});
+    for (uint32_t id : linkMask) {
+      config.links.push_back(id);
+      config.linkRates[id] = linkRates.count(id) ? linkRates.at(id) : rate;
+    }
+
+    config.faultProbabilities = params.getGeneratorFaultMap().get_value_or({});
+    config.stallTime = params.getGeneratorStallTime().get_value_or(config.stallTime);
+    for (const auto& fault : config.faultProbabilities) {
+      if (fault.second < 0.0 || fault.second > 1.0) {
+        BOOST_THROW_EXCEPTION(ParameterException()
+            << ErrorInfo::Message("Generator fault probability must be between 0 and 1, got "
+              + std::to_string(fault.second) + " for " + GeneratorFault::toString(fault.first)));
+      }
+    }
+
+    mDataSource = std::make_unique<DummyDataGenerator>(config, TRANSFER_QUEUE_SIZE);
+    getLogger() << "DummyDmaChannel data generator enabled" << InfoLogger::InfoLogger::endm;
+  }
 }
 
 DummyDmaChannel::~DummyDmaChannel()
@@ -51,11 +132,26 @@ void DummyDmaChannel::startDma()
   getLogger() << "DummyDmaChannel::startDma()" << InfoLogger::InfoLogger::endm;
   mTransferQueue.clear();
   mReadyQueue.clear();
+  if (mDataSource) {
+    mDataSourceInFlight = 0;
+    mDataSource->start();
+  }
 }
 
 void DummyDmaChannel::stopDma()
 {
   getLogger() << "DummyDmaChannel::stopDma()" << InfoLogger::InfoLogger::endm;
+  if (mDataSource) {
+    // Return everything the data source still holds, unfinished superpages are marked as not ready
+    auto remaining = mDataSource->stop();
+    if (mReadyQueue.capacity() < (mReadyQueue.size() + remaining.size())) {
+      mReadyQueue.set_capacity(mReadyQueue.size() + remaining.size());
+    }
+    for (const auto& superpage : remaining) {
+      mReadyQueue.push_back(superpage);
+    }
+    mDataSourceInFlight = 0;
+  }
 }
 
 void DummyDmaChannel::resetChannel(ResetLevel::type resetLevel)
@@ -71,6 +167,9 @@ CardType::type DummyDmaChannel::getCardType()
 
 int DummyDmaChannel::getTransferQueueAvailable()
 {
+  if (mDataSource) {
+    return TRANSFER_QUEUE_SIZE - mDataSourceInFlight;
+  }
   return mTransferQueue.capacity() - mTransferQueue.size();
 }
 
@@ -109,6 +208,15 @@ void DummyDmaChannel::pushSuperpage(Superpage superpage)
                             << ErrorInfo::Message("Superpage offset not 32-bit aligned"));
   }
 
+  resetSuperpage(superpage);
+  if (mDataSource) {
+    if (!mDataSource->push(superpage)) {
+      BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Could not push superpage, transfer queue was full"));
+    }
+    mDataSourceInFlight++;
+    return;
+  }
+
   mTransferQueue.push_back(superpage);
 }
 
@@ -130,6 +238,15 @@ Superpage DummyDmaChannel::popSuperpage()
 
 void DummyDmaChannel::fillSuperpages()
 {
+  if (mDataSource) {
+    Superpage superpage;
+    while (!mReadyQueue.full() && mDataSource->pop(superpage)) {
+      mReadyQueue.push_back(superpage);
+      mDataSourceInFlight--;
+    }
+    return;
+  }
+
   size_t pushQueueSize = mTransferQueue.size();
   for (size_t i = 0; i < pushQueueSize; ++i) {
     if (mReadyQueue.full()) {
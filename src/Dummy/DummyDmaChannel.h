@@ -7,10 +7,14 @@
 #define ALICEO2_SRC_READOUTCARD_DUMMY_DUMMYDMACHANNEL_H_
 
 #include <array>
+#include <memory>
 #include <boost/scoped_ptr.hpp>
 #include <boost/circular_buffer_fwd.hpp>
 #include <boost/circular_buffer.hpp>
 #include "DmaChannelBase.h"
+#include "Dummy/DummyDataGenerator.h"
+#include "Dummy/DummyDataReplayer.h"
+#include "ReadoutCard/MemoryMappedFile.h"
 
 namespace AliceO2 {
 namespace roc {
@@ -19,6 +23,9 @@ namespace roc {
 /// This exists so that the ReadoutCard module may be built even if the all the dependencies of the 'real' card
 /// implementation are not met (this mainly concerns the PDA driver library).
 /// It provides some basic simulation of page pushing and output.
+/// When the data generator is enabled, it fills superpages with CRU-format data in a background thread (see
+/// DummyDataGenerator). When a replay file is given, it fills them with a recorded DMA capture instead (see
+/// DummyDataReplayer). Otherwise, superpages are marked as filled without writing to them.
 class DummyDmaChannel final : public DmaChannelBase
 {
   public:
@@ -52,6 +59,15 @@ class DummyDmaChannel final : public DmaChannelBase
     Queue mTransferQueue;
     Queue mReadyQueue;
     size_t mBufferSize;
+
+    /// Mapping of the buffer, if it was given as a file and a data source is used
+    std::unique_ptr<MemoryMappedFile> mBufferFile;
+
+    /// Data generator or replayer, if enabled
+    std::unique_ptr<DummyDataSource> mDataSource;
+
+    /// Amount of superpages given to the data source and not yet returned
+    size_t mDataSourceInFlight = 0;
 };
 
 } // namespace roc
@@ -81,6 +81,7 @@ DEFINE_ERRINFO(SharedObjectName, std::string);
 DEFINE_ERRINFO(SharedStateFile, std::string);
 DEFINE_ERRINFO(SiuCommand, int);
 DEFINE_ERRINFO(String, std::string);
+DEFINE_ERRINFO(SuperpageSize, size_t);
 DEFINE_ERRINFO(StwExpected, std::string);
 DEFINE_ERRINFO(StwReceived, std::string);
 
@@ -11,8 +11,11 @@
 #ifdef ALICEO2_READOUTCARD_PDA_ENABLED
 #  include "Crorc/CrorcDmaChannel.h"
 #  include "Crorc/CrorcBar.h"
+#  include "Crorc/CrorcBarEmulator.h"
 #  include "Cru/CruDmaChannel.h"
+#  include "Cru/CruDualDmaChannel.h"
 #  include "Cru/CruBar.h"
+#  include "Cru/CruBarEmulator.h"
 #else
 #  pragma message("PDA not enabled, ChannelFactory will always return a dummy implementation")
 #endif
@@ -37,7 +40,12 @@ auto ChannelFactory::getDmaChannel(const Parameters &params) -> DmaChannelShared
     {CardType::Dummy, [&]{ return std::make_unique<DummyDmaChannel>(params); }},
 #ifdef ALICEO2_READOUTCARD_PDA_ENABLED
     {CardType::Crorc, [&]{ return std::make_unique<CrorcDmaChannel>(params); }},
-    {CardType::Cru,   [&]{ return std::make_unique<CruDmaChannel>(params); }}
+    {CardType::Cru,   [&]() -> std::unique_ptr<DmaChannelInterface> {
+      if (params.getCompanionCardId()) {
+        return std::make_unique<CruDualDmaChannel>(params);
+      }
+      return std::make_unique<CruDmaChannel>(params);
+    }}
 #endif
   });
 }
@@ -47,8 +55,23 @@ auto ChannelFactory::getBar(const Parameters &params) -> BarSharedPtr
   return channelFactoryHelper<BarInterface>(params, getDummySerialNumber(), {
     {CardType::Dummy, [&]{ return std::make_unique<DummyBar>(params); }},
 #ifdef ALICEO2_READOUTCARD_PDA_ENABLED
-    {CardType::Crorc, [&]{ return std::make_unique<CrorcBar>(params); }},
-    {CardType::Cru,   [&]{ return std::make_unique<CruBar>(params); }}
+    {CardType::Crorc, [&]{
+      if (findEmulatedCard(params.getCardIdRequired())) {
+        auto emulator = CrorcBarEmulator::getInstance(params.getChannelNumberRequired());
+        if (auto rate = params.getGeneratorRate()) {
+          emulator->setRate(*rate);
+        }
+        return std::make_unique<CrorcBar>(params, emulator);
+      }
+      return std::make_unique<CrorcBar>(params);
+    }},
+    {CardType::Cru,   [&]{
+      if (auto emulated = findEmulatedCard(params.getCardIdRequired())) {
+        return std::make_unique<CruBar>(params,
+            CruBarEmulator::getInstance(*emulated->serialNumber, params.getChannelNumberRequired()));
+      }
+      return std::make_unique<CruBar>(params);
+    }}
 #endif
   });
 }
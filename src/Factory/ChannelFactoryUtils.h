@@ -3,11 +3,15 @@
 ///
 /// \author Pascal Boeschoten (pascal.boeschoten@cern.ch)
 
+#ifndef ALICEO2_SRC_READOUTCARD_FACTORY_CHANNELFACTORYUTILS_H_
+#define ALICEO2_SRC_READOUTCARD_FACTORY_CHANNELFACTORYUTILS_H_
+
 #include <map>
 #include <algorithm>
 #include "CardDescriptor.h"
 #include "ExceptionInternal.h"
 #include "ReadoutCard/CardType.h"
+#include "ReadoutCard/ChannelFactory.h"
 #include "ReadoutCard/Parameters.h"
 #ifdef ALICEO2_READOUTCARD_PDA_ENABLED
 # include "RocPciDevice.h"
@@ -17,6 +21,23 @@ namespace AliceO2 {
 namespace roc {
 namespace ChannelFactoryUtils {
 
+/// Gets the descriptor of an emulated card
+/// \return The descriptor, or nothing if the card ID does not refer to an emulated card
+inline boost::optional<CardDescriptor> findEmulatedCard(const Parameters::CardIdType& id)
+{
+  auto serial = boost::get<int>(&id);
+  if (serial && (*serial == ChannelFactory::getCruEmulatorSerialNumber())) {
+    return CardDescriptor{CardType::Cru, *serial, PciId {"emulated", "emulated"}, PciAddress {0xff, 0x1f, 0}, -1};
+  }
+  if (serial && (*serial == ChannelFactory::getCruEmulatorCompanionSerialNumber())) {
+    return CardDescriptor{CardType::Cru, *serial, PciId {"emulated", "emulated"}, PciAddress {0xff, 0x1e, 0}, -1};
+  }
+  if (serial && (*serial == ChannelFactory::getCrorcEmulatorSerialNumber())) {
+    return CardDescriptor{CardType::Crorc, *serial, PciId {"emulated", "emulated"}, PciAddress {0xff, 0x1f, 1}, -1};
+  }
+  return boost::none;
+}
+
 #ifdef ALICEO2_READOUTCARD_PDA_ENABLED
 inline CardDescriptor findCard(int serial)
 {
@@ -64,7 +85,9 @@ inline CardDescriptor findCard(const PciAddress& address)
 
 inline CardDescriptor findCard(const Parameters::CardIdType& id)
 {
-  if (auto serialMaybe = boost::get<int>(&id)) {
+  if (auto emulated = findEmulatedCard(id)) {
+    return *emulated;
+  } else if (auto serialMaybe = boost::get<int>(&id)) {
     auto serial = *serialMaybe;
     return findCard(serial);
   } else if (auto addressMaybe = boost::get<PciAddress>(&id)) {
@@ -130,3 +153,5 @@ std::unique_ptr<Interface> channelFactoryHelper(const Parameters& params, int du
 } // namespace ChannelFactoryUtils
 } // namespace roc
 } // namespace AliceO2
+
+#endif // ALICEO2_SRC_READOUTCARD_FACTORY_CHANNELFACTORYUTILS_H_
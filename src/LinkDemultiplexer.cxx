@@ -0,0 +1,109 @@
+/// \file LinkDemultiplexer.cxx
+/// \brief Implementation of the LinkDemultiplexer class.
+
+#include "ReadoutCard/LinkDemultiplexer.h"
+#include <algorithm>
+#include "ExceptionInternal.h"
+#include "Utilities/StreamingCopy.h"
+
+namespace AliceO2 {
+namespace roc {
+
+constexpr uint32_t LinkDemultiplexer::MAX_LINKS;
+
+LinkDemultiplexer::LinkDemultiplexer(CardType::type cardType, size_t dmaPageSize)
+    : mCardType(cardType), mDmaPageSize(dmaPageSize), mPackets(MAX_LINKS), mOutputs(MAX_LINKS)
+{
+}
+
+void LinkDemultiplexer::checkLinkId(uint32_t linkId) const
+{
+  if (linkId >= MAX_LINKS) {
+    BOOST_THROW_EXCEPTION(InvalidLinkId()
+        << ErrorInfo::Message("Link ID out of range")
+        << ErrorInfo::LinkId(linkId));
+  }
+}
+
+void LinkDemultiplexer::setOutput(uint32_t linkId, char* buffer, size_t capacity)
+{
+  checkLinkId(linkId);
+  mOutputs[linkId] = Output{buffer, capacity, 0};
+}
+
+size_t LinkDemultiplexer::getOutputSize(uint32_t linkId) const
+{
+  checkLinkId(linkId);
+  return mOutputs[linkId].size;
+}
+
+void LinkDemultiplexer::clearOutputs()
+{
+  for (auto& output : mOutputs) {
+    output.size = 0;
+  }
+}
+
+const std::vector<Packet>& LinkDemultiplexer::getPackets(uint32_t linkId) const
+{
+  checkLinkId(linkId);
+  return mPackets[linkId];
+}
+
+void LinkDemultiplexer::index(const Superpage& superpage, const void* bufferAddress)
+{
+  for (auto linkId : mActiveLinks) {
+    mPackets[linkId].clear();
+  }
+  mActiveLinks.clear();
+
+  // The link ID is in the same place in all RDH versions
+  const bool hasLinkIds = (mCardType != CardType::Crorc);
+  for (const auto& packet : PacketRange(superpage, bufferAddress, mCardType, mDmaPageSize)) {
+    uint32_t linkId = hasLinkIds ? getRdhField(packet.header, RDH_LAYOUT_V4.linkId) : 0;
+    auto& packets = mPackets[linkId];
+    if (packets.empty()) {
+      mActiveLinks.push_back(linkId);
+    }
+    packets.push_back(packet);
+  }
+  std::sort(mActiveLinks.begin(), mActiveLinks.end());
+}
+
+void LinkDemultiplexer::copy(const Superpage& superpage, const void* bufferAddress)
+{
+  index(superpage, bufferAddress);
+
+  // Check all the outputs first, so we don't leave them half-filled
+  for (auto linkId : mActiveLinks) {
+    const auto& output = mOutputs[linkId];
+    if (output.buffer == nullptr) {
+      continue;
+    }
+    size_t size = 0;
+    for (const auto& packet : mPackets[linkId]) {
+      size += packet.payloadSize;
+    }
+    if (size > (output.capacity - output.size)) {
+      BOOST_THROW_EXCEPTION(OutOfRangeException()
+          << ErrorInfo::Message("Demultiplexer output buffer of link too small")
+          << ErrorInfo::LinkId(linkId)
+          << ErrorInfo::Range(size));
+    }
+  }
+
+  for (auto linkId : mActiveLinks) {
+    auto& output = mOutputs[linkId];
+    if (output.buffer == nullptr) {
+      continue;
+    }
+    for (const auto& packet : mPackets[linkId]) {
+      Utilities::streamingCopy(output.buffer + output.size, packet.payload, packet.payloadSize);
+      output.size += packet.payloadSize;
+    }
+  }
+  Utilities::streamingCopyFence();
+}
+
+} // namespace roc
+} // namespace AliceO2
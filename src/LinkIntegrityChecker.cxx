@@ -0,0 +1,190 @@
+/// \file LinkIntegrityChecker.cxx
+/// \brief Implementation of the LinkIntegrityChecker class.
+
+#include "ReadoutCard/LinkIntegrityChecker.h"
+#include "ExceptionInternal.h"
+#include "PatternVerifier.h"
+
+namespace AliceO2 {
+namespace roc {
+namespace {
+/// Size of a data word of the DDG pattern, each holds one value of the data counter
+constexpr size_t DATA_WORD_SIZE = 16;
+
+/// The packet counter is 8 bits wide
+constexpr uint32_t PACKET_COUNTER_MASK = 0xff;
+} // Anonymous namespace
+
+constexpr size_t LinkIntegrityChecker::LINK_IDS;
+
+LinkIntegrityChecker::LinkIntegrityChecker(CardType::type cardType, bool checkPayload)
+    : mCheckPayload(checkPayload), mLinks(LINK_IDS)
+{
+  if (cardType != CardType::Cru && cardType != CardType::Dummy) {
+    BOOST_THROW_EXCEPTION(ParameterException()
+        << ErrorInfo::Message("Only CRU-format data can be checked for link integrity")
+        << ErrorInfo::CardType(cardType));
+  }
+
+  for (auto& link : mLinks) {
+    for (auto& counter : link.counters) {
+      counter.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+bool LinkIntegrityChecker::check(const Superpage& superpage, const void* bufferAddress)
+{
+  bool foundError = false;
+  int superpageLinkId = -1;
+  try {
+    // Dummy and CRU data are walked the same way, the card type only matters for the C-RORC
+    for (const auto& packet : PacketRange(superpage, bufferAddress, CardType::Cru, 0)) {
+      if (superpageLinkId == -1) {
+        superpageLinkId = int(packet.getRdh().getLinkId());
+      }
+      foundError |= checkPacket(packet, superpageLinkId);
+    }
+  }
+  catch (const DataFormatException&) {
+    mMalformedSuperpages.fetch_add(1, std::memory_order_relaxed);
+    foundError = true;
+  }
+  return foundError;
+}
+
+bool LinkIntegrityChecker::check(const Packet& packet)
+{
+  return checkPacket(packet, -1);
+}
+
+bool LinkIntegrityChecker::checkPacket(const Packet& packet, int superpageLinkId)
+{
+  const auto rdh = packet.getRdh();
+  const auto linkId = rdh.getLinkId();
+  auto& link = mLinks[linkId];
+  add(link, Packets);
+  bool foundError = false;
+
+  if (!rdh.isKnownVersion() || (rdh.getHeaderSize() != RDH_SIZE)
+      || ((superpageLinkId != -1) && (uint32_t(superpageLinkId) != linkId))) {
+    add(link, RdhAnomalies);
+    foundError = true;
+  }
+
+  if (packet.payloadSize % DATA_WORD_SIZE != 0) {
+    add(link, SizeMismatches);
+    foundError = true;
+  }
+
+  const auto packetCounter = rdh.getPacketCounter();
+  if (link.hasPacketCounter) {
+    const auto expected = (link.packetCounter + 1) & PACKET_COUNTER_MASK;
+    if (packetCounter == link.packetCounter) {
+      add(link, Duplicates);
+      link.hasDataCounter = false;
+      foundError = true;
+    } else if (packetCounter != expected) {
+      add(link, Gaps);
+      add(link, MissingPackets, (packetCounter - expected) & PACKET_COUNTER_MASK);
+      link.hasDataCounter = false;
+      foundError = true;
+    }
+  }
+  link.packetCounter = packetCounter;
+  link.hasPacketCounter = true;
+
+  if (mCheckPayload && !checkPayload(link, packet)) {
+    add(link, PayloadErrors);
+    foundError = true;
+  }
+  return foundError;
+}
+
+bool LinkIntegrityChecker::checkPayload(Link& link, const Packet& packet)
+{
+  // A partial data word at the end is already counted as a size mismatch
+  const auto dataWords = packet.payloadSize / DATA_WORD_SIZE;
+  if (dataWords == 0) {
+    return true;
+  }
+
+  if (!link.hasDataCounter) {
+    // Take the counter from the data itself
+    link.dataCounter = PatternVerifier::getWord(packet.payload, 0);
+    link.hasDataCounter = true;
+  }
+
+  const auto words = dataWords * (DATA_WORD_SIZE / sizeof(uint32_t));
+  const auto pattern = PatternVerifier::makeDdgPattern(link.dataCounter);
+  if (PatternVerifier::findMismatch(packet.payload, 0, words, pattern) != words) {
+    // Resynchronize on the next packet
+    link.hasDataCounter = false;
+    return false;
+  }
+  link.dataCounter += uint32_t(dataWords);
+  return true;
+}
+
+void LinkIntegrityChecker::add(Link& link, Counter counter, uint64_t amount)
+{
+  auto& value = link.counters[counter];
+  value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+auto LinkIntegrityChecker::getLink(uint32_t linkId) const -> const Link&
+{
+  if (linkId >= LINK_IDS) {
+    BOOST_THROW_EXCEPTION(OutOfRangeException()
+        << ErrorInfo::Message("Link ID out of range")
+        << ErrorInfo::LinkId(linkId));
+  }
+  return mLinks[linkId];
+}
+
+LinkIntegrityCounters LinkIntegrityChecker::getCounters(uint32_t linkId) const
+{
+  const auto& counters = getLink(linkId).counters;
+  auto get = [&](Counter counter) { return counters[counter].load(std::memory_order_relaxed); };
+  LinkIntegrityCounters result;
+  result.packets = get(Packets);
+  result.gaps = get(Gaps);
+  result.missingPackets = get(MissingPackets);
+  result.duplicates = get(Duplicates);
+  result.sizeMismatches = get(SizeMismatches);
+  result.rdhAnomalies = get(RdhAnomalies);
+  result.payloadErrors = get(PayloadErrors);
+  return result;
+}
+
+LinkIntegrityCounters LinkIntegrityChecker::getCounters() const
+{
+  LinkIntegrityCounters total;
+  for (uint32_t linkId = 0; linkId < LINK_IDS; ++linkId) {
+    total += getCounters(linkId);
+  }
+  return total;
+}
+
+boost::optional<uint32_t> LinkIntegrityChecker::getLastPacketCounter(uint32_t linkId) const
+{
+  const auto& link = getLink(linkId);
+  return link.hasPacketCounter ? boost::make_optional(link.packetCounter) : boost::none;
+}
+
+boost::optional<uint32_t> LinkIntegrityChecker::getExpectedDataCounter(uint32_t linkId) const
+{
+  const auto& link = getLink(linkId);
+  return link.hasDataCounter ? boost::make_optional(link.dataCounter) : boost::none;
+}
+
+void LinkIntegrityChecker::resynchronize()
+{
+  for (auto& link : mLinks) {
+    link.hasPacketCounter = false;
+    link.hasDataCounter = false;
+  }
+}
+
+} // namespace roc
+} // namespace AliceO2
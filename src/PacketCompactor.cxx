@@ -0,0 +1,93 @@
+/// \file PacketCompactor.cxx
+/// \brief Implementation of the PacketCompactor class.
+
+#include "ReadoutCard/PacketCompactor.h"
+#include <algorithm>
+#include <cstring>
+#include "ReadoutCard/PacketRange.h"
+#include "ExceptionInternal.h"
+
+namespace AliceO2 {
+namespace roc {
+namespace {
+/// Alignment of the compacted packets
+constexpr size_t PACKET_ALIGNMENT = 32;
+
+/// Number of possible link IDs, the RDH link ID field is 8 bits wide
+constexpr size_t LINK_IDS = 256;
+} // Anonymous namespace
+
+PacketCompactor::PacketCompactor(CardType::type cardType, bool keepHeartbeats)
+    : mCardType(cardType), mKeepHeartbeats(keepHeartbeats), mLastOrbit(LINK_IDS), mHasOrbit(LINK_IDS, false)
+{
+  if (cardType != CardType::Cru && cardType != CardType::Dummy) {
+    BOOST_THROW_EXCEPTION(ParameterException()
+        << ErrorInfo::Message("Only CRU-format data can be compacted")
+        << ErrorInfo::CardType(cardType));
+  }
+}
+
+CompactionStatistics PacketCompactor::compact(Superpage& superpage, void* bufferAddress)
+{
+  auto data = reinterpret_cast<char*>(bufferAddress) + superpage.getOffset();
+  auto statistics = compactTo(superpage, bufferAddress, data, superpage.getReceived());
+  superpage.setReceived(statistics.bytesOut);
+  return statistics;
+}
+
+CompactionStatistics PacketCompactor::compactCopy(const Superpage& superpage, const void* bufferAddress,
+    char* destination, size_t capacity)
+{
+  return compactTo(superpage, bufferAddress, destination, capacity);
+}
+
+CompactionStatistics PacketCompactor::compactTo(const Superpage& superpage, const void* bufferAddress,
+    char* destination, size_t capacity)
+{
+  auto superpageData = reinterpret_cast<const char*>(bufferAddress) + superpage.getOffset();
+  CompactionStatistics statistics;
+  statistics.bytesIn = superpage.getReceived();
+
+  for (const auto& packet : PacketRange(superpage, bufferAddress, mCardType, 0)) {
+    statistics.packets++;
+    auto rdh = packet.getRdh();
+    auto linkId = rdh.getLinkId();
+    auto orbit = rdh.getHeartbeatOrbit();
+
+    bool keep = (packet.payloadSize != 0)
+        || (mKeepHeartbeats && (!mHasOrbit[linkId] || mLastOrbit[linkId] != orbit));
+    if (!keep) {
+      statistics.removedPackets++;
+      continue;
+    }
+    mLastOrbit[linkId] = orbit;
+    mHasOrbit[linkId] = true;
+
+    // Round up to keep the next header aligned, but never past where the next packet was. That way, the write position
+    // never overtakes the read position when compacting in place.
+    size_t memorySize = (packet.payload - packet.header) + packet.payloadSize;
+    size_t offset = packet.header - superpageData;
+    size_t alignedSize = ((memorySize + PACKET_ALIGNMENT - 1) / PACKET_ALIGNMENT) * PACKET_ALIGNMENT;
+    size_t size = std::min({alignedSize, size_t(rdh.getOffsetToNext()), superpage.getReceived() - offset});
+
+    if (size > (capacity - statistics.bytesOut)) {
+      BOOST_THROW_EXCEPTION(OutOfRangeException()
+          << ErrorInfo::Message("Compacted packets do not fit in destination")
+          << ErrorInfo::Offset(offset)
+          << ErrorInfo::Range(capacity));
+    }
+
+    auto target = destination + statistics.bytesOut;
+    if (target != packet.header) {
+      std::memmove(target, packet.header, memorySize);
+    }
+    setRdhField(target, rdh.getLayout().offsetToNext, size);
+    statistics.bytesOut += size;
+  }
+
+  mStatistics += statistics;
+  return statistics;
+}
+
+} // namespace roc
+} // namespace AliceO2
@@ -0,0 +1,77 @@
+/// \file PacketIndex.cxx
+/// \brief Implementation of the PacketIndex and PacketIndexPool classes.
+
+#include "ReadoutCard/PacketIndex.h"
+#include "ExceptionInternal.h"
+
+namespace AliceO2 {
+namespace roc {
+
+void PacketIndex::build(const Superpage& superpage, const void* bufferAddress, CardType::type cardType,
+    size_t dmaPageSize)
+{
+  mEntries.clear();
+  auto superpageData = reinterpret_cast<const char*>(bufferAddress) + superpage.getOffset();
+  const bool hasLinkIds = (cardType != CardType::Crorc);
+  for (const auto& packet : PacketRange(superpage, bufferAddress, cardType, dmaPageSize)) {
+    Entry entry;
+    entry.offset = uint32_t(packet.header - superpageData);
+    entry.payloadSize = uint32_t(packet.payloadSize);
+    entry.headerSize = uint16_t(packet.payload - packet.header);
+    entry.linkId = hasLinkIds ? uint16_t(getRdhField(packet.header, RDH_LAYOUT_V4.linkId)) : 0;
+    mEntries.push_back(entry);
+  }
+}
+
+PacketIndexPool::PacketIndexPool(CardType::type cardType, size_t dmaPageSize, size_t capacity)
+    : mCardType(cardType), mDmaPageSize(dmaPageSize)
+{
+  for (size_t i = 0; i < capacity; ++i) {
+    mIndexes.push_back(std::make_unique<PacketIndex>());
+    mAvailable.push_back(mIndexes.back().get());
+  }
+}
+
+const PacketIndex& PacketIndexPool::attach(Superpage& superpage, const void* bufferAddress)
+{
+  if (superpage.getPacketIndex() != nullptr) {
+    BOOST_THROW_EXCEPTION(Exception()
+        << ErrorInfo::Message("Superpage already has a packet index attached")
+        << ErrorInfo::Offset(superpage.getOffset()));
+  }
+
+  if (mAvailable.empty()) {
+    BOOST_THROW_EXCEPTION(OutOfRangeException()
+        << ErrorInfo::Message("No packet index available, all are attached to superpages")
+        << ErrorInfo::Range(mIndexes.size()));
+  }
+
+  // Only take the index from the pool once it's built, so it's not lost if the data is invalid
+  auto index = mAvailable.back();
+  index->build(superpage, bufferAddress, mCardType, mDmaPageSize);
+  mAvailable.pop_back();
+  superpage.setPacketIndex(index);
+  return *index;
+}
+
+void PacketIndexPool::release(Superpage& superpage)
+{
+  if (superpage.getPacketIndex() == nullptr) {
+    BOOST_THROW_EXCEPTION(Exception()
+        << ErrorInfo::Message("Superpage has no packet index to release")
+        << ErrorInfo::Offset(superpage.getOffset()));
+  }
+  for (auto& index : mIndexes) {
+    if (index.get() == superpage.getPacketIndex()) {
+      mAvailable.push_back(index.get());
+      superpage.setPacketIndex(nullptr);
+      return;
+    }
+  }
+  BOOST_THROW_EXCEPTION(Exception()
+      << ErrorInfo::Message("Packet index of superpage is not from this pool")
+      << ErrorInfo::Offset(superpage.getOffset()));
+}
+
+} // namespace roc
+} // namespace AliceO2
@@ -0,0 +1,89 @@
+/// \file PacketRange.cxx
+/// \brief Implementation of the PacketRange class.
+
+#include "ReadoutCard/PacketRange.h"
+#include <cstring>
+#include "ExceptionInternal.h"
+
+namespace AliceO2 {
+namespace roc {
+namespace {
+/// Offset of the event size in the SDH, in bytes. It's written by the CrorcDmaChannel when the page arrives.
+constexpr size_t SDH_EVENT_SIZE_OFFSET = 28;
+} // Anonymous namespace
+
+PacketRange::PacketRange(const Superpage& superpage, const void* bufferAddress, CardType::type cardType,
+    size_t dmaPageSize)
+    : mData(reinterpret_cast<const char*>(bufferAddress) + superpage.getOffset()),
+      mReceived(superpage.getReceived()), mSdhFormat(cardType == CardType::Crorc), mDmaPageSize(dmaPageSize)
+{
+  if (cardType != CardType::Crorc && cardType != CardType::Cru && cardType != CardType::Dummy) {
+    BOOST_THROW_EXCEPTION(ParameterException()
+        << ErrorInfo::Message("Packets can't be walked for this card type")
+        << ErrorInfo::CardType(cardType));
+  }
+
+  if (mSdhFormat && mDmaPageSize <= SDH_SIZE) {
+    BOOST_THROW_EXCEPTION(ParameterException()
+        << ErrorInfo::Message("DMA page size must be larger than the SDH to walk C-RORC packets")
+        << ErrorInfo::DmaPageSize(mDmaPageSize));
+  }
+}
+
+void PacketRange::Iterator::load()
+{
+  const auto received = mRange->mReceived;
+  if (mOffset >= received) {
+    mOffset = received;
+    return;
+  }
+
+  const auto remaining = received - mOffset;
+  const auto header = mRange->mData + mOffset;
+
+  auto throwFormatError = [&](const std::string& message) {
+    BOOST_THROW_EXCEPTION(DataFormatException()
+        << ErrorInfo::Message(message)
+        << ErrorInfo::Offset(mOffset)
+        << ErrorInfo::SuperpageSize(received));
+  };
+
+  if (mRange->mSdhFormat) {
+    if (remaining < SDH_SIZE) {
+      throwFormatError("Superpage ends inside an SDH");
+    }
+    uint32_t eventSize = 0;
+    std::memcpy(&eventSize, header + SDH_EVENT_SIZE_OFFSET, sizeof(eventSize));
+    if (eventSize < SDH_SIZE || eventSize > mRange->mDmaPageSize || eventSize > remaining) {
+      throwFormatError("SDH event size " + std::to_string(eventSize) + " out of range");
+    }
+    mPacket.header = header;
+    mPacket.payload = header + SDH_SIZE;
+    mPacket.payloadSize = eventSize - SDH_SIZE;
+    mNext = mOffset + mRange->mDmaPageSize;
+    return;
+  }
+
+  if (remaining < RDH_SIZE) {
+    throwFormatError("Superpage ends inside an RDH");
+  }
+  RdhView rdh(header);
+  auto headerSize = rdh.getHeaderSize();
+  auto memorySize = rdh.getMemorySize();
+  auto offsetToNext = rdh.getOffsetToNext();
+  if (headerSize < RDH_SIZE || memorySize < headerSize || memorySize > remaining) {
+    throwFormatError("RDH header size " + std::to_string(headerSize) + " or memory size "
+        + std::to_string(memorySize) + " out of range");
+  }
+  if (offsetToNext < memorySize) {
+    // This would make us walk over the packet's own data, or loop forever
+    throwFormatError("RDH offset to next packet " + std::to_string(offsetToNext) + " smaller than memory size");
+  }
+  mPacket.header = header;
+  mPacket.payload = header + headerSize;
+  mPacket.payloadSize = memorySize - headerSize;
+  mNext = mOffset + offsetToNext;
+}
+
+} // namespace roc
+} // namespace AliceO2
@@ -0,0 +1,32 @@
+/// \file GeneratorFault.cxx
+/// \brief Implementation of the GeneratorFault enum and supporting functions.
+
+#include "ReadoutCard/ParameterTypes/GeneratorFault.h"
+#include "Utilities/Enum.h"
+
+namespace AliceO2 {
+namespace roc {
+namespace {
+
+static const auto converter = Utilities::makeEnumConverter<GeneratorFault::type>("GeneratorFault", {
+  { GeneratorFault::CorruptRdh,         "CORRUPT_RDH" },
+  { GeneratorFault::DropPage,           "DROP_PAGE" },
+  { GeneratorFault::ReadyQueueOverflow, "READY_QUEUE_OVERFLOW" },
+  { GeneratorFault::SkipPacketCounter,  "SKIP_PACKET_COUNTER" },
+  { GeneratorFault::StallLink,          "STALL_LINK" },
+});
+
+} // Anonymous namespace
+
+std::string GeneratorFault::toString(const GeneratorFault::type& fault)
+{
+  return converter.toString(fault);
+}
+
+GeneratorFault::type GeneratorFault::fromString(const std::string& string)
+{
+  return converter.fromString(string);
+}
+
+} // namespace roc
+} // namespace AliceO2
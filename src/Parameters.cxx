@@ -18,10 +18,12 @@ namespace AliceO2 {
 namespace roc {
 
 /// Variant used for internal storage of parameters
+/// Note: parameter types that are aliases of types already listed (e.g. GeneratorLinkRateMapType) must not be repeated
 using Variant = boost::variant<size_t, int32_t, bool, Parameters::BufferParametersType, Parameters::CardIdType,
   Parameters::GeneratorLoopbackType, Parameters::GeneratorPatternType, Parameters::ReadoutModeType,
   Parameters::LinkMaskType, Parameters::ClockType, Parameters::DatapathModeType, Parameters::DownstreamDataType,
-  Parameters::GbtModeType, Parameters::GbtMuxType, Parameters::GbtMuxMapType>;
+  Parameters::GbtModeType, Parameters::GbtMuxType, Parameters::GbtMuxMapType, Parameters::LinkSuperpageSizeMapType,
+  Parameters::DmaStopTimeoutType, Parameters::GeneratorFaultMapType, Parameters::ReplayFileType>;
 
 using KeyType = const char*;
 
@@ -117,6 +119,16 @@ _PARAMETER_FUNCTIONS(DownstreamData, "downstream_data")
 _PARAMETER_FUNCTIONS(GbtMode, "gbt_mode")
 _PARAMETER_FUNCTIONS(GbtMux, "gbt_mux")
 _PARAMETER_FUNCTIONS(GbtMuxMap, "gbt_mux_map")
+_PARAMETER_FUNCTIONS(CompanionCardId, "companion_card_id")
+_PARAMETER_FUNCTIONS(LinkSuperpageSizeMap, "link_superpage_size_map")
+_PARAMETER_FUNCTIONS(WarmStartEnabled, "warm_start_enabled")
+_PARAMETER_FUNCTIONS(DmaStopTimeout, "dma_stop_timeout")
+_PARAMETER_FUNCTIONS(GeneratorRate, "generator_rate")
+_PARAMETER_FUNCTIONS(GeneratorLinkRateMap, "generator_link_rate_map")
+_PARAMETER_FUNCTIONS(GeneratorFaultMap, "generator_fault_map")
+_PARAMETER_FUNCTIONS(GeneratorStallTime, "generator_stall_time")
+_PARAMETER_FUNCTIONS(ReplayFile, "replay_file")
+_PARAMETER_FUNCTIONS(ReplayPacingEnabled, "replay_pacing_enabled")
 #undef _PARAMETER_FUNCTIONS
 
 Parameters::Parameters() : mPimpl(std::make_unique<ParametersPimpl>())
@@ -207,5 +219,30 @@ auto Parameters::cardIdFromString(const std::string& string) -> CardIdType
   }
 }
 
+auto Parameters::generatorFaultMapFromString(const std::string& string) -> GeneratorFaultMapType
+{
+  GeneratorFaultMapType faults;
+
+  // Separate by comma, then fault and probability by colon
+  std::vector<std::string> commaSeparateds;
+  boost::split(commaSeparateds, string, boost::is_any_of(","));
+  for (const auto& commaSeparated : commaSeparateds) {
+    std::vector<std::string> colonSeparateds;
+    boost::split(colonSeparateds, commaSeparated, boost::is_any_of(":"));
+    if (colonSeparateds.size() != 2) {
+      BOOST_THROW_EXCEPTION(ParseException() << ErrorInfo::Message("Invalid generator fault string format"));
+    }
+    try {
+      faults[GeneratorFault::fromString(colonSeparateds[0])] = boost::lexical_cast<double>(colonSeparateds[1]);
+    }
+    catch (const std::exception& e) {
+      BOOST_THROW_EXCEPTION(
+        ParseException() << ErrorInfo::Message(std::string("Invalid generator fault string format: ") + e.what()));
+    }
+  }
+
+  return faults;
+}
+
 } // namespace roc
 } // namespace AliceO2
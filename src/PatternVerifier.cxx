@@ -0,0 +1,126 @@
+/// \file PatternVerifier.cxx
+/// \brief Implementation of functions for checking data generator patterns.
+
+#include "PatternVerifier.h"
+#include "Utilities/CpuFeatures.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ALICEO2_READOUTCARD_PATTERN_VERIFIER_AVX2
+#include <immintrin.h>
+#endif
+
+namespace AliceO2 {
+namespace roc {
+namespace PatternVerifier {
+namespace {
+constexpr uint32_t ALL = 0xffffffff;
+
+#ifdef ALICEO2_READOUTCARD_PATTERN_VERIFIER_AVX2
+/// Gets the lane of the first mismatch in a block, given the byte mask of a 32-bit compare
+inline size_t getMismatchLane(int equalMask)
+{
+  return __builtin_ctz(~uint32_t(equalMask)) / sizeof(uint32_t);
+}
+
+/// Compares whole blocks, starting at a block boundary
+/// \return Index of the first mismatching word, or the end of the last whole block
+__attribute__((target("avx2")))
+size_t findMismatchAvx2(const char* data, size_t begin, size_t end, const LinearPattern& pattern)
+{
+  // Counter values of the first block, computed like getExpected()
+  std::array<uint32_t, BLOCK_WORDS> first;
+  auto block = uint32_t(begin / BLOCK_WORDS);
+  for (size_t lane = 0; lane < BLOCK_WORDS; ++lane) {
+    first[lane] = pattern.base[lane] + block * pattern.step[lane];
+  }
+  auto counter = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first.data()));
+  const auto step = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern.step.data()));
+  const auto mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern.mask.data()));
+
+  size_t i = begin;
+  for (; (i + BLOCK_WORDS) <= end; i += BLOCK_WORDS) {
+    auto actual = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i * sizeof(uint32_t)));
+    auto equal = _mm256_movemask_epi8(_mm256_cmpeq_epi32(actual, _mm256_and_si256(counter, mask)));
+    if (equal != -1) {
+      return i + getMismatchLane(equal);
+    }
+    counter = _mm256_add_epi32(counter, step);
+  }
+  return i;
+}
+#endif
+
+LinearPattern makePattern(std::array<uint32_t, BLOCK_WORDS> base, std::array<uint32_t, BLOCK_WORDS> step,
+    std::array<uint32_t, BLOCK_WORDS> mask)
+{
+  LinearPattern pattern;
+  pattern.base = base;
+  pattern.step = step;
+  pattern.mask = mask;
+  return pattern;
+}
+} // Anonymous namespace
+
+LinearPattern makeConstantPattern(uint32_t value)
+{
+  LinearPattern pattern;
+  pattern.base.fill(value);
+  pattern.step.fill(0);
+  pattern.mask.fill(ALL);
+  return pattern;
+}
+
+LinearPattern makeWordCounterPattern(uint32_t first)
+{
+  LinearPattern pattern;
+  for (uint32_t lane = 0; lane < BLOCK_WORDS; ++lane) {
+    pattern.base[lane] = first + lane;
+  }
+  pattern.step.fill(BLOCK_WORDS);
+  pattern.mask.fill(ALL);
+  return pattern;
+}
+
+LinearPattern makeCruInternalPattern(uint32_t counter)
+{
+  LinearPattern pattern;
+  pattern.base.fill(counter);
+  pattern.step.fill(1);
+  pattern.mask.fill(ALL);
+  return pattern;
+}
+
+LinearPattern makeDdgPattern(uint32_t counter)
+{
+  // Two 128-bit words per block
+  auto c = counter;
+  return makePattern(
+      {{c, c, c, 0, c + 1, c + 1, c + 1, 0}},
+      {{2, 2, 2, 0, 2, 2, 2, 0}},
+      {{ALL, ALL, 0xffff, ALL, ALL, ALL, 0xffff, ALL}});
+}
+
+size_t findMismatch(const void* data, size_t begin, size_t end, const LinearPattern& pattern)
+{
+  size_t i = begin;
+#ifdef ALICEO2_READOUTCARD_PATTERN_VERIFIER_AVX2
+  if (Utilities::isAvx2Supported()) {
+    for (; (i < end) && (i % BLOCK_WORDS != 0); ++i) {
+      if (getWord(data, i) != pattern.getExpected(i)) {
+        return i;
+      }
+    }
+    i = findMismatchAvx2(reinterpret_cast<const char*>(data), i, end, pattern);
+  }
+#endif
+  for (; i < end; ++i) {
+    if (getWord(data, i) != pattern.getExpected(i)) {
+      return i;
+    }
+  }
+  return end;
+}
+
+} // namespace PatternVerifier
+} // namespace roc
+} // namespace AliceO2
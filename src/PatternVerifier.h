@@ -0,0 +1,72 @@
+/// \file PatternVerifier.h
+/// \brief Definition of functions for checking data generator patterns.
+
+#ifndef ALICEO2_SRC_READOUTCARD_PATTERNVERIFIER_H_
+#define ALICEO2_SRC_READOUTCARD_PATTERNVERIFIER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace AliceO2 {
+namespace roc {
+
+/// Functions for checking data against the patterns of the data generators.
+///
+/// The data is compared 256 bits at a time with AVX2 when the CPU supports it, and one 32-bit word at a time
+/// otherwise. The functions only find where the data differs; callers report the exact word and its expected value.
+namespace PatternVerifier
+{
+/// Number of 32-bit words in a block of the pattern
+constexpr size_t BLOCK_WORDS = 8;
+
+/// Pattern in which each word of a 256-bit block is a counter that grows by a fixed step every block, masked to its
+/// significant bits. Word i of the data is expected to be (base[i % 8] + (i / 8) * step[i % 8]) & mask[i % 8], with
+/// 32-bit wrap-around. This covers the counters and constants of the generators.
+struct LinearPattern
+{
+    std::array<uint32_t, BLOCK_WORDS> base;
+    std::array<uint32_t, BLOCK_WORDS> step;
+    std::array<uint32_t, BLOCK_WORDS> mask;
+
+    /// Gets the expected value of a word
+    uint32_t getExpected(size_t index) const
+    {
+      auto lane = index % BLOCK_WORDS;
+      auto block = uint32_t(index / BLOCK_WORDS);
+      return (base[lane] + block * step[lane]) & mask[lane];
+    }
+};
+
+/// Every word has the same value, as with the Constant and Alternating patterns
+LinearPattern makeConstantPattern(uint32_t value);
+
+/// Every word is one more than the previous, starting at the given value. This is the C-RORC Incremental pattern.
+LinearPattern makeWordCounterPattern(uint32_t first);
+
+/// 256-bit words filled with a counter that is incremented every 256-bit word. This is the CRU's internal PCIe pattern.
+LinearPattern makeCruInternalPattern(uint32_t counter);
+
+/// 128-bit words of counter, counter, 16 LSB of counter and 0, with the counter incremented every 128-bit word.
+/// This is the CRU's DDG pattern, which the dummy data generator emulates.
+LinearPattern makeDdgPattern(uint32_t counter);
+
+/// Finds the first word in [begin, end) that does not match a pattern
+/// \param data Data, starting with word 0 of the pattern
+/// \return Index of the word, or end if all words match
+size_t findMismatch(const void* data, size_t begin, size_t end, const LinearPattern& pattern);
+
+/// Gets a 32-bit word of the data
+inline uint32_t getWord(const void* data, size_t index)
+{
+  uint32_t word;
+  std::memcpy(&word, reinterpret_cast<const char*>(data) + index * sizeof(uint32_t), sizeof(word));
+  return word;
+}
+
+} // namespace PatternVerifier
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_SRC_READOUTCARD_PATTERNVERIFIER_H_
@@ -0,0 +1,173 @@
+/// \file TimeFrameBuilder.cxx
+/// \brief Implementation of the TimeFrameBuilder class.
+
+#include "ReadoutCard/TimeFrameBuilder.h"
+#include <algorithm>
+#include "ExceptionInternal.h"
+
+namespace AliceO2 {
+namespace roc {
+
+TimeFrameBuilder::TimeFrameBuilder(CardType::type cardType, const std::vector<uint32_t>& linkIds,
+    uint32_t orbitsPerTimeFrame, size_t maxOpenTimeFrames)
+    : mCardType(cardType), mOrbitsPerTimeFrame(orbitsPerTimeFrame), mMaxOpenTimeFrames(maxOpenTimeFrames),
+      mLinkIds(linkIds)
+{
+  if (cardType != CardType::Cru && cardType != CardType::Dummy) {
+    BOOST_THROW_EXCEPTION(ParameterException()
+        << ErrorInfo::Message("Time frames can only be built from CRU-format data")
+        << ErrorInfo::CardType(cardType));
+  }
+
+  if (linkIds.empty()) {
+    BOOST_THROW_EXCEPTION(ParameterException()
+        << ErrorInfo::Message("Time frames need at least one link"));
+  }
+
+  if (orbitsPerTimeFrame == 0) {
+    BOOST_THROW_EXCEPTION(ParameterException()
+        << ErrorInfo::Message("Time frames need at least one orbit"));
+  }
+
+  if (maxOpenTimeFrames == 0) {
+    BOOST_THROW_EXCEPTION(ParameterException()
+        << ErrorInfo::Message("At least one time frame must be allowed to be open"));
+  }
+
+  std::sort(mLinkIds.begin(), mLinkIds.end());
+  mLinkIds.erase(std::unique(mLinkIds.begin(), mLinkIds.end()), mLinkIds.end());
+}
+
+void TimeFrameBuilder::addSuperpage(const Superpage& superpage, const void* bufferAddress)
+{
+  auto sequenceNumber = mNextSequenceNumber++;
+  auto& referenced = mSuperpages.emplace(sequenceNumber, ReferencedSuperpage{superpage, 0}).first->second;
+
+  // Whatever happens to the packets, the superpage must not stay referenced without a time frame to release it
+  auto finish = [&]{
+    if (referenced.references == 0) {
+      mReleasedSuperpages.push_back(referenced.superpage);
+      mSuperpages.erase(sequenceNumber);
+    }
+    closeCompleted();
+  };
+
+  try {
+    for (const auto& packet : PacketRange(superpage, bufferAddress, mCardType, 0)) {
+      auto rdh = packet.getRdh();
+      auto linkId = rdh.getLinkId();
+      auto id = rdh.getHeartbeatOrbit() / mOrbitsPerTimeFrame;
+
+      if (std::binary_search(mLinkIds.begin(), mLinkIds.end(), linkId)) {
+        auto progress = mLinkProgress.emplace(linkId, id).first;
+        progress->second = std::max(progress->second, id);
+      }
+
+      auto open = mOpenTimeFrames.find(id);
+      if (open == mOpenTimeFrames.end()) {
+        // Opening a time frame may complete older ones, or push the oldest out
+        closeCompleted();
+        // A packet older than all open time frames must not push out a newer one, it would be dropped anyway
+        bool olderThanOpen = mOpenTimeFrames.size() >= mMaxOpenTimeFrames && !mOpenTimeFrames.empty()
+            && id < mOpenTimeFrames.begin()->first;
+        while (!olderThanOpen && id >= mNextTimeFrameId && mOpenTimeFrames.size() >= mMaxOpenTimeFrames) {
+          closeOldest(false);
+        }
+        if (olderThanOpen || id < mNextTimeFrameId) {
+          mDroppedPackets++;
+          continue;
+        }
+        open = mOpenTimeFrames.emplace(id, PendingTimeFrame()).first;
+        open->second.timeFrame.id = id;
+      }
+
+      auto& pending = open->second;
+      pending.timeFrame.links[linkId].push_back(packet);
+      if (pending.superpages.empty() || pending.superpages.back() != sequenceNumber) {
+        pending.superpages.push_back(sequenceNumber);
+        referenced.references++;
+      }
+    }
+  }
+  catch (const DataFormatException&) {
+    finish();
+    throw;
+  }
+  finish();
+}
+
+void TimeFrameBuilder::closeCompleted()
+{
+  if (mLinkProgress.size() < mLinkIds.size()) {
+    // Some links have not sent anything yet
+    return;
+  }
+
+  auto passed = std::min_element(mLinkProgress.begin(), mLinkProgress.end(),
+      [](const std::pair<const uint32_t, uint32_t>& a, const std::pair<const uint32_t, uint32_t>& b) {
+        return a.second < b.second;
+      })->second;
+
+  while (!mOpenTimeFrames.empty() && mOpenTimeFrames.begin()->first < passed) {
+    closeOldest(true);
+  }
+  mNextTimeFrameId = std::max(mNextTimeFrameId, passed);
+}
+
+void TimeFrameBuilder::closeOldest(bool complete)
+{
+  auto oldest = mOpenTimeFrames.begin();
+  oldest->second.timeFrame.complete = complete;
+  mNextTimeFrameId = oldest->first + 1;
+  mReadyTimeFrames.push_back(std::move(oldest->second));
+  mOpenTimeFrames.erase(oldest);
+}
+
+void TimeFrameBuilder::flush()
+{
+  while (!mOpenTimeFrames.empty()) {
+    closeOldest(false);
+  }
+}
+
+const TimeFrame& TimeFrameBuilder::getTimeFrame() const
+{
+  if (mReadyTimeFrames.empty()) {
+    BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Could not get time frame, none are ready"));
+  }
+  return mReadyTimeFrames.front().timeFrame;
+}
+
+void TimeFrameBuilder::popTimeFrame()
+{
+  if (mReadyTimeFrames.empty()) {
+    BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Could not pop time frame, none are ready"));
+  }
+  for (auto sequenceNumber : mReadyTimeFrames.front().superpages) {
+    dereference(sequenceNumber);
+  }
+  mReadyTimeFrames.pop_front();
+}
+
+void TimeFrameBuilder::dereference(uint64_t sequenceNumber)
+{
+  auto referenced = mSuperpages.find(sequenceNumber);
+  referenced->second.references--;
+  if (referenced->second.references == 0) {
+    mReleasedSuperpages.push_back(referenced->second.superpage);
+    mSuperpages.erase(referenced);
+  }
+}
+
+Superpage TimeFrameBuilder::popSuperpage()
+{
+  if (mReleasedSuperpages.empty()) {
+    BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Could not pop superpage, none were released"));
+  }
+  auto superpage = mReleasedSuperpages.front();
+  mReleasedSuperpages.pop_front();
+  return superpage;
+}
+
+} // namespace roc
+} // namespace AliceO2
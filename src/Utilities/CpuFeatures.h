@@ -0,0 +1,39 @@
+/// \file CpuFeatures.h
+/// \brief Functions for checking the instruction set extensions supported by the CPU
+
+#ifndef ALICEO2_SRC_READOUTCARD_UTILITIES_CPUFEATURES_H_
+#define ALICEO2_SRC_READOUTCARD_UTILITIES_CPUFEATURES_H_
+
+namespace AliceO2 {
+namespace roc {
+namespace Utilities {
+
+/// Checks if the CPU supports AVX2. Functions using it must be compiled with __attribute__((target("avx2"))).
+/// Always false on compilers or architectures without the GCC CPU detection builtins.
+inline bool isAvx2Supported()
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+#else
+  return false;
+#endif
+}
+
+/// Checks if the CPU supports SSE 4.2. Functions using it must be compiled with __attribute__((target("sse4.2"))).
+/// Always false on compilers or architectures without the GCC CPU detection builtins.
+inline bool isSse42Supported()
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  static const bool supported = __builtin_cpu_supports("sse4.2");
+  return supported;
+#else
+  return false;
+#endif
+}
+
+} // namespace Utilities
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_SRC_READOUTCARD_UTILITIES_CPUFEATURES_H_
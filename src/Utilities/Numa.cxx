@@ -4,8 +4,12 @@
 /// \author Pascal Boeschoten (pascal.boeschoten@cern.ch)
 
 #include "Numa.h"
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
 #include <fstream>
 #include <sstream>
+#include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
 #include "ExceptionInternal.h"
@@ -46,6 +50,56 @@ int getNumaNode(const PciAddress& pciAddress)
   return result;
 }
 
+std::vector<int> getNumaNodeCpus(int numaNode)
+{
+  auto string = slurp((b::format("/sys/devices/system/node/node%d/cpulist") % numaNode).str());
+  auto cpus = parseCpuList(b::trim_copy(string));
+  if (cpus.empty()) {
+    BOOST_THROW_EXCEPTION(Exception() << ErrorInfo::Message("Failed to get CPUs of numa node")
+        << ErrorInfo::Index(numaNode));
+  }
+  return cpus;
+}
+
+std::vector<int> parseCpuList(const std::string& cpuList)
+{
+  std::vector<int> cpus;
+  if (cpuList.empty()) {
+    return cpus;
+  }
+
+  std::vector<std::string> ranges;
+  b::split(ranges, cpuList, b::is_any_of(","));
+  for (const auto& range : ranges) {
+    std::vector<std::string> bounds;
+    b::split(bounds, range, b::is_any_of("-"));
+    int first = 0;
+    int last = 0;
+    if (bounds.size() > 2 || !b::conversion::try_lexical_convert<int>(bounds.front(), first)
+        || !b::conversion::try_lexical_convert<int>(bounds.back(), last) || first < 0 || last < first) {
+      BOOST_THROW_EXCEPTION(ParseException() << ErrorInfo::Message("Failed to parse CPU list '" + cpuList + "'"));
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+void setThreadAffinity(const std::vector<int>& cpus)
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (error != 0) {
+    BOOST_THROW_EXCEPTION(Exception()
+        << ErrorInfo::Message(std::string("Failed to set thread affinity: ") + std::strerror(error)));
+  }
+}
+
 } // namespace Util
 } // namespace roc
 } // namespace AliceO2
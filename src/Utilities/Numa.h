@@ -6,6 +6,8 @@
 #ifndef ALICEO2_SRC_READOUTCARD_UTILITIES_NUMA_H_
 #define ALICEO2_SRC_READOUTCARD_UTILITIES_NUMA_H_
 
+#include <string>
+#include <vector>
 #include "ReadoutCard/ParameterTypes/PciAddress.h"
 
 namespace AliceO2 {
@@ -14,6 +16,15 @@ namespace Utilities {
 
 int getNumaNode(const PciAddress& pciAddress);
 
+/// Gets the CPUs of a NUMA node
+std::vector<int> getNumaNodeCpus(int numaNode);
+
+/// Parses a CPU list in the format of the kernel, e.g. "0-3,8,10-11"
+std::vector<int> parseCpuList(const std::string& cpuList);
+
+/// Restricts the calling thread to the given CPUs. Threads it creates afterwards inherit this.
+void setThreadAffinity(const std::vector<int>& cpus);
+
 } // namespace Util
 } // namespace roc
 } // namespace AliceO2
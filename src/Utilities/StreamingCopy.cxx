@@ -0,0 +1,75 @@
+/// \file StreamingCopy.cxx
+/// \brief Implementation of memory copy functions with non-temporal stores
+
+#include "Utilities/StreamingCopy.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include "Utilities/CpuFeatures.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ALICEO2_READOUTCARD_STREAMING_COPY_AVX2
+#include <immintrin.h>
+#endif
+
+namespace AliceO2 {
+namespace roc {
+namespace Utilities {
+namespace {
+#ifdef ALICEO2_READOUTCARD_STREAMING_COPY_AVX2
+/// Below this size, the setup for aligned streaming stores costs more than it saves
+constexpr size_t MIN_STREAMING_SIZE = 256;
+
+__attribute__((target("avx2")))
+void streamingCopyAvx2(char* destination, const char* source, size_t size)
+{
+  // Copy up to the first 32-byte aligned destination address normally, then stream whole 32-byte blocks
+  auto head = (32 - (reinterpret_cast<uintptr_t>(destination) % 32)) % 32;
+  std::memcpy(destination, source, head);
+  destination += head;
+  source += head;
+  size -= head;
+
+  size_t i = 0;
+  for (; (i + 128) <= size; i += 128) {
+    auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+    auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i + 32));
+    auto c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i + 64));
+    auto d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i + 96));
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(destination + i), a);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(destination + i + 32), b);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(destination + i + 64), c);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(destination + i + 96), d);
+  }
+  for (; (i + 32) <= size; i += 32) {
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(destination + i),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i)));
+  }
+  std::memcpy(destination + i, source + i, size - i);
+}
+#endif
+} // Anonymous namespace
+
+void streamingCopy(char* destination, const char* source, size_t size)
+{
+#ifdef ALICEO2_READOUTCARD_STREAMING_COPY_AVX2
+  if (size >= MIN_STREAMING_SIZE && isAvx2Supported()) {
+    streamingCopyAvx2(destination, source, size);
+    return;
+  }
+#endif
+  std::memcpy(destination, source, size);
+}
+
+void streamingCopyFence()
+{
+#ifdef ALICEO2_READOUTCARD_STREAMING_COPY_AVX2
+  _mm_sfence();
+#else
+  std::atomic_thread_fence(std::memory_order_release);
+#endif
+}
+
+} // namespace Utilities
+} // namespace roc
+} // namespace AliceO2
@@ -0,0 +1,25 @@
+/// \file StreamingCopy.h
+/// \brief Definition of memory copy functions with non-temporal stores
+
+#ifndef ALICEO2_SRC_READOUTCARD_UTILITIES_STREAMINGCOPY_H_
+#define ALICEO2_SRC_READOUTCARD_UTILITIES_STREAMINGCOPY_H_
+
+#include <cstddef>
+
+namespace AliceO2 {
+namespace roc {
+namespace Utilities {
+
+/// Copies memory with non-temporal stores, which bypass the caches, if the CPU supports AVX2. Otherwise it's a memcpy.
+/// For copies of data that won't be read again soon, such as DMA payloads, so they don't evict more useful data.
+/// The stores are weakly ordered: call streamingCopyFence() before handing the data to another thread.
+void streamingCopy(char* destination, const char* source, size_t size);
+
+/// Orders the stores of earlier streamingCopy() calls before any later stores
+void streamingCopyFence();
+
+} // namespace Utilities
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_SRC_READOUTCARD_UTILITIES_STREAMINGCOPY_H_
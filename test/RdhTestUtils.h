@@ -0,0 +1,32 @@
+/// \file RdhTestUtils.h
+/// \brief Helpers for writing CRU-format packets in tests
+
+#ifndef ALICEO2_READOUTCARD_TEST_RDHTESTUTILS_H_
+#define ALICEO2_READOUTCARD_TEST_RDHTESTUTILS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "ReadoutCard/Rdh.h"
+
+namespace AliceO2 {
+namespace roc {
+namespace RdhTestUtils {
+
+/// Writes a version 4 RDH with the given fields, and all other fields zero. Other fields can be set afterwards with
+/// setRdhField().
+inline void writeRdh(char* page, size_t memorySize, size_t offsetToNext, uint32_t linkId)
+{
+  std::memset(page, 0, RDH_SIZE);
+  setRdhField(page, RDH_VERSION_FIELD, 4);
+  setRdhField(page, RDH_LAYOUT_V4.headerSize, RDH_SIZE);
+  setRdhField(page, RDH_LAYOUT_V4.memorySize, memorySize);
+  setRdhField(page, RDH_LAYOUT_V4.offsetToNext, offsetToNext);
+  setRdhField(page, RDH_LAYOUT_V4.linkId, linkId);
+}
+
+} // namespace RdhTestUtils
+} // namespace roc
+} // namespace AliceO2
+
+#endif // ALICEO2_READOUTCARD_TEST_RDHTESTUTILS_H_
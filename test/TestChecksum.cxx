@@ -0,0 +1,127 @@
+/// \file TestChecksum.cxx
+/// \brief Test of the CRC32C checksum functions
+
+#define BOOST_TEST_MODULE RORC_TestChecksum
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <random>
+#include <string>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "ReadoutCard/ChannelFactory.h"
+#include "ReadoutCard/Checksum.h"
+#include "ReadoutCard/Rdh.h"
+#include "RdhTestUtils.h"
+
+using namespace ::AliceO2::roc;
+using RdhTestUtils::writeRdh;
+
+namespace {
+
+/// Bit-by-bit CRC32C, to check the fast implementations against
+uint32_t referenceCrc32c(const char* data, size_t size)
+{
+  uint32_t crc = ~uint32_t(0);
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= uint8_t(data[i]);
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 1) ? ((crc >> 1) ^ 0x82f63b78) : (crc >> 1);
+    }
+  }
+  return ~crc;
+}
+
+std::vector<char> makeRandomData(size_t size)
+{
+  std::mt19937 random(42);
+  std::vector<char> data(size);
+  for (auto& byte : data) {
+    byte = char(random());
+  }
+  return data;
+}
+
+BOOST_AUTO_TEST_CASE(KnownValues)
+{
+  std::string check = "123456789";
+  BOOST_CHECK_EQUAL(crc32c(check.data(), check.size()), 0xe3069283);
+  BOOST_CHECK_EQUAL(crc32c(nullptr, 0), 0);
+
+  std::vector<char> zeros(32, 0);
+  BOOST_CHECK_EQUAL(crc32c(zeros.data(), zeros.size()), 0x8a9136aa);
+}
+
+BOOST_AUTO_TEST_CASE(MatchesReference)
+{
+  auto data = makeRandomData(20000);
+  // Sizes and alignments around the blocks of the interleaved computation
+  for (size_t size : {1, 7, 8, 9, 1000, 3071, 3072, 3073, 6144, 10000, 19990}) {
+    for (size_t offset : {0, 1, 5}) {
+      BOOST_CHECK_EQUAL(crc32c(data.data() + offset, size), referenceCrc32c(data.data() + offset, size));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(InParts)
+{
+  auto data = makeRandomData(10000);
+  auto whole = crc32c(data.data(), data.size());
+  auto crc = crc32c(data.data(), 3333);
+  crc = crc32c(data.data() + 3333, 5000, crc);
+  crc = crc32c(data.data() + 8333, data.size() - 8333, crc);
+  BOOST_CHECK_EQUAL(crc, whole);
+}
+
+BOOST_AUTO_TEST_CASE(SuperpageAndPackets)
+{
+  constexpr size_t PAGE_SIZE = 1024;
+  auto buffer = makeRandomData(4 * PAGE_SIZE);
+  for (size_t i = 0; i < 3; ++i) {
+    auto page = buffer.data() + PAGE_SIZE + i * PAGE_SIZE;
+    writeRdh(page, RDH_SIZE + 100 * i, PAGE_SIZE, 0);
+  }
+
+  // Superpage at an offset in the buffer
+  Superpage superpage(PAGE_SIZE, 3 * PAGE_SIZE);
+  superpage.setReceived(3 * PAGE_SIZE);
+  BOOST_CHECK(!superpage.hasChecksum());
+  auto checksum = checksumSuperpage(superpage, buffer.data());
+  BOOST_CHECK(superpage.hasChecksum());
+  BOOST_CHECK_EQUAL(superpage.getChecksum(), checksum);
+  BOOST_CHECK_EQUAL(checksum, referenceCrc32c(buffer.data() + PAGE_SIZE, 3 * PAGE_SIZE));
+
+  std::vector<uint32_t> checksums;
+  checksumPackets(superpage, buffer.data(), CardType::Cru, PAGE_SIZE, checksums);
+  BOOST_REQUIRE_EQUAL(checksums.size(), 3);
+  for (size_t i = 0; i < 3; ++i) {
+    BOOST_CHECK_EQUAL(checksums[i], referenceCrc32c(buffer.data() + PAGE_SIZE + i * PAGE_SIZE, RDH_SIZE + 100 * i));
+  }
+
+  superpage.clearChecksum();
+  BOOST_CHECK(!superpage.hasChecksum());
+}
+
+BOOST_AUTO_TEST_CASE(PushedAgain)
+{
+  constexpr size_t SUPERPAGE_SIZE = 32 * 1024;
+  std::vector<char> buffer(SUPERPAGE_SIZE);
+  auto parameters = Parameters::makeParameters(ChannelFactory::getDummySerialNumber(), 0)
+    .setBufferParameters(buffer_parameters::Memory{buffer.data(), buffer.size()});
+  auto channel = ChannelFactory().getDmaChannel(parameters);
+  channel->startDma();
+
+  channel->pushSuperpage(Superpage(0, SUPERPAGE_SIZE));
+  channel->fillSuperpages();
+  BOOST_REQUIRE_EQUAL(channel->getReadyQueueSize(), 1);
+  auto superpage = channel->popSuperpage();
+  checksumSuperpage(superpage, buffer.data());
+
+  // The superpage comes back from the channel without the checksum of its previous fill
+  channel->pushSuperpage(superpage);
+  channel->fillSuperpages();
+  BOOST_REQUIRE_EQUAL(channel->getReadyQueueSize(), 1);
+  BOOST_CHECK(!channel->popSuperpage().hasChecksum());
+  channel->stopDma();
+}
+
+} // Anonymous namespace
@@ -0,0 +1,143 @@
+/// \file TestCrorcBarEmulator.cxx
+/// \brief Tests of the CrorcBarEmulator class, and of the CrorcDmaChannel running on it
+
+#define BOOST_TEST_MODULE RORC_TestCrorcBarEmulator
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "Crorc/Constants.h"
+#include "Crorc/CrorcBarEmulator.h"
+#include "Crorc/ReadyFifo.h"
+#include "Crorc/StWord.h"
+#include "ReadoutCard/ChannelFactory.h"
+
+using namespace ::AliceO2::roc;
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 8 * 1024;
+constexpr size_t SUPERPAGE_SIZE = 1024 * 1024;
+constexpr size_t SUPERPAGES = 4;
+
+BOOST_AUTO_TEST_CASE(DdlCommands)
+{
+  auto emulator = CrorcBarEmulator::getInstance(3);
+  BOOST_CHECK(emulator == CrorcBarEmulator::getInstance(3));
+
+  // Reading the DIU interface status gives an IFSTW and a CTSTW with the same destination and transaction ID
+  emulator->writeRegister(Rorc::C_DCR, Ddl::Destination::DIU | (Ddl::RandCIFST << 4) | (5 << 8));
+  BOOST_CHECK(emulator->readRegister(Rorc::C_CSR) & Rorc::CcsrStatus::RXSTAT_NOT_EMPTY);
+  StWord status;
+  status.stw = emulator->readRegister(Rorc::C_DSR);
+  BOOST_CHECK(status.part.code == Rorc::IFSTW);
+  BOOST_CHECK(status.part.trid == 5);
+  BOOST_CHECK(status.part.dest == Ddl::Destination::DIU);
+  status.stw = emulator->readRegister(Rorc::C_DSR);
+  BOOST_CHECK(status.part.code == Rorc::CTSTW);
+  BOOST_CHECK(!(emulator->readRegister(Rorc::C_CSR) & Rorc::CcsrStatus::RXSTAT_NOT_EMPTY));
+  BOOST_CHECK(!(emulator->readRegister(Rorc::C_CSR) & Rorc::CcsrStatus::LINK_DOWN));
+}
+
+BOOST_AUTO_TEST_CASE(FreeFifoToReadyFifo)
+{
+  std::vector<uint32_t> pages(2 * PAGE_SIZE / sizeof(uint32_t));
+  ReadyFifo readyFifo;
+  readyFifo.reset();
+  auto readyFifoAddress = reinterpret_cast<uintptr_t>(&readyFifo);
+  auto emulator = CrorcBarEmulator::getInstance(0);
+
+  auto pushPage = [&](int index) {
+    auto address = reinterpret_cast<uintptr_t>(pages.data()) + index * PAGE_SIZE;
+    emulator->writeRegister(Rorc::C_RAFX, address >> 32);
+    emulator->writeRegister(Rorc::C_RAFH, address & 0xffffffff);
+    emulator->writeRegister(Rorc::C_RAFL, ((PAGE_SIZE / 4) << 8) | index);
+  };
+
+  BOOST_CHECK(emulator->readRegister(Rorc::C_CSR) & Rorc::CcsrStatus::RXAFF_EMPTY);
+  pushPage(0);
+  pushPage(1);
+  BOOST_CHECK(!(emulator->readRegister(Rorc::C_CSR) & Rorc::CcsrStatus::RXAFF_EMPTY));
+
+  // Nothing arrives before the receiver, the loopback and the data generator are on
+  emulator->writeRegister(Rorc::C_RRBAR, readyFifoAddress & 0xffffffff);
+  emulator->writeRegister(Rorc::C_RRBX, readyFifoAddress >> 32);
+  emulator->writeRegister(Rorc::C_CSR, Rorc::CcsrCommand::DATA_RX_ON_OFF);
+  emulator->writeRegister(Rorc::C_CSR, Rorc::CcsrCommand::LOOPB_ON_OFF);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  BOOST_CHECK(readyFifo.entries[1].status == -1);
+
+  emulator->writeRegister(Rorc::C_DG1, (((PAGE_SIZE / 4) - 1) << 4) | GeneratorPattern::Incremental);
+  emulator->writeRegister(Rorc::C_DG2, 0);
+  emulator->writeRegister(Rorc::C_DG3, 42);
+  emulator->writeRegister(Rorc::C_DG4, 0x80000000);
+  emulator->writeRegister(Rorc::C_CSR, Rorc::CcsrCommand::START_DG);
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (readyFifo.entries[1].status == -1 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    BOOST_CHECK(readyFifo.entries[i].length == PAGE_SIZE / 4);
+    BOOST_CHECK((readyFifo.entries[i].status & 0xff) == Ddl::DTSW);
+    BOOST_CHECK((readyFifo.entries[i].status >> 12) == PAGE_SIZE / 4);
+    auto page = pages.data() + i * PAGE_SIZE / sizeof(uint32_t);
+    BOOST_CHECK(page[0] == uint32_t(42 + i));
+    BOOST_CHECK(page[8] == 7);
+    BOOST_CHECK(page[PAGE_SIZE / 4 - 1] == PAGE_SIZE / 4 - 2);
+  }
+  BOOST_CHECK(emulator->readRegister(Rorc::C_CSR) & Rorc::CcsrStatus::RXAFF_EMPTY);
+
+  emulator->writeRegister(Rorc::RCSR, Rorc::RcsrCommand::RESET_CHAN);
+  BOOST_CHECK(!(emulator->readRegister(Rorc::C_CSR) & Rorc::CcsrCommand::DATA_RX_ON_OFF));
+}
+
+BOOST_AUTO_TEST_CASE(EmulatedDmaChannel)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE * SUPERPAGES);
+  auto parameters = Parameters::makeParameters(ChannelFactory::getCrorcEmulatorSerialNumber(), 1)
+    .setBufferParameters(buffer_parameters::Memory{buffer.data(), buffer.size()})
+    .setDmaPageSize(PAGE_SIZE);
+
+  auto channel = ChannelFactory().getDmaChannel(parameters);
+  BOOST_CHECK(channel->getCardType() == CardType::Crorc);
+  channel->startDma();
+
+  for (size_t i = 0; i < SUPERPAGES; ++i) {
+    Superpage superpage;
+    superpage.setOffset(i * SUPERPAGE_SIZE);
+    superpage.setSize(SUPERPAGE_SIZE);
+    channel->pushSuperpage(superpage);
+  }
+
+  std::vector<Superpage> superpages;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (superpages.size() < SUPERPAGES && std::chrono::steady_clock::now() < deadline) {
+    channel->fillSuperpages();
+    while (channel->getReadyQueueSize() > 0) {
+      superpages.push_back(channel->popSuperpage());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  channel->stopDma();
+
+  BOOST_REQUIRE(superpages.size() == SUPERPAGES);
+
+  // The pages arrive in order, so the event numbers continue from one superpage to the next
+  uint32_t eventNumber = 0;
+  for (const auto& superpage : superpages) {
+    BOOST_CHECK(superpage.isReady());
+    BOOST_CHECK(superpage.getReceived() == SUPERPAGE_SIZE);
+    for (size_t offset = 0; offset < SUPERPAGE_SIZE; offset += PAGE_SIZE) {
+      auto page = reinterpret_cast<const uint32_t*>(buffer.data() + superpage.getOffset() + offset);
+      BOOST_CHECK(page[0] == eventNumber);
+      BOOST_CHECK(page[8] == 7);
+      eventNumber++;
+    }
+  }
+}
+
+} // Anonymous namespace
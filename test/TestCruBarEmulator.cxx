@@ -0,0 +1,430 @@
+/// \file TestCruBarEmulator.cxx
+/// \brief Tests of the CruBarEmulator class, and of the CruDmaChannel running on it
+
+#define BOOST_TEST_MODULE RORC_TestCruBarEmulator
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "Cru/Constants.h"
+#include "Cru/CruBar.h"
+#include "Cru/CruBarEmulator.h"
+#include "Cru/DataFormat.h"
+#include "ReadoutCard/ChannelFactory.h"
+
+using namespace ::AliceO2::roc;
+
+namespace {
+
+constexpr size_t SUPERPAGE_SIZE = 32 * 1024;
+constexpr size_t SUPERPAGES = 8;
+
+Parameters makeChannelParameters(std::vector<char>& buffer, const std::set<uint32_t>& linkMask)
+{
+  return Parameters::makeParameters(ChannelFactory::getCruEmulatorSerialNumber(), 0)
+    .setBufferParameters(buffer_parameters::Memory{buffer.data(), buffer.size()})
+    .setLinkMask(linkMask);
+}
+
+/// Holds or releases the data flow of the emulated firmware, so the superpages in flight can be looked at
+void setFirmwarePaused(bool paused)
+{
+  CruBarEmulator::getInstance(ChannelFactory::getCruEmulatorSerialNumber(), 0)
+    ->writeRegister(Cru::Registers::DMA_CONTROL.index, paused ? 0x0 : 0x1);
+}
+
+Superpage makeSuperpage(size_t index, size_t size = SUPERPAGE_SIZE)
+{
+  Superpage superpage;
+  superpage.setOffset(index * size);
+  superpage.setSize(size);
+  return superpage;
+}
+
+/// Pops superpages until the given amount arrived, or a few seconds passed
+std::vector<Superpage> popSuperpages(DmaChannelInterface& channel, size_t count)
+{
+  std::vector<Superpage> superpages;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (superpages.size() < count && std::chrono::steady_clock::now() < deadline) {
+    channel.fillSuperpages();
+    while (channel.getReadyQueueSize() > 0) {
+      superpages.push_back(channel.popSuperpage());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return superpages;
+}
+
+/// Pushes superpages into the given part of the buffer, and pops them once they arrived
+/// \return The superpages that arrived
+std::vector<Superpage> transferSuperpages(DmaChannelInterface& channel, size_t first, size_t count)
+{
+  for (size_t i = first; i < first + count; ++i) {
+    channel.pushSuperpage(makeSuperpage(i));
+  }
+  return popSuperpages(channel, count);
+}
+
+BOOST_AUTO_TEST_CASE(RegisterFile)
+{
+  auto serial = ChannelFactory::getCruEmulatorSerialNumber();
+  auto emulator = CruBarEmulator::getInstance(serial, 2);
+  BOOST_CHECK(emulator == CruBarEmulator::getInstance(serial, 2));
+  // The endpoints of the emulated CRU have their own registers
+  auto companion = CruBarEmulator::getInstance(ChannelFactory::getCruEmulatorCompanionSerialNumber(), 2);
+  BOOST_CHECK(emulator != companion);
+
+  emulator->writeRegister(Cru::Registers::FIRMWARE_GIT_HASH.index, 0x12345678);
+  BOOST_CHECK(emulator->readRegister(Cru::Registers::FIRMWARE_GIT_HASH.index) == 0x12345678);
+  emulator->modifyRegister(Cru::Registers::FIRMWARE_GIT_HASH.index, 0, 8, 0xab);
+  BOOST_CHECK(emulator->readRegister(Cru::Registers::FIRMWARE_GIT_HASH.index) == 0x123456ab);
+  BOOST_CHECK(companion->readRegister(Cru::Registers::FIRMWARE_GIT_HASH.index) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(SuperpageDescriptors)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE);
+  auto parameters = Parameters::makeParameters(ChannelFactory::getCruEmulatorSerialNumber(), 0);
+  CruBar bar(parameters, CruBarEmulator::getInstance(ChannelFactory::getCruEmulatorSerialNumber(), 0));
+
+  bar.resetCard();
+  bar.setDataGeneratorPattern(GeneratorPattern::Incremental, Cru::DMA_PAGE_SIZE, false);
+  bar.setDataSource(Cru::Registers::DATA_SOURCE_SELECT_INTERNAL);
+  bar.pushSuperpageDescriptor(5, SUPERPAGE_SIZE / Cru::DMA_PAGE_SIZE, reinterpret_cast<uintptr_t>(buffer.data()));
+
+  // Nothing arrives before the DMA is enabled
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  BOOST_CHECK(bar.getSuperpageCount(5) == 0);
+
+  bar.setDataEmulatorEnabled(true);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (bar.getSuperpageCount(5) == 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  bar.setDataEmulatorEnabled(false);
+
+  BOOST_REQUIRE(bar.getSuperpageCount(5) == 1);
+  for (size_t offset = 0; offset < SUPERPAGE_SIZE; offset += Cru::DMA_PAGE_SIZE) {
+    auto page = buffer.data() + offset;
+    BOOST_CHECK(Cru::DataFormat::getLinkId(page) == 5);
+    BOOST_CHECK(Cru::DataFormat::getEventSize(page) == Cru::DMA_PAGE_SIZE);
+    BOOST_CHECK(Cru::DataFormat::getPacketCounter(page) == offset / Cru::DMA_PAGE_SIZE);
+  }
+
+  bar.resetCard();
+  BOOST_CHECK(bar.getSuperpageCount(5) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(EmulatedDmaChannel)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE * SUPERPAGES);
+  auto parameters = Parameters::makeParameters(ChannelFactory::getCruEmulatorSerialNumber(), 0)
+    .setBufferParameters(buffer_parameters::Memory{buffer.data(), buffer.size()})
+    .setLinkMask({0, 1});
+
+  auto channel = ChannelFactory().getDmaChannel(parameters);
+  BOOST_CHECK(channel->getCardType() == CardType::Cru);
+  channel->startDma();
+
+  for (size_t i = 0; i < SUPERPAGES; ++i) {
+    Superpage superpage;
+    superpage.setOffset(i * SUPERPAGE_SIZE);
+    superpage.setSize(SUPERPAGE_SIZE);
+    channel->pushSuperpage(superpage);
+  }
+
+  std::vector<Superpage> superpages;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (superpages.size() < SUPERPAGES && std::chrono::steady_clock::now() < deadline) {
+    channel->fillSuperpages();
+    while (channel->getReadyQueueSize() > 0) {
+      superpages.push_back(channel->popSuperpage());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  channel->stopDma();
+
+  BOOST_REQUIRE(superpages.size() == SUPERPAGES);
+
+  // Superpages arrive in order per link, so the packet counters continue from one superpage to the next
+  std::map<uint32_t, uint32_t> packetCounters;
+  for (const auto& superpage : superpages) {
+    BOOST_CHECK(superpage.isReady());
+    BOOST_CHECK(superpage.getReceived() == SUPERPAGE_SIZE);
+    for (size_t offset = 0; offset < SUPERPAGE_SIZE; offset += Cru::DMA_PAGE_SIZE) {
+      auto page = buffer.data() + superpage.getOffset() + offset;
+      auto linkId = Cru::DataFormat::getLinkId(page);
+      BOOST_REQUIRE(linkId == 0 || linkId == 1);
+      BOOST_CHECK(Cru::DataFormat::getPacketCounter(page) == packetCounters[linkId]);
+      packetCounters[linkId] = (packetCounters[linkId] + 1) & 0xff;
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DisabledLink)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE * SUPERPAGES);
+  auto channel = ChannelFactory().getDmaChannel(makeChannelParameters(buffer, {0, 1}));
+  CruBar bar(Parameters::makeParameters(ChannelFactory::getCruEmulatorSerialNumber(), 0),
+      CruBarEmulator::getInstance(ChannelFactory::getCruEmulatorSerialNumber(), 0));
+  channel->startDma();
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), 2 * Cru::MAX_SUPERPAGE_DESCRIPTORS);
+
+  // A link without superpages in flight is gone right away, with its slots
+  BOOST_CHECK(channel->disableLink(1));
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), Cru::MAX_SUPERPAGE_DESCRIPTORS);
+  BOOST_CHECK_EQUAL(channel->getLinkTransferQueueAvailable(1), 0);
+  BOOST_CHECK_THROW(channel->pushLinkSuperpage(1, makeSuperpage(0)), InvalidLinkId);
+  BOOST_CHECK_THROW(channel->disableLink(1), InvalidLinkId);
+
+  // Superpages without a link go to the enabled one only
+  for (size_t i = 0; i < SUPERPAGES; ++i) {
+    channel->pushSuperpage(makeSuperpage(i));
+  }
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), Cru::MAX_SUPERPAGE_DESCRIPTORS - SUPERPAGES);
+  BOOST_CHECK_EQUAL(popSuperpages(*channel, SUPERPAGES).size(), SUPERPAGES);
+  BOOST_CHECK_EQUAL(bar.getSuperpageCount(0), SUPERPAGES);
+  BOOST_CHECK_EQUAL(bar.getSuperpageCount(1), 0);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), Cru::MAX_SUPERPAGE_DESCRIPTORS);
+  channel->stopDma();
+}
+
+BOOST_AUTO_TEST_CASE(ReenabledLink)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE * SUPERPAGES);
+  auto channel = ChannelFactory().getDmaChannel(makeChannelParameters(buffer, {0, 1}));
+  CruBar bar(Parameters::makeParameters(ChannelFactory::getCruEmulatorSerialNumber(), 0),
+      CruBarEmulator::getInstance(ChannelFactory::getCruEmulatorSerialNumber(), 0));
+  channel->startDma();
+  setFirmwarePaused(true);
+
+  constexpr size_t IN_FLIGHT = 4;
+  for (size_t i = 0; i < IN_FLIGHT; ++i) {
+    channel->pushLinkSuperpage(1, makeSuperpage(i));
+  }
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), 2 * Cru::MAX_SUPERPAGE_DESCRIPTORS - IN_FLIGHT);
+
+  // A draining link takes no new superpages, and its free slots don't count
+  BOOST_CHECK(channel->disableLink(1));
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), Cru::MAX_SUPERPAGE_DESCRIPTORS);
+  BOOST_CHECK_EQUAL(channel->getLinkTransferQueueAvailable(1), 0);
+  BOOST_CHECK_THROW(channel->pushLinkSuperpage(1, makeSuperpage(IN_FLIGHT)), InvalidLinkId);
+
+  // Re-enabling it while draining keeps the superpages in flight
+  BOOST_CHECK(channel->enableLink(1));
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), 2 * Cru::MAX_SUPERPAGE_DESCRIPTORS - IN_FLIGHT);
+  BOOST_CHECK_EQUAL(channel->getLinkTransferQueueAvailable(1), Cru::MAX_SUPERPAGE_DESCRIPTORS - IN_FLIGHT);
+
+  // Once drained, the link is removed and the slots of its arrivals are not given back
+  BOOST_CHECK(channel->disableLink(1));
+  setFirmwarePaused(false);
+  auto superpages = popSuperpages(*channel, IN_FLIGHT);
+  BOOST_REQUIRE_EQUAL(superpages.size(), IN_FLIGHT);
+  for (size_t i = 0; i < IN_FLIGHT; ++i) {
+    BOOST_CHECK_EQUAL(superpages[i].getOffset(), makeSuperpage(i).getOffset());
+    BOOST_CHECK(superpages[i].isReady());
+  }
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), Cru::MAX_SUPERPAGE_DESCRIPTORS);
+  BOOST_CHECK_THROW(channel->disableLink(1), InvalidLinkId);
+
+  // Enabled again mid-run, it continues from the firmware's superpage counter
+  BOOST_CHECK(channel->enableLink(1));
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), 2 * Cru::MAX_SUPERPAGE_DESCRIPTORS);
+  for (size_t i = 0; i < IN_FLIGHT; ++i) {
+    channel->pushLinkSuperpage(1, makeSuperpage(i));
+  }
+  BOOST_CHECK_EQUAL(popSuperpages(*channel, IN_FLIGHT).size(), IN_FLIGHT);
+  BOOST_CHECK_EQUAL(bar.getSuperpageCount(1), 2 * IN_FLIGHT);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), 2 * Cru::MAX_SUPERPAGE_DESCRIPTORS);
+  channel->stopDma();
+}
+
+BOOST_AUTO_TEST_CASE(MixedSuperpageSizes)
+{
+  constexpr size_t SMALL = SUPERPAGE_SIZE;
+  constexpr size_t LARGE = 2 * SUPERPAGE_SIZE;
+  constexpr size_t SLOTS = Cru::MAX_SUPERPAGE_DESCRIPTORS;
+  std::vector<char> buffer(SLOTS * (SMALL + LARGE));
+  auto channel = ChannelFactory().getDmaChannel(makeChannelParameters(buffer, {0, 1})
+      .setLinkSuperpageSizeMap({{0, SMALL}, {1, LARGE}}));
+  channel->startDma();
+  setFirmwarePaused(true);
+
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), 2 * SLOTS);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailableForSize(SMALL), SLOTS);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailableForSize(LARGE), SLOTS);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailableForSize(SMALL / 2), 0);
+
+  // Once the large superpage link is full, there are still free slots, but none for a large superpage
+  size_t pushed = 0;
+  while (channel->getTransferQueueAvailableForSize(LARGE) > 0) {
+    channel->pushSuperpage(makeSuperpage(pushed++, LARGE));
+  }
+  BOOST_CHECK_EQUAL(pushed, SLOTS);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), SLOTS);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailableForSize(SMALL), SLOTS);
+  BOOST_CHECK_THROW(channel->pushSuperpage(makeSuperpage(0, LARGE)), Exception);
+
+  // The small superpages still go through, after the large ones in the buffer
+  pushed = 0;
+  while (channel->getTransferQueueAvailableForSize(SMALL) > 0) {
+    channel->pushSuperpage(makeSuperpage(2 * SLOTS + pushed++, SMALL));
+  }
+  BOOST_CHECK_EQUAL(pushed, SLOTS);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), 0);
+
+  // Arrivals give the slots back to the link that accepts their size
+  setFirmwarePaused(false);
+  auto superpages = popSuperpages(*channel, 2 * SLOTS);
+  BOOST_CHECK_EQUAL(superpages.size(), 2 * SLOTS);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailableForSize(SMALL), SLOTS);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailableForSize(LARGE), SLOTS);
+  for (const auto& superpage : superpages) {
+    auto page = buffer.data() + superpage.getOffset();
+    BOOST_CHECK_EQUAL(Cru::DataFormat::getLinkId(page), (superpage.getSize() == SMALL) ? 0 : 1);
+  }
+  channel->stopDma();
+}
+
+BOOST_AUTO_TEST_CASE(ColdStart)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE * SUPERPAGES);
+  auto channel = ChannelFactory().getDmaChannel(makeChannelParameters(buffer, {0}));
+  CruBar bar(Parameters::makeParameters(ChannelFactory::getCruEmulatorSerialNumber(), 0),
+      CruBarEmulator::getInstance(ChannelFactory::getCruEmulatorSerialNumber(), 0));
+
+  // Without warm start, every start resets the card, and with it the superpage counters
+  for (int run = 0; run < 2; ++run) {
+    channel->startDma();
+    BOOST_CHECK_EQUAL(bar.getSuperpageCount(0), 0);
+    BOOST_CHECK_EQUAL(transferSuperpages(*channel, 0, SUPERPAGES).size(), SUPERPAGES);
+    BOOST_CHECK_EQUAL(bar.getSuperpageCount(0), SUPERPAGES);
+    channel->stopDma();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(WarmStart)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE * SUPERPAGES);
+  auto channel = ChannelFactory().getDmaChannel(makeChannelParameters(buffer, {0}).setWarmStartEnabled(true));
+  CruBar bar(Parameters::makeParameters(ChannelFactory::getCruEmulatorSerialNumber(), 0),
+      CruBarEmulator::getInstance(ChannelFactory::getCruEmulatorSerialNumber(), 0));
+
+  channel->startDma();
+  BOOST_CHECK_EQUAL(transferSuperpages(*channel, 0, SUPERPAGES).size(), SUPERPAGES);
+  channel->stopDma();
+
+  // The previous run stopped cleanly, so the card is not reset and the driver continues from the firmware's counter
+  channel->startDma();
+  BOOST_CHECK_EQUAL(bar.getSuperpageCount(0), SUPERPAGES);
+  auto superpages = transferSuperpages(*channel, 0, SUPERPAGES);
+  BOOST_REQUIRE_EQUAL(superpages.size(), SUPERPAGES);
+  for (const auto& superpage : superpages) {
+    BOOST_CHECK(superpage.isReady());
+  }
+  BOOST_CHECK_EQUAL(bar.getSuperpageCount(0), 2 * SUPERPAGES);
+  channel->stopDma();
+}
+
+BOOST_AUTO_TEST_CASE(UncleanStopForcesColdStart)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE * SUPERPAGES);
+  auto channel = ChannelFactory().getDmaChannel(makeChannelParameters(buffer, {0}).setWarmStartEnabled(true));
+  CruBar bar(Parameters::makeParameters(ChannelFactory::getCruEmulatorSerialNumber(), 0),
+      CruBarEmulator::getInstance(ChannelFactory::getCruEmulatorSerialNumber(), 0));
+
+  channel->startDma();
+  BOOST_CHECK_EQUAL(transferSuperpages(*channel, 0, SUPERPAGES / 2).size(), SUPERPAGES / 2);
+
+  // Stopping with superpages the firmware didn't fill leaves their descriptors on the card
+  setFirmwarePaused(true);
+  for (size_t i = SUPERPAGES / 2; i < SUPERPAGES; ++i) {
+    channel->pushSuperpage(makeSuperpage(i));
+  }
+  channel->stopDma();
+
+  // So the next start resets the card, and nothing is written to the superpages of the previous run
+  std::fill(buffer.begin(), buffer.end(), 0);
+  channel->startDma();
+  BOOST_CHECK_EQUAL(bar.getSuperpageCount(0), 0);
+  auto superpages = transferSuperpages(*channel, 0, SUPERPAGES / 2);
+  BOOST_REQUIRE_EQUAL(superpages.size(), SUPERPAGES / 2);
+  uint32_t packetCounter = 0;
+  for (const auto& superpage : superpages) {
+    for (size_t offset = 0; offset < SUPERPAGE_SIZE; offset += Cru::DMA_PAGE_SIZE) {
+      BOOST_CHECK_EQUAL(Cru::DataFormat::getPacketCounter(buffer.data() + superpage.getOffset() + offset),
+          packetCounter);
+      packetCounter = (packetCounter + 1) & 0xff;
+    }
+  }
+  BOOST_CHECK(std::all_of(buffer.begin() + SUPERPAGES / 2 * SUPERPAGE_SIZE, buffer.end(),
+      [](char c) { return c == 0; }));
+  channel->stopDma();
+
+  // That run stopped cleanly again, so warm start is back
+  channel->startDma();
+  BOOST_CHECK_EQUAL(bar.getSuperpageCount(0), SUPERPAGES / 2);
+  channel->stopDma();
+}
+
+BOOST_AUTO_TEST_CASE(StopWithFilledSuperpages)
+{
+  const auto timeout = std::chrono::seconds(2);
+  std::vector<char> buffer(SUPERPAGE_SIZE * SUPERPAGES);
+  auto channel = ChannelFactory().getDmaChannel(makeChannelParameters(buffer, {0}).setDmaStopTimeout(timeout));
+  CruBar bar(Parameters::makeParameters(ChannelFactory::getCruEmulatorSerialNumber(), 0),
+      CruBarEmulator::getInstance(ChannelFactory::getCruEmulatorSerialNumber(), 0));
+  channel->startDma();
+  for (size_t i = 0; i < SUPERPAGES; ++i) {
+    channel->pushSuperpage(makeSuperpage(i));
+  }
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (bar.getSuperpageCount(0) < SUPERPAGES && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_REQUIRE_EQUAL(bar.getSuperpageCount(0), SUPERPAGES);
+
+  // Everything has arrived, so the stop doesn't wait for the timeout
+  auto start = std::chrono::steady_clock::now();
+  channel->stopDma();
+  BOOST_CHECK(std::chrono::steady_clock::now() - start < timeout);
+
+  BOOST_REQUIRE_EQUAL(channel->getReadyQueueSize(), SUPERPAGES);
+  while (channel->getReadyQueueSize() > 0) {
+    auto superpage = channel->popSuperpage();
+    BOOST_CHECK(superpage.isReady());
+    BOOST_CHECK_EQUAL(superpage.getReceived(), SUPERPAGE_SIZE);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(StopWithUnfilledSuperpages)
+{
+  const auto timeout = std::chrono::milliseconds(200);
+  std::vector<char> buffer(SUPERPAGE_SIZE * SUPERPAGES);
+  auto channel = ChannelFactory().getDmaChannel(makeChannelParameters(buffer, {0}).setDmaStopTimeout(timeout));
+  channel->startDma();
+  setFirmwarePaused(true);
+  for (size_t i = 0; i < SUPERPAGES; ++i) {
+    channel->pushSuperpage(makeSuperpage(i));
+  }
+
+  // The superpages never arrive, so the stop gives up after the timeout and returns them unfilled
+  auto start = std::chrono::steady_clock::now();
+  channel->stopDma();
+  BOOST_CHECK(std::chrono::steady_clock::now() - start >= timeout);
+
+  BOOST_REQUIRE_EQUAL(channel->getReadyQueueSize(), SUPERPAGES);
+  while (channel->getReadyQueueSize() > 0) {
+    auto superpage = channel->popSuperpage();
+    BOOST_CHECK(!superpage.isReady());
+    BOOST_CHECK_EQUAL(superpage.getReceived(), 0);
+  }
+}
+
+} // Anonymous namespace
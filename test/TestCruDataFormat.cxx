@@ -6,8 +6,11 @@
 #define BOOST_TEST_MODULE RORC_TestCruDataFormat
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
+#include <random>
+#include <vector>
 #include <boost/test/unit_test.hpp>
 #include "Cru/DataFormat.h"
+#include "Cru/RdhBatchDecoder.h"
 
 using namespace AliceO2::roc;
 using namespace Cru::DataFormat;
@@ -39,4 +42,89 @@ BOOST_AUTO_TEST_CASE(TestGetEventSize)
   BOOST_CHECK_EQUAL(getEventSize(reinterpret_cast<const char*>(link18Test1.data())), 256);
   BOOST_CHECK_EQUAL(getEventSize(reinterpret_cast<const char*>(link18Test2.data())), 256);
   BOOST_CHECK_EQUAL(getEventSize(reinterpret_cast<const char*>(link21Test1.data())), 256);
-}
\ No newline at end of file
+}
+/// Fills a page with a random RDH of the given layout
+/// \return The values of the fields, in the order of the RdhBatch arrays
+std::vector<uint32_t> writeRandomRdh(char* page, const RdhLayout& layout, std::mt19937& random)
+{
+  std::vector<uint32_t> values;
+  setRdhField(page, RDH_VERSION_FIELD, layout.version);
+  for (auto field : {layout.memorySize, layout.offsetToNext, layout.linkId, layout.packetCounter, layout.feeId,
+      layout.orbit, layout.bunchCrossing, layout.triggerType, layout.stopBit, layout.pageCounter}) {
+    auto mask = (field.width == 32) ? ~uint32_t(0) : ~(~uint32_t(0) << field.width);
+    auto value = uint32_t(random()) & mask;
+    setRdhField(page, field, value);
+    values.push_back(value);
+  }
+  return values;
+}
+
+BOOST_AUTO_TEST_CASE(TestRdhView)
+{
+  for (const auto& layout : {RDH_LAYOUT_V4, RDH_LAYOUT_V5, RDH_LAYOUT_V6}) {
+    std::vector<char> page(getHeaderSize(), 0);
+    std::mt19937 random(layout.version);
+    auto values = writeRandomRdh(page.data(), layout, random);
+    setRdhField(page.data(), layout.sourceId, 0x5a);
+
+    RdhView rdh(page.data());
+    BOOST_CHECK(rdh.isKnownVersion());
+    BOOST_CHECK_EQUAL(rdh.getVersion(), layout.version);
+    BOOST_CHECK_EQUAL(rdh.getMemorySize(), values[0]);
+    BOOST_CHECK_EQUAL(rdh.getOffsetToNext(), values[1]);
+    BOOST_CHECK_EQUAL(rdh.getLinkId(), values[2]);
+    BOOST_CHECK_EQUAL(rdh.getPacketCounter(), values[3]);
+    BOOST_CHECK_EQUAL(rdh.getFeeId(), values[4]);
+    BOOST_CHECK_EQUAL(rdh.getOrbit(), values[5]);
+    BOOST_CHECK_EQUAL(rdh.getBunchCrossing(), values[6]);
+    BOOST_CHECK_EQUAL(rdh.getTriggerType(), values[7]);
+    BOOST_CHECK_EQUAL(rdh.getStopBit(), values[8]);
+    BOOST_CHECK_EQUAL(rdh.getPageCounter(), values[9]);
+    BOOST_CHECK_EQUAL(rdh.getSourceId(), (layout.version >= 6) ? 0x5a : 0);
+
+    // The fields all versions share are also available without a view
+    BOOST_CHECK_EQUAL(getLinkId(page.data()), values[2]);
+    BOOST_CHECK_EQUAL(getEventSize(page.data()), values[0]);
+    BOOST_CHECK_EQUAL(getPacketCounter(page.data()), values[3]);
+  }
+
+  std::vector<char> page(getHeaderSize(), 0);
+  setRdhField(page.data(), RDH_VERSION_FIELD, 99);
+  BOOST_CHECK(!RdhView(page.data()).isKnownVersion());
+}
+
+BOOST_AUTO_TEST_CASE(TestRdhBatchDecoder)
+{
+  // An amount that is not a multiple of the SIMD width
+  constexpr size_t pages = 21;
+  constexpr size_t stride = 8 * 1024;
+
+  for (const auto& layout : {RDH_LAYOUT_V4, RDH_LAYOUT_V6}) {
+    std::vector<char> superpage(pages * stride, 0);
+    std::vector<std::vector<uint32_t>> expected;
+    std::mt19937 random(layout.version);
+    for (size_t i = 0; i < pages; ++i) {
+      expected.push_back(writeRandomRdh(superpage.data() + i * stride, layout, random));
+    }
+
+    RdhBatch batch;
+    RdhBatch scalarBatch;
+    decodeRdhBatch(superpage.data(), stride, pages, layout, batch);
+    decodeRdhBatchScalar(superpage.data(), stride, pages, layout, scalarBatch);
+    BOOST_REQUIRE_EQUAL(batch.size(), pages);
+    BOOST_REQUIRE_EQUAL(scalarBatch.size(), pages);
+
+    for (auto decoded : {&batch, &scalarBatch}) {
+      auto arrays = {&decoded->memorySize, &decoded->offsetToNext, &decoded->linkId, &decoded->packetCounter,
+        &decoded->feeId, &decoded->orbit, &decoded->bunchCrossing, &decoded->triggerType, &decoded->stopBit,
+        &decoded->pageCounter};
+      for (size_t i = 0; i < pages; ++i) {
+        size_t field = 0;
+        for (auto array : arrays) {
+          BOOST_CHECK_EQUAL((*array)[i], expected[i][field]);
+          field++;
+        }
+      }
+    }
+  }
+}
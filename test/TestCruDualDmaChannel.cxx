@@ -0,0 +1,214 @@
+/// \file TestCruDualDmaChannel.cxx
+/// \brief Tests of the CruDualDmaChannel class, running on the two endpoints of the emulated CRU
+
+#define BOOST_TEST_MODULE RORC_TestCruDualDmaChannel
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <chrono>
+#include <map>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "Cru/Constants.h"
+#include "Cru/CruBar.h"
+#include "Cru/CruBarEmulator.h"
+#include "Cru/DataFormat.h"
+#include "ReadoutCard/ChannelFactory.h"
+
+using namespace ::AliceO2::roc;
+
+namespace {
+
+constexpr size_t SUPERPAGE_SIZE = 32 * 1024;
+constexpr size_t SUPERPAGES = 16;
+const int SERIALS[] = {ChannelFactory::getCruEmulatorSerialNumber(),
+  ChannelFactory::getCruEmulatorCompanionSerialNumber()};
+
+Parameters makeParameters(std::vector<char>& buffer)
+{
+  return Parameters::makeParameters(SERIALS[0], 0)
+    .setCompanionCardId(SERIALS[1])
+    .setBufferParameters(buffer_parameters::Memory{buffer.data(), buffer.size()})
+    .setLinkMask({0});
+}
+
+/// Gets the BAR 0 of an endpoint of the emulated CRU, to look at the firmware's side of things
+std::unique_ptr<CruBar> getEndpointBar(int endpoint)
+{
+  auto serial = SERIALS[endpoint];
+  return std::make_unique<CruBar>(Parameters::makeParameters(serial, 0), CruBarEmulator::getInstance(serial, 0));
+}
+
+/// Holds or releases the data flow of the emulated firmware of an endpoint
+void setFirmwarePaused(int endpoint, bool paused)
+{
+  CruBarEmulator::getInstance(SERIALS[endpoint], 0)->writeRegister(Cru::Registers::DMA_CONTROL.index,
+      paused ? 0x0 : 0x1);
+}
+
+void pushSuperpages(DmaChannelInterface& channel, size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    Superpage superpage;
+    superpage.setOffset(i * SUPERPAGE_SIZE);
+    superpage.setSize(SUPERPAGE_SIZE);
+    channel.pushSuperpage(superpage);
+  }
+}
+
+/// Pops superpages until the given amount arrived, or a few seconds passed
+std::vector<Superpage> popSuperpages(DmaChannelInterface& channel, size_t count)
+{
+  std::vector<Superpage> superpages;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (superpages.size() < count && std::chrono::steady_clock::now() < deadline) {
+    channel.fillSuperpages();
+    while (channel.getReadyQueueSize() > 0) {
+      superpages.push_back(channel.popSuperpage());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return superpages;
+}
+
+BOOST_AUTO_TEST_CASE(Construction)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE);
+  auto channel = ChannelFactory().getDmaChannel(makeParameters(buffer));
+  BOOST_CHECK(channel->getCardType() == CardType::Cru);
+  // Both endpoints have a full set of link queue slots
+  channel->startDma();
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), 2 * Cru::MAX_SUPERPAGE_DESCRIPTORS);
+  channel->stopDma();
+  channel.reset();
+
+  auto parameters = makeParameters(buffer);
+  parameters.setCompanionCardId(SERIALS[0]);
+  BOOST_CHECK_THROW(ChannelFactory().getDmaChannel(parameters), ParameterException);
+}
+
+BOOST_AUTO_TEST_CASE(Routing)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE * SUPERPAGES);
+  auto channel = ChannelFactory().getDmaChannel(makeParameters(buffer));
+  std::unique_ptr<CruBar> bars[] = {getEndpointBar(0), getEndpointBar(1)};
+  channel->startDma();
+
+  // Superpages are given to the endpoint with the most room, alternating on a tie, so both get half of them
+  pushSuperpages(*channel, SUPERPAGES);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), 2 * Cru::MAX_SUPERPAGE_DESCRIPTORS - SUPERPAGES);
+  auto superpages = popSuperpages(*channel, SUPERPAGES);
+  BOOST_CHECK_EQUAL(superpages.size(), SUPERPAGES);
+  BOOST_CHECK_EQUAL(bars[0]->getSuperpageCount(0), SUPERPAGES / 2);
+  BOOST_CHECK_EQUAL(bars[1]->getSuperpageCount(0), SUPERPAGES / 2);
+
+  // An endpoint with fewer free slots doesn't get the next superpage
+  Superpage superpage;
+  superpage.setOffset(0);
+  superpage.setSize(SUPERPAGE_SIZE);
+  channel->pushLinkSuperpage(0, superpage);
+  superpage.setOffset(SUPERPAGE_SIZE);
+  channel->pushLinkSuperpage(0, superpage);
+  superpage.setOffset(2 * SUPERPAGE_SIZE);
+  channel->pushSuperpage(superpage);
+  superpage.setOffset(3 * SUPERPAGE_SIZE);
+  channel->pushSuperpage(superpage);
+  BOOST_CHECK_EQUAL(popSuperpages(*channel, 4).size(), 4);
+  BOOST_CHECK_EQUAL(bars[0]->getSuperpageCount(0), SUPERPAGES / 2 + 2);
+  BOOST_CHECK_EQUAL(bars[1]->getSuperpageCount(0), SUPERPAGES / 2 + 2);
+  channel->stopDma();
+}
+
+BOOST_AUTO_TEST_CASE(MergedReadyQueue)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE * SUPERPAGES);
+  auto channel = ChannelFactory().getDmaChannel(makeParameters(buffer));
+  channel->startDma();
+  pushSuperpages(*channel, SUPERPAGES);
+  auto superpages = popSuperpages(*channel, SUPERPAGES);
+  channel->stopDma();
+
+  // Every superpage arrives once, complete
+  BOOST_REQUIRE_EQUAL(superpages.size(), SUPERPAGES);
+  std::map<size_t, int> arrivals;
+  for (const auto& superpage : superpages) {
+    BOOST_CHECK(superpage.isReady());
+    BOOST_CHECK_EQUAL(superpage.getReceived(), SUPERPAGE_SIZE);
+    arrivals[superpage.getOffset()]++;
+  }
+  BOOST_CHECK_EQUAL(arrivals.size(), SUPERPAGES);
+
+  // Superpage i went to endpoint i % 2. Each endpoint's superpages stay in the order they were pushed in, so its
+  // packet counters continue from one superpage to the next.
+  size_t nextIndex[] = {0, 1};
+  uint32_t packetCounters[] = {0, 0};
+  for (const auto& superpage : superpages) {
+    auto index = superpage.getOffset() / SUPERPAGE_SIZE;
+    auto endpoint = index % 2;
+    BOOST_CHECK_EQUAL(index, nextIndex[endpoint]);
+    nextIndex[endpoint] += 2;
+    for (size_t offset = 0; offset < SUPERPAGE_SIZE; offset += Cru::DMA_PAGE_SIZE) {
+      auto page = buffer.data() + superpage.getOffset() + offset;
+      BOOST_CHECK_EQUAL(Cru::DataFormat::getPacketCounter(page), packetCounters[endpoint]);
+      packetCounters[endpoint] = (packetCounters[endpoint] + 1) & 0xff;
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(MixedSuperpageSizes)
+{
+  constexpr size_t SMALL = SUPERPAGE_SIZE;
+  constexpr size_t LARGE = 2 * SUPERPAGE_SIZE;
+  constexpr size_t SLOTS = Cru::MAX_SUPERPAGE_DESCRIPTORS;
+  std::vector<char> buffer(2 * SLOTS * LARGE + SLOTS * SMALL);
+  auto channel = ChannelFactory().getDmaChannel(makeParameters(buffer)
+      .setLinkMask({0, 1})
+      .setLinkSuperpageSizeMap({{0, SMALL}, {1, LARGE}}));
+  std::unique_ptr<CruBar> bars[] = {getEndpointBar(0), getEndpointBar(1)};
+  channel->startDma();
+  setFirmwarePaused(0, true);
+  setFirmwarePaused(1, true);
+
+  // Fill the large superpage links of both endpoints
+  size_t pushed = 0;
+  while (channel->getTransferQueueAvailableForSize(LARGE) > 0) {
+    Superpage superpage;
+    superpage.setOffset(pushed++ * LARGE);
+    superpage.setSize(LARGE);
+    channel->pushSuperpage(superpage);
+  }
+  BOOST_CHECK_EQUAL(pushed, 2 * SLOTS);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailableForSize(SMALL), 2 * SLOTS);
+
+  // Let only the companion hand its large superpages back. It now has more room than the primary endpoint, but all of
+  // its extra room is for large superpages.
+  setFirmwarePaused(1, false);
+  auto freed = popSuperpages(*channel, SLOTS);
+  setFirmwarePaused(1, true);
+  BOOST_REQUIRE_EQUAL(freed.size(), SLOTS);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailable(), 3 * SLOTS);
+
+  // So small superpages are still shared evenly, and large ones only go where they fit
+  for (size_t i = 0; i < SLOTS; ++i) {
+    Superpage superpage;
+    superpage.setOffset(2 * SLOTS * LARGE + i * SMALL);
+    superpage.setSize(SMALL);
+    channel->pushSuperpage(superpage);
+  }
+  for (const auto& superpage : freed) {
+    channel->pushSuperpage(superpage);
+  }
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailableForSize(LARGE), 0);
+  BOOST_CHECK_EQUAL(channel->getTransferQueueAvailableForSize(SMALL), SLOTS);
+
+  setFirmwarePaused(0, false);
+  setFirmwarePaused(1, false);
+  BOOST_CHECK_EQUAL(popSuperpages(*channel, 3 * SLOTS).size(), 3 * SLOTS);
+  BOOST_CHECK_EQUAL(bars[0]->getSuperpageCount(0), SLOTS / 2);
+  BOOST_CHECK_EQUAL(bars[1]->getSuperpageCount(0), SLOTS / 2);
+  BOOST_CHECK_EQUAL(bars[0]->getSuperpageCount(1), SLOTS);
+  BOOST_CHECK_EQUAL(bars[1]->getSuperpageCount(1), 2 * SLOTS);
+  channel->stopDma();
+}
+
+} // Anonymous namespace
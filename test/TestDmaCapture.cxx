@@ -0,0 +1,177 @@
+/// \file TestDmaCapture.cxx
+/// \brief Test of the DMA capture format, and of replaying captures through the DummyDmaChannel
+
+#define BOOST_TEST_MODULE RORC_TestDmaCapture
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "DmaCapture.h"
+#include "ReadoutCard/ChannelFactory.h"
+#include "ReadoutCard/Exception.h"
+
+using namespace ::AliceO2::roc;
+
+namespace {
+
+const std::string filePath("/tmp/AliceO2_DmaCapture_Test");
+
+constexpr size_t PAGE_SIZE = 8 * 1024;
+constexpr size_t SUPERPAGE_SIZE = 32 * 1024;
+
+/// Makes the data of a recorded superpage, different for each record
+std::vector<char> makeData(size_t size, int record)
+{
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = char((i + record * 7) % 251);
+  }
+  return data;
+}
+
+/// Writes a capture with the given record sizes, each arriving the given time after the previous one
+void writeCapture(const std::vector<size_t>& sizes, std::chrono::milliseconds spacing)
+{
+  DmaCaptureWriter writer(filePath, PAGE_SIZE);
+  auto arrival = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    auto data = makeData(sizes[i], i);
+    writer.write(data.data(), data.size(), i % 3, arrival);
+    arrival += spacing;
+  }
+}
+
+/// Runs a dummy channel replaying the capture into a buffer with room for the given amount of superpages, and
+/// returns the superpages with their arrival times
+std::vector<std::pair<Superpage, std::chrono::steady_clock::time_point>> replay(std::vector<char>& buffer,
+    size_t amount, bool pacing)
+{
+  buffer.assign(amount * SUPERPAGE_SIZE, 0);
+  auto parameters = Parameters::makeParameters(ChannelFactory::getDummySerialNumber(), 0)
+    .setBufferParameters(buffer_parameters::Memory{buffer.data(), buffer.size()})
+    .setDmaPageSize(PAGE_SIZE)
+    .setReplayFile(filePath)
+    .setReplayPacingEnabled(pacing);
+  auto channel = ChannelFactory().getDmaChannel(parameters);
+  channel->startDma();
+
+  for (size_t i = 0; i < amount; ++i) {
+    Superpage superpage;
+    superpage.setOffset(i * SUPERPAGE_SIZE);
+    superpage.setSize(SUPERPAGE_SIZE);
+    channel->pushSuperpage(superpage);
+  }
+
+  std::vector<std::pair<Superpage, std::chrono::steady_clock::time_point>> superpages;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (superpages.size() < amount && std::chrono::steady_clock::now() < deadline) {
+    channel->fillSuperpages();
+    while (channel->getReadyQueueSize() > 0) {
+      superpages.emplace_back(channel->popSuperpage(), std::chrono::steady_clock::now());
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  channel->stopDma();
+  return superpages;
+}
+
+BOOST_AUTO_TEST_CASE(WriteAndRead)
+{
+  std::vector<size_t> sizes {SUPERPAGE_SIZE, 1000, 0, 3 * PAGE_SIZE + 4};
+  writeCapture(sizes, std::chrono::milliseconds(2));
+
+  DmaCaptureReader reader(filePath);
+  BOOST_REQUIRE(reader.getRecordCount() == sizes.size());
+  BOOST_CHECK(reader.getDmaPageSize() == PAGE_SIZE);
+
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    auto record = reader.getRecord(i);
+    BOOST_CHECK(record.size == sizes[i]);
+    BOOST_CHECK(record.linkId == i % 3);
+    BOOST_CHECK(record.timestamp == std::chrono::milliseconds(2 * i));
+    BOOST_CHECK((reinterpret_cast<uintptr_t>(record.data) % DmaCapture::DATA_ALIGNMENT) == 0);
+    auto data = makeData(sizes[i], i);
+    BOOST_CHECK(std::memcmp(record.data, data.data(), data.size()) == 0);
+  }
+
+  BOOST_CHECK_THROW(reader.getRecord(sizes.size()), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidFile)
+{
+  {
+    std::ofstream stream(filePath, std::ios::binary | std::ios::trunc);
+    stream << std::string(256, 'x');
+  }
+  BOOST_CHECK_THROW(DmaCaptureReader reader(filePath), Exception);
+  boost::filesystem::remove(filePath);
+  BOOST_CHECK_THROW(DmaCaptureReader reader(filePath), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(ReplayAsFastAsPossible)
+{
+  // The capture has an odd sized superpage and one that is too big for the replay superpages
+  std::vector<size_t> sizes {SUPERPAGE_SIZE, 5000, 2 * SUPERPAGE_SIZE};
+  writeCapture(sizes, std::chrono::seconds(10));
+
+  std::vector<char> buffer;
+  auto superpages = replay(buffer, 2 * sizes.size(), false);
+  BOOST_REQUIRE(superpages.size() == 2 * sizes.size());
+
+  // The capture starts over when it ends, and only whole DMA pages of the big superpage fit
+  for (size_t i = 0; i < superpages.size(); ++i) {
+    const auto& superpage = superpages[i].first;
+    auto record = i % sizes.size();
+    auto expectedSize = std::min(sizes[record], SUPERPAGE_SIZE);
+    BOOST_CHECK(superpage.isReady());
+    BOOST_CHECK(superpage.getOffset() == i * SUPERPAGE_SIZE);
+    BOOST_CHECK(superpage.getReceived() == expectedSize);
+    auto data = makeData(expectedSize, record);
+    BOOST_CHECK(std::memcmp(buffer.data() + superpage.getOffset(), data.data(), data.size()) == 0);
+  }
+
+  // Without pacing the capture is replayed twice in much less time than it took to record it once
+  BOOST_CHECK((superpages.back().second - superpages.front().second) < std::chrono::seconds(5));
+}
+
+BOOST_AUTO_TEST_CASE(ReplayPaced)
+{
+  writeCapture({SUPERPAGE_SIZE, SUPERPAGE_SIZE}, std::chrono::milliseconds(100));
+
+  std::vector<char> buffer;
+  auto superpages = replay(buffer, 2, true);
+  BOOST_REQUIRE(superpages.size() == 2);
+  BOOST_CHECK((superpages[1].second - superpages[0].second) >= std::chrono::milliseconds(80));
+}
+
+BOOST_AUTO_TEST_CASE(ReplayRejectsNullBuffer)
+{
+  writeCapture({SUPERPAGE_SIZE}, std::chrono::milliseconds(0));
+
+  auto parameters = Parameters::makeParameters(ChannelFactory::getDummySerialNumber(), 0)
+    .setBufferParameters(buffer_parameters::Null())
+    .setDmaPageSize(PAGE_SIZE)
+    .setReplayFile(filePath);
+  BOOST_CHECK_THROW(ChannelFactory().getDmaChannel(parameters), ParameterException);
+}
+
+BOOST_AUTO_TEST_CASE(ReplayRejectsPageSizeMismatch)
+{
+  writeCapture({SUPERPAGE_SIZE}, std::chrono::milliseconds(0));
+
+  std::vector<char> buffer(SUPERPAGE_SIZE);
+  auto parameters = Parameters::makeParameters(ChannelFactory::getDummySerialNumber(), 0)
+    .setBufferParameters(buffer_parameters::Memory{buffer.data(), buffer.size()})
+    .setDmaPageSize(2 * PAGE_SIZE)
+    .setReplayFile(filePath);
+  BOOST_CHECK_THROW(ChannelFactory().getDmaChannel(parameters), ParameterException);
+}
+
+} // Anonymous namespace
@@ -0,0 +1,210 @@
+/// \file TestDummyDataGenerator.cxx
+/// \brief Test of the DummyDataGenerator class
+
+#define BOOST_TEST_MODULE RORC_TestDummyDataGenerator
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <chrono>
+#include <map>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "Cru/DataFormat.h"
+#include "Dummy/DummyDataGenerator.h"
+#include "ReadoutCard/ChannelFactory.h"
+#include "ReadoutCard/Exception.h"
+
+using namespace ::AliceO2::roc;
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 8 * 1024;
+constexpr size_t SUPERPAGE_SIZE = 32 * 1024;
+constexpr size_t SUPERPAGES = 4;
+
+/// Pops superpages until the given amount has arrived, or a timeout expires
+std::vector<Superpage> popSuperpages(DummyDataGenerator& generator, size_t amount)
+{
+  std::vector<Superpage> superpages;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (superpages.size() < amount && std::chrono::steady_clock::now() < deadline) {
+    Superpage superpage;
+    if (generator.pop(superpage)) {
+      superpages.push_back(superpage);
+    } else {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  return superpages;
+}
+
+BOOST_AUTO_TEST_CASE(GeneratesCruFormat)
+{
+  std::vector<uint32_t> buffer(SUPERPAGE_SIZE * SUPERPAGES / sizeof(uint32_t));
+
+  DummyDataGenerator::Config config;
+  config.bufferAddress = reinterpret_cast<uintptr_t>(buffer.data());
+  config.pageSize = PAGE_SIZE;
+  config.dataSize = PAGE_SIZE;
+  config.links = {3};
+  DummyDataGenerator generator(config, SUPERPAGES);
+  generator.start();
+
+  for (size_t i = 0; i < SUPERPAGES; ++i) {
+    Superpage superpage;
+    superpage.setOffset(i * SUPERPAGE_SIZE);
+    superpage.setSize(SUPERPAGE_SIZE);
+    BOOST_REQUIRE(generator.push(superpage));
+  }
+
+  auto superpages = popSuperpages(generator, SUPERPAGES);
+  BOOST_REQUIRE(superpages.size() == SUPERPAGES);
+  BOOST_CHECK(generator.stop().empty());
+
+  uint32_t packetCounter = 0;
+  uint32_t dataCounter = 0;
+  for (const auto& superpage : superpages) {
+    BOOST_CHECK(superpage.isReady());
+    BOOST_CHECK(superpage.getReceived() == SUPERPAGE_SIZE);
+    for (size_t offset = 0; offset < SUPERPAGE_SIZE; offset += PAGE_SIZE) {
+      auto page = reinterpret_cast<const char*>(buffer.data()) + superpage.getOffset() + offset;
+      BOOST_CHECK(Cru::DataFormat::getLinkId(page) == 3);
+      BOOST_CHECK(Cru::DataFormat::getEventSize(page) == PAGE_SIZE);
+      BOOST_CHECK(Cru::DataFormat::getPacketCounter(page) == packetCounter);
+      packetCounter = (packetCounter + 1) & 0xff;
+
+      auto payload = reinterpret_cast<const uint32_t*>(page + Cru::DataFormat::getHeaderSize());
+      BOOST_CHECK(payload[0] == dataCounter);
+      BOOST_CHECK(payload[1] == dataCounter);
+      BOOST_CHECK(payload[2] == (dataCounter & 0xffff));
+      BOOST_CHECK(payload[3] == 0);
+      dataCounter += (PAGE_SIZE - Cru::DataFormat::getHeaderSize()) / 16;
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(StopReturnsUnfinished)
+{
+  std::vector<uint32_t> buffer(SUPERPAGE_SIZE * SUPERPAGES / sizeof(uint32_t));
+
+  DummyDataGenerator::Config config;
+  config.bufferAddress = reinterpret_cast<uintptr_t>(buffer.data());
+  config.pageSize = PAGE_SIZE;
+  config.dataSize = PAGE_SIZE;
+  config.links = {0};
+  config.linkRates[0] = 1; // 1 byte per second, so nothing completes
+  DummyDataGenerator generator(config, SUPERPAGES);
+  generator.start();
+
+  Superpage superpage;
+  superpage.setSize(SUPERPAGE_SIZE);
+  BOOST_REQUIRE(generator.push(superpage));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  auto remaining = generator.stop();
+  BOOST_REQUIRE(remaining.size() == 1);
+  BOOST_CHECK(!remaining[0].isReady());
+  BOOST_CHECK(remaining[0].getReceived() < SUPERPAGE_SIZE);
+}
+
+/// Runs a generator for one link with the given faults, and returns the buffer once the superpages arrived
+std::vector<uint32_t> runWithFaults(std::map<GeneratorFault::type, double> faults, size_t* arrived = nullptr)
+{
+  std::vector<uint32_t> buffer(SUPERPAGE_SIZE * SUPERPAGES / sizeof(uint32_t));
+
+  DummyDataGenerator::Config config;
+  config.bufferAddress = reinterpret_cast<uintptr_t>(buffer.data());
+  config.pageSize = PAGE_SIZE;
+  config.dataSize = PAGE_SIZE;
+  config.links = {0};
+  config.faultProbabilities = faults;
+  config.stallTime = std::chrono::hours(1);
+  DummyDataGenerator generator(config, SUPERPAGES);
+  generator.start();
+
+  for (size_t i = 0; i < SUPERPAGES; ++i) {
+    Superpage superpage;
+    superpage.setOffset(i * SUPERPAGE_SIZE);
+    superpage.setSize(SUPERPAGE_SIZE);
+    BOOST_REQUIRE(generator.push(superpage));
+  }
+
+  if (arrived) {
+    // Faults that block the data, give them a moment to not deliver anything
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Superpage superpage;
+    *arrived = 0;
+    while (generator.pop(superpage)) {
+      (*arrived)++;
+    }
+  } else {
+    BOOST_REQUIRE(popSuperpages(generator, SUPERPAGES).size() == SUPERPAGES);
+  }
+  generator.stop();
+  return buffer;
+}
+
+const char* getPage(const std::vector<uint32_t>& buffer, size_t index)
+{
+  return reinterpret_cast<const char*>(buffer.data()) + index * PAGE_SIZE;
+}
+
+BOOST_AUTO_TEST_CASE(InjectsFaults)
+{
+  constexpr size_t PAGES = SUPERPAGE_SIZE * SUPERPAGES / PAGE_SIZE;
+
+  {
+    // Dropped pages are never written, so the buffer keeps its zeroes
+    auto buffer = runWithFaults({{GeneratorFault::DropPage, 1.0}});
+    for (size_t i = 0; i < PAGES; ++i) {
+      BOOST_CHECK(Cru::DataFormat::getEventSize(getPage(buffer, i)) == 0);
+    }
+  }
+  {
+    // Every page skips one packet counter value
+    auto buffer = runWithFaults({{GeneratorFault::SkipPacketCounter, 1.0}});
+    for (size_t i = 0; i < PAGES; ++i) {
+      BOOST_CHECK(Cru::DataFormat::getPacketCounter(getPage(buffer, i)) == ((i * 2) + 1));
+    }
+  }
+  {
+    // Either the memory size or the packet counter is off by one bit
+    auto buffer = runWithFaults({{GeneratorFault::CorruptRdh, 1.0}});
+    for (size_t i = 0; i < PAGES; ++i) {
+      auto sizeBits = Cru::DataFormat::getEventSize(getPage(buffer, i)) ^ PAGE_SIZE;
+      auto counterBits = Cru::DataFormat::getPacketCounter(getPage(buffer, i)) ^ i;
+      BOOST_CHECK(__builtin_popcount(sizeBits) + __builtin_popcount(counterBits) == 1);
+    }
+  }
+  {
+    // A stalled link delivers nothing, and neither does one whose superpages are always lost
+    size_t arrived = 0;
+    runWithFaults({{GeneratorFault::StallLink, 1.0}}, &arrived);
+    BOOST_CHECK(arrived == 0);
+    runWithFaults({{GeneratorFault::ReadyQueueOverflow, 1.0}}, &arrived);
+    BOOST_CHECK(arrived == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(RejectsEmptyLinkMask)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE);
+  auto parameters = Parameters::makeParameters(ChannelFactory::getDummySerialNumber(), 0)
+    .setBufferParameters(buffer_parameters::Memory{buffer.data(), buffer.size()})
+    .setGeneratorEnabled(true)
+    .setLinkMask({});
+  BOOST_CHECK_THROW(ChannelFactory().getDmaChannel(parameters), ParameterException);
+}
+
+BOOST_AUTO_TEST_CASE(RejectsLargePages)
+{
+  // The RDH's offset to the next packet can't describe a 64 KiB page
+  std::vector<char> buffer(2 * 64 * 1024);
+  auto parameters = Parameters::makeParameters(ChannelFactory::getDummySerialNumber(), 0)
+    .setBufferParameters(buffer_parameters::Memory{buffer.data(), buffer.size()})
+    .setGeneratorEnabled(true)
+    .setDmaPageSize(64 * 1024);
+  BOOST_CHECK_THROW(ChannelFactory().getDmaChannel(parameters), ParameterException);
+}
+
+} // Anonymous namespace
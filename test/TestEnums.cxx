@@ -4,6 +4,7 @@
 /// \author Pascal Boeschoten (pascal.boeschoten@cern.ch)
 
 #include "ReadoutCard/CardType.h"
+#include "ReadoutCard/ParameterTypes/GeneratorFault.h"
 #include "ReadoutCard/ParameterTypes/LoopbackMode.h"
 #include "ReadoutCard/ParameterTypes/ReadoutMode.h"
 #include "ReadoutCard/ParameterTypes/ResetLevel.h"
@@ -46,3 +47,9 @@ BOOST_AUTO_TEST_CASE(EnumReadoutModeConversion)
 {
   checkEnumConversion<ReadoutMode>({ReadoutMode::Continuous});
 }
+
+BOOST_AUTO_TEST_CASE(EnumGeneratorFaultConversion)
+{
+  checkEnumConversion<GeneratorFault>({GeneratorFault::DropPage, GeneratorFault::CorruptRdh,
+      GeneratorFault::SkipPacketCounter, GeneratorFault::StallLink, GeneratorFault::ReadyQueueOverflow});
+}
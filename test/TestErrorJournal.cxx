@@ -0,0 +1,95 @@
+/// \file TestErrorJournal.cxx
+/// \brief Test of the ErrorJournal class of roc-bench-dma
+
+#include "CommandLineUtilities/ErrorJournal.h"
+
+#define BOOST_TEST_MODULE RORC_TestErrorJournal
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+using namespace ::AliceO2::roc::CommandLineUtilities;
+
+namespace {
+
+const std::string PATH = "/tmp/TestErrorJournal.txt";
+
+std::vector<std::string> readLines(const std::string& path)
+{
+  std::vector<std::string> lines;
+  std::ifstream stream(path);
+  std::string line;
+  while (std::getline(stream, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+BOOST_AUTO_TEST_CASE(WriteRecords)
+{
+  std::remove(PATH.c_str());
+  {
+    ErrorJournal journal(16, 100, 4);
+    journal.start(PATH);
+    journal.add(ErrorRecord{7, ErrorCategory::DataMismatch, 2, 5, 0x10, 0x11, 0x12, 256, 0});
+    journal.add(ErrorRecord{8, ErrorCategory::PacketResync, 3, 0, 0, 0x1, 0x2, 0, 0});
+    journal.stop();
+
+    BOOST_CHECK_EQUAL(journal.getWritten(), 2);
+    BOOST_CHECK_EQUAL(journal.getCount(ErrorCategory::DataMismatch), 1);
+    BOOST_CHECK_EQUAL(journal.getCount(ErrorCategory::PacketResync, 3), 1);
+    BOOST_CHECK_EQUAL(journal.getCount(ErrorCategory::RdhSize), 0);
+  }
+
+  auto lines = readLines(PATH);
+  BOOST_REQUIRE_GE(lines.size(), 2);
+  BOOST_CHECK_EQUAL(lines[0], "[ERROR]\tevent:7 link:2 cnt:10 payloadBytes:256 i:5 exp:11 val:12");
+  BOOST_CHECK_EQUAL(lines[1], "resync packet counter for e:8 l:3 packet_cnt:2 mpacket_cnt:1");
+  BOOST_CHECK(lines.back().find("PACKET_RESYNC\t1\t3:1") != std::string::npos);
+  std::remove(PATH.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(ManyThreads)
+{
+  std::remove(PATH.c_str());
+  constexpr int THREADS = 4;
+  constexpr int RECORDS = 10000;
+  ErrorJournal journal(64, 1000, THREADS);
+  journal.start(PATH);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&, t]{
+      for (int i = 0; i < RECORDS; ++i) {
+        journal.add(ErrorRecord{i, ErrorCategory::RdhSize, uint32_t(t), 0, 0, 0, 0, 1, 2});
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  journal.stop();
+
+  // Everything is counted, but only the maximum is kept, minus what didn't fit in the ring
+  BOOST_CHECK_EQUAL(journal.getCount(ErrorCategory::RdhSize), THREADS * RECORDS);
+  BOOST_CHECK_EQUAL(journal.getWritten() + journal.getDropped(), 1000);
+  for (uint32_t t = 0; t < THREADS; ++t) {
+    BOOST_CHECK_EQUAL(journal.getCount(ErrorCategory::RdhSize, t), RECORDS);
+  }
+
+  size_t recordLines = 0;
+  for (const auto& line : readLines(PATH)) {
+    if (line.compare(0, 8, "[RDHERR]") == 0) {
+      recordLines++;
+    }
+  }
+  BOOST_CHECK_EQUAL(recordLines, journal.getWritten());
+  std::remove(PATH.c_str());
+}
+
+} // Anonymous namespace
@@ -0,0 +1,72 @@
+/// \file TestLatencyHistogram.cxx
+/// \brief Test of the LatencyHistogram class of roc-bench-dma
+
+#include "CommandLineUtilities/LatencyHistogram.h"
+
+#define BOOST_TEST_MODULE RORC_TestLatencyHistogram
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace ::AliceO2::roc::CommandLineUtilities;
+using std::chrono::nanoseconds;
+
+namespace {
+
+BOOST_AUTO_TEST_CASE(Empty)
+{
+  LatencyHistogram histogram;
+  BOOST_CHECK_EQUAL(histogram.getCount(), 0);
+  BOOST_CHECK_EQUAL(histogram.getPercentile(99), 0);
+  BOOST_CHECK_EQUAL(histogram.getMax(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(SmallValuesAreExact)
+{
+  LatencyHistogram histogram;
+  for (int i = 1; i <= 50; ++i) {
+    histogram.record(nanoseconds(i));
+  }
+  BOOST_CHECK_EQUAL(histogram.getCount(), 50);
+  BOOST_CHECK_EQUAL(histogram.getPercentile(50), 25);
+  BOOST_CHECK_EQUAL(histogram.getPercentile(100), 50);
+  BOOST_CHECK_EQUAL(histogram.getMax(), 50);
+}
+
+BOOST_AUTO_TEST_CASE(Precision)
+{
+  // 1 to 1000 microseconds
+  LatencyHistogram histogram;
+  for (int i = 1; i <= 1000; ++i) {
+    histogram.record(std::chrono::microseconds(i));
+  }
+  auto check = [&](double percentile, double expected) {
+    auto value = double(histogram.getPercentile(percentile));
+    BOOST_CHECK_GE(value, expected);
+    BOOST_CHECK_LE(value, expected * 1.04);
+  };
+  check(50, 500000);
+  check(99, 990000);
+  check(99.9, 999000);
+  BOOST_CHECK_EQUAL(histogram.getPercentile(100), 1000000);
+  BOOST_CHECK_EQUAL(histogram.getMax(), 1000000);
+}
+
+BOOST_AUTO_TEST_CASE(Tail)
+{
+  // A single outlier shows up in the maximum and the highest percentiles only
+  LatencyHistogram histogram;
+  for (int i = 0; i < 9999; ++i) {
+    histogram.record(std::chrono::microseconds(10));
+  }
+  histogram.record(std::chrono::seconds(2));
+  BOOST_CHECK_LE(histogram.getPercentile(99.9), 10400);
+  BOOST_CHECK_EQUAL(histogram.getPercentile(100), 2000000000);
+  BOOST_CHECK_EQUAL(histogram.getMax(), 2000000000);
+
+  // Negative durations can't happen with a steady clock, but are counted as 0
+  histogram.record(nanoseconds(-5));
+  BOOST_CHECK_EQUAL(histogram.getCount(), 10001);
+}
+
+} // Anonymous namespace
@@ -0,0 +1,131 @@
+/// \file TestLinkDemultiplexer.cxx
+/// \brief Test of the LinkDemultiplexer class
+
+#define BOOST_TEST_MODULE RORC_TestLinkDemultiplexer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <cstring>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "ReadoutCard/Exception.h"
+#include "ReadoutCard/LinkDemultiplexer.h"
+#include "RdhTestUtils.h"
+
+using namespace ::AliceO2::roc;
+using RdhTestUtils::writeRdh;
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 8 * 1024;
+constexpr size_t PAGES = 8;
+constexpr size_t PAYLOAD_SIZE = 1000;
+
+/// Writes a CRU-format packet, with the payload filled with the link ID and the packet's index
+void writePacket(char* page, uint32_t linkId, size_t index)
+{
+  writeRdh(page, RDH_SIZE + PAYLOAD_SIZE, PAGE_SIZE, linkId);
+  for (size_t i = 0; i < PAYLOAD_SIZE; ++i) {
+    page[RDH_SIZE + i] = char(linkId * 16 + index + i);
+  }
+}
+
+/// Superpage with the links interleaved: 0, 5, 2, 5, 0, 5, 2, 5
+struct InterleavedSuperpage
+{
+    InterleavedSuperpage() : buffer(PAGES * PAGE_SIZE), superpage(0, PAGES * PAGE_SIZE)
+    {
+      for (size_t i = 0; i < PAGES; ++i) {
+        writePacket(buffer.data() + i * PAGE_SIZE, linkIds[i], i);
+      }
+      superpage.setReceived(PAGES * PAGE_SIZE);
+    }
+
+    const uint32_t linkIds[PAGES] = {0, 5, 2, 5, 0, 5, 2, 5};
+    std::vector<char> buffer;
+    Superpage superpage;
+};
+
+BOOST_AUTO_TEST_CASE(Index)
+{
+  InterleavedSuperpage data;
+  LinkDemultiplexer demultiplexer(CardType::Cru, PAGE_SIZE);
+  demultiplexer.index(data.superpage, data.buffer.data());
+
+  BOOST_CHECK((demultiplexer.getActiveLinks() == std::vector<uint32_t>{0, 2, 5}));
+  BOOST_REQUIRE_EQUAL(demultiplexer.getPackets(0).size(), 2);
+  BOOST_REQUIRE_EQUAL(demultiplexer.getPackets(2).size(), 2);
+  BOOST_REQUIRE_EQUAL(demultiplexer.getPackets(5).size(), 4);
+  BOOST_CHECK(demultiplexer.getPackets(1).empty());
+
+  // Packets point into the DMA buffer, in order of arrival
+  BOOST_CHECK(demultiplexer.getPackets(5)[0].header == data.buffer.data() + 1 * PAGE_SIZE);
+  BOOST_CHECK(demultiplexer.getPackets(5)[3].header == data.buffer.data() + 7 * PAGE_SIZE);
+  BOOST_CHECK(demultiplexer.getPackets(2)[1].header == data.buffer.data() + 6 * PAGE_SIZE);
+
+  // The next superpage replaces the lists
+  Superpage single(0, PAGES * PAGE_SIZE);
+  single.setReceived(PAGE_SIZE);
+  demultiplexer.index(single, data.buffer.data());
+  BOOST_CHECK((demultiplexer.getActiveLinks() == std::vector<uint32_t>{0}));
+  BOOST_CHECK_EQUAL(demultiplexer.getPackets(0).size(), 1);
+  BOOST_CHECK(demultiplexer.getPackets(5).empty());
+
+  BOOST_CHECK_THROW(demultiplexer.getPackets(LinkDemultiplexer::MAX_LINKS), InvalidLinkId);
+}
+
+BOOST_AUTO_TEST_CASE(Copy)
+{
+  InterleavedSuperpage data;
+  LinkDemultiplexer demultiplexer(CardType::Cru, PAGE_SIZE);
+  std::vector<char> output0(4 * PAYLOAD_SIZE);
+  std::vector<char> output5(4 * PAYLOAD_SIZE);
+  demultiplexer.setOutput(0, output0.data(), output0.size());
+  demultiplexer.setOutput(5, output5.data(), output5.size());
+  demultiplexer.copy(data.superpage, data.buffer.data());
+
+  // Link 2 has no output, so it's only indexed
+  BOOST_CHECK_EQUAL(demultiplexer.getOutputSize(0), 2 * PAYLOAD_SIZE);
+  BOOST_CHECK_EQUAL(demultiplexer.getOutputSize(2), 0);
+  BOOST_CHECK_EQUAL(demultiplexer.getOutputSize(5), 4 * PAYLOAD_SIZE);
+  BOOST_CHECK_EQUAL(demultiplexer.getPackets(2).size(), 2);
+
+  auto checkOutput = [&](const std::vector<char>& output, uint32_t linkId) {
+    size_t position = 0;
+    for (size_t i = 0; i < PAGES; ++i) {
+      if (data.linkIds[i] == linkId) {
+        BOOST_CHECK(std::memcmp(output.data() + position, data.buffer.data() + i * PAGE_SIZE + RDH_SIZE,
+            PAYLOAD_SIZE) == 0);
+        position += PAYLOAD_SIZE;
+      }
+    }
+  };
+  checkOutput(output0, 0);
+  checkOutput(output5, 5);
+
+  // Link 0's output has room for another superpage, link 5's does not. Nothing may be copied then.
+  BOOST_CHECK_THROW(demultiplexer.copy(data.superpage, data.buffer.data()), OutOfRangeException);
+  BOOST_CHECK_EQUAL(demultiplexer.getOutputSize(0), 2 * PAYLOAD_SIZE);
+  BOOST_CHECK_EQUAL(demultiplexer.getOutputSize(5), 4 * PAYLOAD_SIZE);
+
+  demultiplexer.clearOutputs();
+  demultiplexer.copy(data.superpage, data.buffer.data());
+  BOOST_CHECK_EQUAL(demultiplexer.getOutputSize(5), 4 * PAYLOAD_SIZE);
+  checkOutput(output5, 5);
+}
+
+BOOST_AUTO_TEST_CASE(Crorc)
+{
+  std::vector<char> buffer(2 * PAGE_SIZE);
+  uint32_t eventSize = SDH_SIZE + 100;
+  std::memcpy(buffer.data() + 28, &eventSize, sizeof(uint32_t));
+  std::memcpy(buffer.data() + PAGE_SIZE + 28, &eventSize, sizeof(uint32_t));
+  Superpage superpage(0, 2 * PAGE_SIZE);
+  superpage.setReceived(2 * PAGE_SIZE);
+
+  LinkDemultiplexer demultiplexer(CardType::Crorc, PAGE_SIZE);
+  demultiplexer.index(superpage, buffer.data());
+  BOOST_CHECK((demultiplexer.getActiveLinks() == std::vector<uint32_t>{0}));
+  BOOST_CHECK_EQUAL(demultiplexer.getPackets(0).size(), 2);
+}
+
+} // Anonymous namespace
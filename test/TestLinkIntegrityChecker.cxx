@@ -0,0 +1,158 @@
+/// \file TestLinkIntegrityChecker.cxx
+/// \brief Test of the LinkIntegrityChecker class
+
+#define BOOST_TEST_MODULE RORC_TestLinkIntegrityChecker
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <cstring>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "ReadoutCard/Exception.h"
+#include "ReadoutCard/LinkIntegrityChecker.h"
+#include "RdhTestUtils.h"
+
+using namespace ::AliceO2::roc;
+using RdhTestUtils::writeRdh;
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 1024;
+constexpr size_t PAYLOAD_SIZE = 256;
+
+struct PacketSpec
+{
+    uint32_t linkId;
+    uint32_t packetCounter;
+    /// Data counter at the start of the payload
+    uint32_t dataCounter;
+};
+
+/// Writes packets one per DMA page, with payloads in the DDG pattern
+Superpage writePackets(std::vector<char>& buffer, const std::vector<PacketSpec>& packets)
+{
+  buffer.assign(packets.size() * PAGE_SIZE, 0);
+  for (size_t i = 0; i < packets.size(); ++i) {
+    auto page = buffer.data() + i * PAGE_SIZE;
+    writeRdh(page, RDH_SIZE + PAYLOAD_SIZE, PAGE_SIZE, packets[i].linkId);
+    setRdhField(page, RDH_LAYOUT_V4.packetCounter, packets[i].packetCounter);
+    auto counter = packets[i].dataCounter;
+    for (size_t j = 0; j < PAYLOAD_SIZE; j += 16, ++counter) {
+      uint32_t words[4] = {counter, counter, counter & 0xffff, 0};
+      std::memcpy(page + RDH_SIZE + j, words, sizeof(words));
+    }
+  }
+  Superpage superpage(0, buffer.size());
+  superpage.setReceived(buffer.size());
+  return superpage;
+}
+
+/// Each payload holds 16 values of the data counter
+constexpr uint32_t STEP = PAYLOAD_SIZE / 16;
+
+BOOST_AUTO_TEST_CASE(ContinuousData)
+{
+  LinkIntegrityChecker checker(CardType::Cru, true);
+  std::vector<char> buffer;
+  // The packet counter wraps around after 255
+  auto superpage = writePackets(buffer, {{3, 254, 0}, {3, 255, STEP}, {3, 0, 2 * STEP}});
+  BOOST_CHECK(!checker.check(superpage, buffer.data()));
+  superpage = writePackets(buffer, {{3, 1, 3 * STEP}, {3, 2, 4 * STEP}});
+  BOOST_CHECK(!checker.check(superpage, buffer.data()));
+
+  auto counters = checker.getCounters(3);
+  BOOST_CHECK_EQUAL(counters.packets, 5);
+  BOOST_CHECK_EQUAL(counters.getErrors(), 0);
+  BOOST_CHECK_EQUAL(checker.getCounters().packets, 5);
+  BOOST_CHECK_EQUAL(checker.getCounters(4).packets, 0);
+}
+
+BOOST_AUTO_TEST_CASE(GapsAndDuplicates)
+{
+  LinkIntegrityChecker checker(CardType::Cru, true);
+  std::vector<char> buffer;
+  // Three packets lost, then a duplicate. The data counter is resynchronized after both, so their payloads are fine.
+  auto superpage = writePackets(buffer, {{1, 10, 0}, {1, 14, 4 * STEP}, {1, 14, 4 * STEP}, {1, 15, 5 * STEP}});
+  BOOST_CHECK(checker.check(superpage, buffer.data()));
+
+  auto counters = checker.getCounters(1);
+  BOOST_CHECK_EQUAL(counters.packets, 4);
+  BOOST_CHECK_EQUAL(counters.gaps, 1);
+  BOOST_CHECK_EQUAL(counters.missingPackets, 3);
+  BOOST_CHECK_EQUAL(counters.duplicates, 1);
+  BOOST_CHECK_EQUAL(counters.payloadErrors, 0);
+  BOOST_CHECK_EQUAL(counters.getErrors(), 2);
+
+  // After resynchronizing, the next packet is taken as it comes
+  checker.resynchronize();
+  superpage = writePackets(buffer, {{1, 100, 1000}});
+  BOOST_CHECK(!checker.check(superpage, buffer.data()));
+}
+
+BOOST_AUTO_TEST_CASE(PayloadAndHeaderErrors)
+{
+  LinkIntegrityChecker checker(CardType::Dummy, true);
+  std::vector<char> buffer;
+  auto superpage = writePackets(buffer, {{0, 0, 0}, {0, 1, STEP}, {0, 2, 2 * STEP}, {2, 3, 0}});
+
+  // Corrupt a word of the second payload, and shrink the third payload to a partial data word
+  buffer[PAGE_SIZE + RDH_SIZE + 100] ^= 1;
+  setRdhField(buffer.data() + 2 * PAGE_SIZE, RDH_LAYOUT_V4.memorySize, RDH_SIZE + PAYLOAD_SIZE - 4);
+  BOOST_CHECK(checker.check(superpage, buffer.data()));
+
+  auto counters = checker.getCounters(0);
+  BOOST_CHECK_EQUAL(counters.payloadErrors, 1);
+  BOOST_CHECK_EQUAL(counters.sizeMismatches, 1);
+  BOOST_CHECK_EQUAL(counters.gaps, 0);
+  // The packet of link 2 is in a superpage of link 0
+  BOOST_CHECK_EQUAL(checker.getCounters(2).rdhAnomalies, 1);
+
+  // Without payload checking, only the headers matter
+  LinkIntegrityChecker headerChecker(CardType::Cru);
+  superpage = writePackets(buffer, {{0, 0, 0}, {0, 1, 0}});
+  BOOST_CHECK(!headerChecker.check(superpage, buffer.data()));
+}
+
+BOOST_AUTO_TEST_CASE(ExpectedCounters)
+{
+  LinkIntegrityChecker checker(CardType::Cru, true);
+  BOOST_CHECK(!checker.getLastPacketCounter(3));
+  BOOST_CHECK(!checker.getExpectedDataCounter(3));
+
+  std::vector<char> buffer;
+  auto superpage = writePackets(buffer, {{3, 10, 0}, {3, 11, STEP}});
+  BOOST_CHECK(!checker.check(superpage, buffer.data()));
+  BOOST_CHECK_EQUAL(checker.getLastPacketCounter(3).value_or(0), 11);
+  BOOST_CHECK_EQUAL(checker.getExpectedDataCounter(3).value_or(0), 2 * STEP);
+
+  // After a payload error, the data counter is taken from the next payload
+  superpage = writePackets(buffer, {{3, 12, 2 * STEP}});
+  buffer[RDH_SIZE] ^= 1;
+  BOOST_CHECK(checker.check(superpage, buffer.data()));
+  BOOST_CHECK_EQUAL(checker.getLastPacketCounter(3).value_or(0), 12);
+  BOOST_CHECK(!checker.getExpectedDataCounter(3));
+
+  checker.resynchronize();
+  BOOST_CHECK(!checker.getLastPacketCounter(3));
+  BOOST_CHECK_THROW(checker.getLastPacketCounter(LinkIntegrityChecker::LINK_IDS), OutOfRangeException);
+
+  // Without payload checking, there's no data counter
+  LinkIntegrityChecker headerChecker(CardType::Cru);
+  BOOST_CHECK(!headerChecker.check(writePackets(buffer, {{0, 0, 0}}), buffer.data()));
+  BOOST_CHECK(!headerChecker.getExpectedDataCounter(0));
+}
+
+BOOST_AUTO_TEST_CASE(MalformedSuperpage)
+{
+  LinkIntegrityChecker checker(CardType::Cru);
+  std::vector<char> buffer;
+  auto superpage = writePackets(buffer, {{0, 0, 0}, {0, 1, 0}});
+  setRdhField(buffer.data() + PAGE_SIZE, RDH_LAYOUT_V4.memorySize, 2 * PAGE_SIZE);
+  BOOST_CHECK(checker.check(superpage, buffer.data()));
+  BOOST_CHECK_EQUAL(checker.getMalformedSuperpages(), 1);
+  BOOST_CHECK_EQUAL(checker.getCounters(0).packets, 1);
+
+  BOOST_CHECK_THROW(checker.getCounters(256), OutOfRangeException);
+  BOOST_CHECK_THROW(LinkIntegrityChecker(CardType::Crorc), ParameterException);
+}
+
+} // Anonymous namespace
@@ -0,0 +1,31 @@
+/// \file TestNuma.cxx
+/// \brief Test of the NUMA utility functions
+
+#include "Utilities/Numa.h"
+
+#define BOOST_TEST_MODULE RORC_TestNuma
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ReadoutCard/Exception.h"
+
+using namespace ::AliceO2::roc;
+
+namespace {
+
+BOOST_AUTO_TEST_CASE(CpuList)
+{
+  BOOST_CHECK(Utilities::parseCpuList("").empty());
+  BOOST_CHECK(Utilities::parseCpuList("5") == std::vector<int>({5}));
+  BOOST_CHECK(Utilities::parseCpuList("0-3,8,10-11") == std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+}
+
+BOOST_AUTO_TEST_CASE(CpuListMalformed)
+{
+  BOOST_CHECK_THROW(Utilities::parseCpuList("0-"), ParseException);
+  BOOST_CHECK_THROW(Utilities::parseCpuList("3-1"), ParseException);
+  BOOST_CHECK_THROW(Utilities::parseCpuList("0-1-2"), ParseException);
+  BOOST_CHECK_THROW(Utilities::parseCpuList("a,b"), ParseException);
+}
+
+} // Anonymous namespace
@@ -0,0 +1,125 @@
+/// \file TestPacketCompactor.cxx
+/// \brief Test of the PacketCompactor class
+
+#define BOOST_TEST_MODULE RORC_TestPacketCompactor
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <cstring>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "ReadoutCard/Exception.h"
+#include "ReadoutCard/PacketCompactor.h"
+#include "ReadoutCard/PacketRange.h"
+#include "RdhTestUtils.h"
+
+using namespace ::AliceO2::roc;
+using RdhTestUtils::writeRdh;
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 8 * 1024;
+constexpr size_t PAGES = 7;
+
+struct PacketSpec
+{
+    uint32_t linkId;
+    uint32_t orbit;
+    size_t payloadSize;
+};
+
+/// Packets of two links, most of them empty
+const std::vector<PacketSpec> PACKETS {
+  {0, 1, 0},
+  {0, 1, 0},   // Same link and orbit as the previous empty packet
+  {1, 1, 100},
+  {0, 1, 200},
+  {1, 1, 0},   // Link 1 already had a packet in orbit 1
+  {0, 2, 0},
+  {0, 2, 0},
+};
+
+/// Writes the packets one per DMA page, with the payloads filled with their index
+Superpage writePackets(std::vector<char>& buffer)
+{
+  buffer.assign(PAGES * PAGE_SIZE, 0);
+  for (size_t i = 0; i < PACKETS.size(); ++i) {
+    auto page = buffer.data() + i * PAGE_SIZE;
+    writeRdh(page, RDH_SIZE + PACKETS[i].payloadSize, PAGE_SIZE, PACKETS[i].linkId);
+    setRdhField(page, RDH_LAYOUT_V4.heartbeatOrbit, PACKETS[i].orbit);
+    std::memset(page + RDH_SIZE, int(i), PACKETS[i].payloadSize);
+  }
+  Superpage superpage(0, PAGES * PAGE_SIZE);
+  superpage.setReceived(PAGES * PAGE_SIZE);
+  return superpage;
+}
+
+/// Walks compacted data and checks it holds the packets with the given indexes
+void checkPackets(const Superpage& superpage, const char* buffer, const std::vector<size_t>& expected)
+{
+  std::vector<Packet> packets;
+  for (const auto& packet : PacketRange(superpage, buffer, CardType::Cru, PAGE_SIZE)) {
+    packets.push_back(packet);
+  }
+  BOOST_REQUIRE_EQUAL(packets.size(), expected.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    const auto& spec = PACKETS[expected[i]];
+    BOOST_CHECK_EQUAL((packets[i].header - buffer) % 32, 0);
+    BOOST_CHECK_EQUAL(packets[i].getRdh().getLinkId(), spec.linkId);
+    BOOST_CHECK_EQUAL(packets[i].getRdh().getHeartbeatOrbit(), spec.orbit);
+    BOOST_REQUIRE_EQUAL(packets[i].payloadSize, spec.payloadSize);
+    for (size_t j = 0; j < spec.payloadSize; ++j) {
+      BOOST_REQUIRE_EQUAL(int(packets[i].payload[j]), int(expected[i]));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CompactInPlace)
+{
+  std::vector<char> buffer;
+  auto superpage = writePackets(buffer);
+  PacketCompactor compactor(CardType::Cru);
+  auto statistics = compactor.compact(superpage, buffer.data());
+
+  BOOST_CHECK_EQUAL(statistics.packets, 7);
+  BOOST_CHECK_EQUAL(statistics.removedPackets, 3);
+  BOOST_CHECK_EQUAL(statistics.bytesIn, PAGES * PAGE_SIZE);
+  // Packet sizes 64 + 192 (164 rounded up) + 288 (264 rounded up) + 64
+  BOOST_CHECK_EQUAL(statistics.bytesOut, 608);
+  BOOST_CHECK_EQUAL(superpage.getReceived(), 608);
+  BOOST_CHECK_LT(statistics.getRatio(), 0.02);
+  checkPackets(superpage, buffer.data(), {0, 2, 3, 5});
+
+  // Orbit 2 of link 0 already has its empty packet
+  auto next = writePackets(buffer);
+  next.setReceived(PAGE_SIZE);
+  setRdhField(buffer.data(), RDH_LAYOUT_V4.heartbeatOrbit, 2);
+  statistics = compactor.compact(next, buffer.data());
+  BOOST_CHECK_EQUAL(statistics.removedPackets, 1);
+  BOOST_CHECK_EQUAL(next.getReceived(), 0);
+  BOOST_CHECK_EQUAL(compactor.getStatistics().packets, 8);
+  BOOST_CHECK_EQUAL(compactor.getStatistics().removedPackets, 4);
+}
+
+BOOST_AUTO_TEST_CASE(CompactCopy)
+{
+  std::vector<char> buffer;
+  auto superpage = writePackets(buffer);
+  auto original = buffer;
+
+  // Without heartbeats, only the packets with payload remain
+  PacketCompactor compactor(CardType::Cru, false);
+  std::vector<char> destination(PAGE_SIZE);
+  auto statistics = compactor.compactCopy(superpage, buffer.data(), destination.data(), destination.size());
+  BOOST_CHECK_EQUAL(statistics.removedPackets, 5);
+  BOOST_CHECK_EQUAL(statistics.bytesOut, 480);
+  BOOST_CHECK(buffer == original);
+
+  Superpage compacted(0, destination.size());
+  compacted.setReceived(statistics.bytesOut);
+  checkPackets(compacted, destination.data(), {2, 3});
+
+  BOOST_CHECK_THROW(compactor.compactCopy(superpage, buffer.data(), destination.data(), 300), OutOfRangeException);
+  BOOST_CHECK_THROW(PacketCompactor(CardType::Crorc), ParameterException);
+}
+
+} // Anonymous namespace
@@ -0,0 +1,135 @@
+/// \file TestPacketIndex.cxx
+/// \brief Test of the PacketIndex and PacketIndexPool classes
+
+#define BOOST_TEST_MODULE RORC_TestPacketIndex
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "ReadoutCard/ChannelFactory.h"
+#include "ReadoutCard/Exception.h"
+#include "ReadoutCard/PacketIndex.h"
+#include "RdhTestUtils.h"
+
+using namespace ::AliceO2::roc;
+using RdhTestUtils::writeRdh;
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 8 * 1024;
+constexpr size_t SUPERPAGE_SIZE = 4 * PAGE_SIZE;
+
+BOOST_AUTO_TEST_CASE(BuildIndex)
+{
+  // Second superpage of the buffer, with packets of different sizes
+  std::vector<char> buffer(2 * SUPERPAGE_SIZE);
+  auto superpageData = buffer.data() + SUPERPAGE_SIZE;
+  writeRdh(superpageData, 1000, 1024, 3);
+  writeRdh(superpageData + 1024, PAGE_SIZE, PAGE_SIZE, 7);
+  writeRdh(superpageData + 1024 + PAGE_SIZE, RDH_SIZE, PAGE_SIZE, 3);
+  Superpage superpage(SUPERPAGE_SIZE, SUPERPAGE_SIZE);
+  superpage.setReceived(1024 + 2 * PAGE_SIZE);
+
+  PacketIndex index;
+  index.build(superpage, buffer.data(), CardType::Cru, PAGE_SIZE);
+  BOOST_REQUIRE_EQUAL(index.size(), 3);
+  BOOST_CHECK_EQUAL(index[1].offset, 1024);
+  BOOST_CHECK_EQUAL(index[1].payloadSize, PAGE_SIZE - RDH_SIZE);
+  BOOST_CHECK_EQUAL(index[1].headerSize, RDH_SIZE);
+  BOOST_CHECK_EQUAL(index[1].linkId, 7);
+  BOOST_CHECK_EQUAL(index[2].payloadSize, 0);
+
+  // The index gives the same packets as walking the headers
+  size_t i = 0;
+  for (const auto& packet : PacketRange(superpage, buffer.data(), CardType::Cru, PAGE_SIZE)) {
+    auto indexed = index.getPacket(i, superpageData);
+    BOOST_CHECK(indexed.header == packet.header);
+    BOOST_CHECK(indexed.payload == packet.payload);
+    BOOST_CHECK_EQUAL(indexed.payloadSize, packet.payloadSize);
+    i++;
+  }
+
+  // Building again replaces the contents
+  superpage.setReceived(1024);
+  index.build(superpage, buffer.data(), CardType::Cru, PAGE_SIZE);
+  BOOST_CHECK_EQUAL(index.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(Pool)
+{
+  std::vector<char> buffer(2 * SUPERPAGE_SIZE);
+  for (size_t i = 0; i < 8; ++i) {
+    writeRdh(buffer.data() + i * PAGE_SIZE, PAGE_SIZE, PAGE_SIZE, i);
+  }
+  Superpage first(0, SUPERPAGE_SIZE);
+  first.setReceived(SUPERPAGE_SIZE);
+  Superpage second(SUPERPAGE_SIZE, SUPERPAGE_SIZE);
+  second.setReceived(SUPERPAGE_SIZE);
+
+  PacketIndexPool pool(CardType::Cru, PAGE_SIZE, 1);
+  const auto& index = pool.attach(first, buffer.data());
+  BOOST_CHECK(first.getPacketIndex() == &index);
+  BOOST_CHECK_EQUAL(index.size(), 4);
+  BOOST_CHECK_EQUAL(pool.getAvailable(), 0);
+
+  // Consumers get copies of the superpage, which share the index
+  Superpage copy = first;
+  BOOST_CHECK_EQUAL(copy.getPacketIndex()->size(), 4);
+
+  BOOST_CHECK_THROW(pool.attach(second, buffer.data()), OutOfRangeException);
+  BOOST_CHECK(second.getPacketIndex() == nullptr);
+
+  pool.release(first);
+  BOOST_CHECK(first.getPacketIndex() == nullptr);
+  BOOST_CHECK_EQUAL(pool.getAvailable(), 1);
+  BOOST_CHECK_THROW(pool.release(first), Exception);
+
+  // Invalid data does not use up the index
+  writeRdh(buffer.data() + SUPERPAGE_SIZE, PAGE_SIZE, 0, 0);
+  BOOST_CHECK_THROW(pool.attach(second, buffer.data()), DataFormatException);
+  BOOST_CHECK(second.getPacketIndex() == nullptr);
+  BOOST_CHECK_EQUAL(pool.getAvailable(), 1);
+
+  const auto& reused = pool.attach(first, buffer.data());
+  BOOST_CHECK_EQUAL(reused[3].linkId, 3);
+  BOOST_CHECK_THROW(pool.attach(first, buffer.data()), Exception);
+}
+
+/// Pushes a superpage into the channel and waits until it's filled
+Superpage transferSuperpage(DmaChannelInterface& channel, Superpage superpage)
+{
+  channel.pushSuperpage(superpage);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (channel.getReadyQueueSize() == 0 && std::chrono::steady_clock::now() < deadline) {
+    channel.fillSuperpages();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_REQUIRE(channel.getReadyQueueSize() != 0);
+  return channel.popSuperpage();
+}
+
+BOOST_AUTO_TEST_CASE(PushedAgain)
+{
+  std::vector<char> buffer(SUPERPAGE_SIZE);
+  auto parameters = Parameters::makeParameters(ChannelFactory::getDummySerialNumber(), 0)
+    .setBufferParameters(buffer_parameters::Memory{buffer.data(), buffer.size()})
+    .setDmaPageSize(PAGE_SIZE)
+    .setGeneratorEnabled(true)
+    .setLinkMask({0});
+  auto channel = ChannelFactory().getDmaChannel(parameters);
+  channel->startDma();
+
+  PacketIndexPool pool(CardType::Cru, PAGE_SIZE, 2);
+  auto superpage = transferSuperpage(*channel, Superpage(0, SUPERPAGE_SIZE));
+  pool.attach(superpage, buffer.data());
+
+  // The superpage comes back from the channel without the index of its previous fill
+  superpage = transferSuperpage(*channel, superpage);
+  BOOST_CHECK(superpage.getPacketIndex() == nullptr);
+  BOOST_CHECK_EQUAL(pool.attach(superpage, buffer.data()).size(), 4);
+  channel->stopDma();
+}
+
+} // Anonymous namespace
@@ -0,0 +1,127 @@
+/// \file TestPacketRange.cxx
+/// \brief Test of the PacketRange class
+
+#define BOOST_TEST_MODULE RORC_TestPacketRange
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <cstring>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "ReadoutCard/Exception.h"
+#include "ReadoutCard/PacketRange.h"
+#include "RdhTestUtils.h"
+
+using namespace ::AliceO2::roc;
+using RdhTestUtils::writeRdh;
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 8 * 1024;
+constexpr size_t SUPERPAGE_OFFSET = 2 * PAGE_SIZE;
+
+/// Writes a CRU-format packet, with the link ID as the first payload byte
+void writePacket(char* page, size_t memorySize, size_t offsetToNext, uint32_t linkId)
+{
+  writeRdh(page, memorySize, offsetToNext, linkId);
+  page[RDH_SIZE] = char(linkId);
+}
+
+Superpage makeSuperpage(size_t received)
+{
+  Superpage superpage(SUPERPAGE_OFFSET, 4 * PAGE_SIZE);
+  superpage.setReceived(received);
+  return superpage;
+}
+
+BOOST_AUTO_TEST_CASE(CruPackets)
+{
+  // Packets of different sizes, not all of them a full DMA page apart
+  std::vector<char> buffer(SUPERPAGE_OFFSET + 4 * PAGE_SIZE);
+  auto superpageData = buffer.data() + SUPERPAGE_OFFSET;
+  writePacket(superpageData, 1000, 1024, 3);
+  writePacket(superpageData + 1024, PAGE_SIZE, PAGE_SIZE, 7);
+  writePacket(superpageData + 1024 + PAGE_SIZE, RDH_SIZE + 32, PAGE_SIZE, 11);
+
+  std::vector<Packet> packets;
+  for (const auto& packet : PacketRange(makeSuperpage(1024 + 2 * PAGE_SIZE), buffer.data(), CardType::Cru, PAGE_SIZE)) {
+    packets.push_back(packet);
+  }
+
+  BOOST_REQUIRE_EQUAL(packets.size(), 3);
+  BOOST_CHECK(packets[0].header == superpageData);
+  BOOST_CHECK(packets[0].payload == superpageData + RDH_SIZE);
+  BOOST_CHECK_EQUAL(packets[0].payloadSize, 1000 - RDH_SIZE);
+  BOOST_CHECK_EQUAL(packets[1].payloadSize, PAGE_SIZE - RDH_SIZE);
+  BOOST_CHECK_EQUAL(packets[2].payloadSize, 32);
+  uint32_t linkIds[] = {3, 7, 11};
+  for (size_t i = 0; i < packets.size(); ++i) {
+    BOOST_CHECK_EQUAL(packets[i].getRdh().getLinkId(), linkIds[i]);
+    BOOST_CHECK_EQUAL(uint32_t(packets[i].payload[0]), linkIds[i]);
+  }
+
+  // Nothing received, nothing to walk
+  PacketRange empty(makeSuperpage(0), buffer.data(), CardType::Dummy, PAGE_SIZE);
+  BOOST_CHECK(empty.begin() == empty.end());
+}
+
+BOOST_AUTO_TEST_CASE(CruPacketsOutOfRange)
+{
+  std::vector<char> buffer(SUPERPAGE_OFFSET + 4 * PAGE_SIZE);
+  auto superpageData = buffer.data() + SUPERPAGE_OFFSET;
+  auto walk = [&](size_t received) {
+    size_t count = 0;
+    for (const auto& packet : PacketRange(makeSuperpage(received), buffer.data(), CardType::Cru, PAGE_SIZE)) {
+      (void) packet;
+      count++;
+    }
+    return count;
+  };
+
+  // The packet is larger than what was received
+  writePacket(superpageData, PAGE_SIZE, PAGE_SIZE, 0);
+  BOOST_CHECK_THROW(walk(PAGE_SIZE / 2), DataFormatException);
+
+  // The superpage ends inside the RDH of the second packet
+  BOOST_CHECK_THROW(walk(PAGE_SIZE + 16), DataFormatException);
+
+  // An offset to next packet of 0 would never end
+  writePacket(superpageData, 256, 0, 0);
+  BOOST_CHECK_THROW(walk(PAGE_SIZE), DataFormatException);
+
+  // A memory size that does not hold the RDH
+  writePacket(superpageData, 16, PAGE_SIZE, 0);
+  BOOST_CHECK_THROW(walk(PAGE_SIZE), DataFormatException);
+
+  writePacket(superpageData, 256, PAGE_SIZE, 0);
+  BOOST_CHECK_EQUAL(walk(PAGE_SIZE), 1);
+}
+
+BOOST_AUTO_TEST_CASE(CrorcPackets)
+{
+  std::vector<char> buffer(SUPERPAGE_OFFSET + 4 * PAGE_SIZE);
+  auto superpageData = buffer.data() + SUPERPAGE_OFFSET;
+  uint32_t eventSizes[] = {PAGE_SIZE, 100, SDH_SIZE};
+  for (size_t i = 0; i < 3; ++i) {
+    std::memcpy(superpageData + i * PAGE_SIZE + 28, &eventSizes[i], sizeof(uint32_t));
+  }
+
+  std::vector<Packet> packets;
+  for (const auto& packet : PacketRange(makeSuperpage(3 * PAGE_SIZE), buffer.data(), CardType::Crorc, PAGE_SIZE)) {
+    packets.push_back(packet);
+  }
+
+  BOOST_REQUIRE_EQUAL(packets.size(), 3);
+  for (size_t i = 0; i < 3; ++i) {
+    BOOST_CHECK(packets[i].header == superpageData + i * PAGE_SIZE);
+    BOOST_CHECK(packets[i].payload == superpageData + i * PAGE_SIZE + SDH_SIZE);
+    BOOST_CHECK_EQUAL(packets[i].payloadSize, eventSizes[i] - SDH_SIZE);
+  }
+
+  // An event larger than the DMA page
+  uint32_t tooLarge = PAGE_SIZE + 4;
+  std::memcpy(superpageData + 28, &tooLarge, sizeof(uint32_t));
+  BOOST_CHECK_THROW(PacketRange(makeSuperpage(3 * PAGE_SIZE), buffer.data(), CardType::Crorc, PAGE_SIZE).begin(),
+      DataFormatException);
+}
+
+} // Anonymous namespace
@@ -96,3 +96,14 @@ BOOST_AUTO_TEST_CASE(ParametersCardIdFromString)
   BOOST_CHECK_THROW(Parameters::cardIdFromString("42:0:0"), ParseException);
   BOOST_CHECK_THROW(Parameters::cardIdFromString("3248758792345"), ParseException);
 }
+
+BOOST_AUTO_TEST_CASE(ParametersGeneratorFaultMapFromString)
+{
+  auto faults = Parameters::generatorFaultMapFromString("DROP_PAGE:0.5,stall_link:1e-3");
+  BOOST_REQUIRE(faults.size() == 2);
+  BOOST_CHECK(faults.at(GeneratorFault::DropPage) == 0.5);
+  BOOST_CHECK(faults.at(GeneratorFault::StallLink) == 1e-3);
+  BOOST_CHECK_THROW(Parameters::generatorFaultMapFromString("DROP_PAGE"), ParseException);
+  BOOST_CHECK_THROW(Parameters::generatorFaultMapFromString("DROP_PAGE:x"), ParseException);
+  BOOST_CHECK_THROW(Parameters::generatorFaultMapFromString("BURN_CARD:0.1"), ParseException);
+}
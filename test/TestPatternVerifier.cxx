@@ -0,0 +1,78 @@
+/// \file TestPatternVerifier.cxx
+/// \brief Test of the data generator pattern checking functions
+
+#define BOOST_TEST_MODULE RORC_TestPatternVerifier
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "PatternVerifier.h"
+
+using namespace ::AliceO2::roc;
+using namespace ::AliceO2::roc::PatternVerifier;
+
+namespace {
+
+constexpr size_t WORDS = 2048 + 5; // Not a whole number of blocks, to test the tail
+
+/// Fills data with the pattern, starting one word in so the blocks are not aligned in memory
+std::vector<uint32_t> makeData(const LinearPattern& pattern, size_t words = WORDS)
+{
+  std::vector<uint32_t> data(words + 1);
+  for (size_t i = 0; i < words; ++i) {
+    data[i + 1] = pattern.getExpected(i);
+  }
+  return data;
+}
+
+/// Finds all mismatches in the data
+std::vector<size_t> findAll(const uint32_t* data, const LinearPattern& pattern)
+{
+  std::vector<size_t> mismatches;
+  for (auto i = findMismatch(data, 0, WORDS, pattern); i < WORDS; i = findMismatch(data, i + 1, WORDS, pattern)) {
+    mismatches.push_back(i);
+  }
+  return mismatches;
+}
+
+BOOST_AUTO_TEST_CASE(Patterns)
+{
+  auto ddg = makeDdgPattern(0xfffe);
+  std::vector<uint32_t> expected {0xfffe, 0xfffe, 0xfffe, 0, 0xffff, 0xffff, 0xffff, 0, 0x10000, 0x10000, 0, 0};
+  for (size_t i = 0; i < expected.size(); ++i) {
+    BOOST_CHECK_EQUAL(ddg.getExpected(i), expected[i]);
+  }
+
+  auto internal = makeCruInternalPattern(0xffffffff);
+  BOOST_CHECK_EQUAL(internal.getExpected(7), 0xffffffff);
+  BOOST_CHECK_EQUAL(internal.getExpected(8), 0);
+
+  auto counter = makeWordCounterPattern(uint32_t(-1));
+  BOOST_CHECK_EQUAL(counter.getExpected(0), 0xffffffff);
+  BOOST_CHECK_EQUAL(counter.getExpected(100), 99);
+
+  BOOST_CHECK_EQUAL(makeConstantPattern(0xa5a5a5a5).getExpected(12345), 0xa5a5a5a5);
+}
+
+BOOST_AUTO_TEST_CASE(FindMismatches)
+{
+  for (const auto& pattern : {makeDdgPattern(0xfff0), makeCruInternalPattern(1), makeWordCounterPattern(7),
+      makeConstantPattern(0x12345678)}) {
+    auto data = makeData(pattern);
+    BOOST_CHECK(findAll(data.data() + 1, pattern).empty());
+
+    // Errors in the head, middle and tail, including two in the same block
+    std::vector<size_t> errors {0, 3, 1000, 1001, 1007, WORDS - 1};
+    for (auto i : errors) {
+      data[i + 1] ^= 0x100;
+    }
+    auto mismatches = findAll(data.data() + 1, pattern);
+    BOOST_CHECK_EQUAL_COLLECTIONS(mismatches.begin(), mismatches.end(), errors.begin(), errors.end());
+
+    // A range that starts and ends inside blocks
+    BOOST_CHECK_EQUAL(findMismatch(data.data() + 1, 4, 1000, pattern), 1000);
+    BOOST_CHECK_EQUAL(findMismatch(data.data() + 1, 1008, WORDS - 1, pattern), WORDS - 1);
+  }
+}
+
+} // Anonymous namespace
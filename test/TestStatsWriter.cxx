@@ -0,0 +1,63 @@
+/// \file TestStatsWriter.cxx
+/// \brief Test of the StatsWriter class of roc-bench-dma
+
+#include "CommandLineUtilities/StatsWriter.h"
+
+#define BOOST_TEST_MODULE RORC_TestStatsWriter
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <sstream>
+#include <boost/test/unit_test.hpp>
+
+using namespace ::AliceO2::roc;
+using namespace ::AliceO2::roc::CommandLineUtilities;
+
+namespace {
+
+StatsSample makeSample()
+{
+  StatsSample sample;
+  sample.type = "sample";
+  sample.time = 1.5;
+  sample.pushed = 10;
+  sample.read = 8;
+  sample.gbps = 12.5;
+  sample.errors = 3;
+  sample.readoutQueue = 2;
+  sample.freeQueue = 5;
+  sample.pushToReadyP99 = 40.25;
+  return sample;
+}
+
+BOOST_AUTO_TEST_CASE(Json)
+{
+  std::ostringstream stream;
+  StatsWriter writer(stream, StatsWriter::parseFormat("json"));
+  writer.write(makeSample());
+  BOOST_CHECK_EQUAL(stream.str(), "{\"type\":\"sample\",\"time\":1.5,\"pushed\":10,\"read\":8,\"gbps\":12.5,\"errors\":3,"
+      "\"temperature\":null,\"dropped_packets\":null,\"readout_queue\":2,\"free_queue\":5,"
+      "\"push_to_ready_p99_us\":40.25}\n");
+}
+
+BOOST_AUTO_TEST_CASE(Csv)
+{
+  std::ostringstream stream;
+  StatsWriter writer(stream, StatsWriter::parseFormat("csv"));
+  auto sample = makeSample();
+  sample.droppedPackets = 7;
+  writer.write(sample);
+  sample.type = "summary";
+  sample.errors = boost::none;
+  writer.write(sample);
+  BOOST_CHECK_EQUAL(stream.str(),
+      "type,time,pushed,read,gbps,errors,temperature,dropped_packets,readout_queue,free_queue,push_to_ready_p99_us\n"
+      "sample,1.5,10,8,12.5,3,,7,2,5,40.25\n"
+      "summary,1.5,10,8,12.5,,,7,2,5,40.25\n");
+}
+
+BOOST_AUTO_TEST_CASE(UnknownFormat)
+{
+  BOOST_CHECK_THROW(StatsWriter::parseFormat("xml"), ParameterException);
+}
+
+} // Anonymous namespace
@@ -0,0 +1,99 @@
+/// \file TestSuperpageWriter.cxx
+/// \brief Test of the SuperpageWriter class of roc-bench-dma
+
+#include "CommandLineUtilities/SuperpageWriter.h"
+
+#define BOOST_TEST_MODULE RORC_TestSuperpageWriter
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <boost/test/unit_test.hpp>
+
+using namespace ::AliceO2::roc::CommandLineUtilities;
+
+namespace {
+
+const std::string PATH = "/tmp/TestSuperpageWriter.bin";
+constexpr size_t SUPERPAGE_SIZE = 4 * SuperpageWriter::ALIGNMENT;
+constexpr size_t SUPERPAGES = 32;
+
+/// Stands in for the DMA buffer, which is hugepage aligned
+alignas(SuperpageWriter::ALIGNMENT) char buffer[SUPERPAGE_SIZE * SUPERPAGES];
+
+std::string readFile(const std::string& path)
+{
+  std::ifstream stream(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+/// Writes every superpage of an aligned buffer and checks they end up in the file in order
+void checkWrite(size_t capacity, size_t threads)
+{
+  std::remove(PATH.c_str());
+  for (size_t i = 0; i < SUPERPAGE_SIZE * SUPERPAGES; ++i) {
+    buffer[i] = char(i / SUPERPAGE_SIZE + i);
+  }
+
+  std::set<size_t> done;
+  {
+    SuperpageWriter writer(PATH, capacity, threads);
+    for (size_t i = 0; i < SUPERPAGES; ++i) {
+      writer.write(buffer + i * SUPERPAGE_SIZE, SUPERPAGE_SIZE, i * SUPERPAGE_SIZE);
+      BOOST_CHECK_LE(writer.getDepth(), capacity);
+    }
+    writer.close();
+
+    size_t tag;
+    while (writer.popDone(tag)) {
+      done.insert(tag);
+    }
+    BOOST_CHECK_EQUAL(writer.getBytesWritten(), SUPERPAGE_SIZE * SUPERPAGES);
+    BOOST_CHECK_LE(writer.getMaxDepth(), capacity);
+    BOOST_CHECK_EQUAL(writer.getDepth(), 0);
+  }
+
+  // Every superpage is handed back once
+  BOOST_CHECK_EQUAL(done.size(), SUPERPAGES);
+  BOOST_CHECK(readFile(PATH) == std::string(buffer, SUPERPAGE_SIZE * SUPERPAGES));
+  std::remove(PATH.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(SingleThread)
+{
+  checkWrite(4, 1);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadPool)
+{
+  checkWrite(8, 4);
+}
+
+BOOST_AUTO_TEST_CASE(Backpressure)
+{
+  // With room for one superpage, every write waits for the previous one
+  checkWrite(1, 2);
+}
+
+BOOST_AUTO_TEST_CASE(Unaligned)
+{
+  std::remove(PATH.c_str());
+  std::string data = "unaligned";
+  {
+    SuperpageWriter writer(PATH, 2, 1, false);
+    BOOST_CHECK(!writer.isDirect());
+    writer.write(data.data(), data.size(), 0);
+    writer.write(data.data(), data.size(), 1);
+  }
+  BOOST_CHECK_EQUAL(readFile(PATH), data + data);
+  std::remove(PATH.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(OpenFailure)
+{
+  BOOST_CHECK_THROW(SuperpageWriter("/nonexistent/TestSuperpageWriter.bin", 1, 1), ::AliceO2::roc::Exception);
+}
+
+} // Anonymous namespace
@@ -0,0 +1,151 @@
+/// \file TestTimeFrameBuilder.cxx
+/// \brief Test of the TimeFrameBuilder class
+
+#define BOOST_TEST_MODULE RORC_TestTimeFrameBuilder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <utility>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "ReadoutCard/Exception.h"
+#include "ReadoutCard/TimeFrameBuilder.h"
+#include "RdhTestUtils.h"
+
+using namespace ::AliceO2::roc;
+using RdhTestUtils::writeRdh;
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 1024;
+constexpr size_t SUPERPAGE_SIZE = 4 * PAGE_SIZE;
+constexpr uint32_t ORBITS_PER_TIME_FRAME = 10;
+
+/// DMA buffer with room for a few superpages of CRU-format packets
+class Buffer
+{
+  public:
+    Buffer() : mData(8 * SUPERPAGE_SIZE)
+    {
+    }
+
+    /// Writes a superpage with one packet per DMA page, given as (link ID, heartbeat orbit)
+    Superpage write(size_t index, const std::vector<std::pair<uint32_t, uint32_t>>& packets)
+    {
+      Superpage superpage(index * SUPERPAGE_SIZE, SUPERPAGE_SIZE);
+      for (size_t i = 0; i < packets.size(); ++i) {
+        auto page = mData.data() + superpage.getOffset() + i * PAGE_SIZE;
+        writeRdh(page, PAGE_SIZE, PAGE_SIZE, packets[i].first);
+        setRdhField(page, RDH_LAYOUT_V4.heartbeatOrbit, packets[i].second);
+      }
+      superpage.setReceived(packets.size() * PAGE_SIZE);
+      return superpage;
+    }
+
+    const char* data() const
+    {
+      return mData.data();
+    }
+
+  private:
+    std::vector<char> mData;
+};
+
+BOOST_AUTO_TEST_CASE(CompleteTimeFrames)
+{
+  Buffer buffer;
+  TimeFrameBuilder builder(CardType::Cru, {0, 1}, ORBITS_PER_TIME_FRAME);
+
+  builder.addSuperpage(buffer.write(0, {{0, 0}, {1, 3}, {0, 5}}), buffer.data());
+  builder.addSuperpage(buffer.write(1, {{0, 12}, {1, 8}}), buffer.data());
+  // Link 1 has not passed time frame 0 yet
+  BOOST_CHECK(!builder.isTimeFrameAvailable());
+  BOOST_CHECK_EQUAL(builder.getOpenTimeFrameCount(), 2);
+
+  builder.addSuperpage(buffer.write(2, {{1, 15}}), buffer.data());
+  BOOST_REQUIRE(builder.isTimeFrameAvailable());
+  {
+    const auto& timeFrame = builder.getTimeFrame();
+    BOOST_CHECK_EQUAL(timeFrame.id, 0);
+    BOOST_CHECK(timeFrame.complete);
+    BOOST_REQUIRE_EQUAL(timeFrame.links.size(), 2);
+    BOOST_REQUIRE_EQUAL(timeFrame.links.at(0).size(), 2);
+    BOOST_REQUIRE_EQUAL(timeFrame.links.at(1).size(), 2);
+    // Packets point into the superpages, in order of arrival
+    BOOST_CHECK(timeFrame.links.at(0)[1].header == buffer.data() + 2 * PAGE_SIZE);
+    BOOST_CHECK(timeFrame.links.at(1)[1].header == buffer.data() + SUPERPAGE_SIZE + PAGE_SIZE);
+  }
+  BOOST_CHECK(!builder.isSuperpageAvailable());
+  BOOST_CHECK_EQUAL(builder.getReferencedSuperpageCount(), 3);
+
+  // Superpage 1 also has packets of the open time frame 1
+  builder.popTimeFrame();
+  BOOST_REQUIRE(builder.isSuperpageAvailable());
+  BOOST_CHECK_EQUAL(builder.popSuperpage().getOffset(), 0);
+  BOOST_CHECK(!builder.isSuperpageAvailable());
+
+  // A late packet for time frame 0 is dropped
+  builder.addSuperpage(buffer.write(3, {{0, 3}, {0, 25}, {1, 21}}), buffer.data());
+  BOOST_CHECK_EQUAL(builder.getDroppedPacketCount(), 1);
+  BOOST_REQUIRE(builder.isTimeFrameAvailable());
+  BOOST_CHECK_EQUAL(builder.getTimeFrame().id, 1);
+  builder.popTimeFrame();
+  BOOST_CHECK_EQUAL(builder.popSuperpage().getOffset(), 1 * SUPERPAGE_SIZE);
+  BOOST_CHECK_EQUAL(builder.popSuperpage().getOffset(), 2 * SUPERPAGE_SIZE);
+  BOOST_CHECK(!builder.isSuperpageAvailable());
+
+  // At the end of the run, the open time frame is handed out as incomplete
+  builder.flush();
+  BOOST_REQUIRE(builder.isTimeFrameAvailable());
+  BOOST_CHECK_EQUAL(builder.getTimeFrame().id, 2);
+  BOOST_CHECK(!builder.getTimeFrame().complete);
+  builder.popTimeFrame();
+  BOOST_CHECK_EQUAL(builder.popSuperpage().getOffset(), 3 * SUPERPAGE_SIZE);
+  BOOST_CHECK_EQUAL(builder.getReferencedSuperpageCount(), 0);
+  BOOST_CHECK_THROW(builder.popTimeFrame(), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(MaxOpenTimeFrames)
+{
+  Buffer buffer;
+  // Link 1 never sends anything, so time frames can only be completed by the limit
+  TimeFrameBuilder builder(CardType::Cru, {0, 1}, ORBITS_PER_TIME_FRAME, 2);
+  builder.addSuperpage(buffer.write(0, {{0, 0}, {0, 10}}), buffer.data());
+  BOOST_CHECK(!builder.isTimeFrameAvailable());
+  builder.addSuperpage(buffer.write(1, {{0, 20}}), buffer.data());
+  BOOST_REQUIRE(builder.isTimeFrameAvailable());
+  BOOST_CHECK_EQUAL(builder.getTimeFrame().id, 0);
+  BOOST_CHECK(!builder.getTimeFrame().complete);
+  BOOST_CHECK_EQUAL(builder.getOpenTimeFrameCount(), 2);
+
+  // Superpages without packets for a time frame are released right away
+  builder.addSuperpage(buffer.write(2, {}), buffer.data());
+  builder.addSuperpage(buffer.write(3, {{0, 5}}), buffer.data());
+  BOOST_CHECK_EQUAL(builder.getDroppedPacketCount(), 1);
+  BOOST_CHECK_EQUAL(builder.popSuperpage().getOffset(), 2 * SUPERPAGE_SIZE);
+  BOOST_CHECK_EQUAL(builder.popSuperpage().getOffset(), 3 * SUPERPAGE_SIZE);
+}
+
+BOOST_AUTO_TEST_CASE(MaxOpenTimeFramesOlderPacket)
+{
+  Buffer buffer;
+  TimeFrameBuilder builder(CardType::Cru, {0, 1}, ORBITS_PER_TIME_FRAME, 2);
+  builder.addSuperpage(buffer.write(0, {{0, 20}, {0, 30}}), buffer.data());
+  BOOST_CHECK_EQUAL(builder.getOpenTimeFrameCount(), 2);
+
+  // A packet older than all open time frames is dropped without pushing out the newer ones
+  builder.addSuperpage(buffer.write(1, {{0, 15}}), buffer.data());
+  BOOST_CHECK_EQUAL(builder.getDroppedPacketCount(), 1);
+  BOOST_CHECK(!builder.isTimeFrameAvailable());
+  BOOST_CHECK_EQUAL(builder.getOpenTimeFrameCount(), 2);
+  BOOST_CHECK_EQUAL(builder.popSuperpage().getOffset(), SUPERPAGE_SIZE);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidParameters)
+{
+  BOOST_CHECK_THROW(TimeFrameBuilder(CardType::Crorc, {0}, ORBITS_PER_TIME_FRAME), ParameterException);
+  BOOST_CHECK_THROW(TimeFrameBuilder(CardType::Cru, {}, ORBITS_PER_TIME_FRAME), ParameterException);
+  BOOST_CHECK_THROW(TimeFrameBuilder(CardType::Cru, {0}, 0), ParameterException);
+  BOOST_CHECK_THROW(TimeFrameBuilder(CardType::Cru, {0}, ORBITS_PER_TIME_FRAME, 0), ParameterException);
+}
+
+} // Anonymous namespace